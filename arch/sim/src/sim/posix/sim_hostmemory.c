@@ -24,6 +24,7 @@
 
 #include <errno.h>
 #include <fcntl.h>
+#include <signal.h>
 #include <unistd.h>
 #include <string.h>
 #include <stdlib.h>
@@ -44,6 +45,37 @@
  * Private Data
  ****************************************************************************/
 
+static bool g_fault_attached;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: host_fault_handler
+ *
+ * Description:
+ *   Pass an access to a protected page to the simulation.  The faulting
+ *   instruction is restarted on return, so an unhandled fault restores
+ *   the default action and crashes as it would have without the handler.
+ *
+ *   The handler runs with SA_NODEFER and an empty sa_mask, so the signal
+ *   mask is still the one of the faulting context.  The timer signal is
+ *   masked there if the interrupts were disabled.
+ *
+ ****************************************************************************/
+
+static void host_fault_handler(int signo, siginfo_t *info, void *context)
+{
+  sigset_t mask;
+
+  pthread_sigmask(SIG_SETMASK, NULL, &mask);
+  if (sim_fault(info->si_addr, sigismember(&mask, SIGALRM)) < 0)
+    {
+      signal(signo, SIG_DFL);
+    }
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -184,3 +216,44 @@ void *host_realloc(void *oldmem, size_t size)
   mem = host_uninterruptible(realloc, oldmem, size);
   return mem;
 }
+
+/****************************************************************************
+ * Name: host_mprotect
+ *
+ * Description:
+ *   Set the access permissions of host pages.  The PROT_* values of NuttX
+ *   and of the host are the same.  The fault handler is attached on first
+ *   use and may block in the simulation, so it runs with SA_NODEFER to
+ *   leave SIGSEGV unblocked in the other tasks.
+ *
+ ****************************************************************************/
+
+int host_mprotect(void *addr, size_t len, int prot)
+{
+  struct sigaction act;
+
+  if (!g_fault_attached)
+    {
+      memset(&act, 0, sizeof(act));
+      act.sa_sigaction = host_fault_handler;
+      act.sa_flags     = SA_SIGINFO | SA_NODEFER;
+      sigemptyset(&act.sa_mask);
+
+      /* Linux raises SIGSEGV on protection faults, macOS raises SIGBUS */
+
+      if (sigaction(SIGSEGV, &act, NULL) < 0 ||
+          sigaction(SIGBUS, &act, NULL) < 0)
+        {
+          return -errno;
+        }
+
+      g_fault_attached = true;
+    }
+
+  if (host_uninterruptible(mprotect, addr, len, prot) < 0)
+    {
+      return -errno;
+    }
+
+  return 0;
+}
@@ -233,6 +233,11 @@ void *host_memalign(size_t alignment, size_t size);
 void host_free(void *mem);
 void *host_realloc(void *oldmem, size_t size);
 int host_unlinkshmem(const char *name);
+int host_mprotect(void *addr, size_t len, int prot);
+
+/* sim_mprotect.c ***********************************************************/
+
+int sim_fault(void *addr, bool irqoff);
 
 /* sim_hosttime.c ***********************************************************/
 
@@ -0,0 +1,73 @@
+/****************************************************************************
+ * arch/sim/src/sim/sim_mprotect.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <errno.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/irq.h>
+#include <nuttx/mm/map.h>
+
+#include "sim_internal.h"
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: up_mprotect
+ *
+ * Description:
+ *   Set the access permissions of a page aligned region of memory.
+ *
+ ****************************************************************************/
+
+int up_mprotect(void *addr, size_t len, int prot)
+{
+  return host_mprotect(addr, len, prot);
+}
+
+/****************************************************************************
+ * Name: sim_fault
+ *
+ * Description:
+ *   Called by the host fault handler on an access to a protected page.
+ *   The fault is resolved in the context of the faulting task, which may
+ *   block, so faults in interrupt handlers or with the interrupts disabled,
+ *   as in a critical section, are never resolved.
+ *
+ ****************************************************************************/
+
+int sim_fault(void *addr, bool irqoff)
+{
+  if (irqoff || up_interrupt_context())
+    {
+      return -EFAULT;
+    }
+
+  return mm_map_fault(addr);
+}
@@ -40,10 +40,31 @@
 
 #define MAX_OPENCNT       (255)                  /* Limit of uint8_t */
 
+#ifndef CONFIG_BCH_CACHE_NWAYS
+#  define CONFIG_BCH_CACHE_NWAYS  1
+#endif
+
+#ifndef CONFIG_BCH_CACHE_WINDOW
+#  define CONFIG_BCH_CACHE_WINDOW 1
+#endif
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
 
+/* One window of the sector cache.  The window holds the sectors
+ * [base, base + CONFIG_BCH_CACHE_WINDOW) and tracks which of them have been
+ * read from the media and which have been modified since.
+ */
+
+struct bchlib_window_s
+{
+  size_t base;             /* First sector of the window */
+  uint32_t valid;          /* Bit n set: sector base + n is in the cache */
+  uint32_t dirty;          /* Bit n set: sector base + n must be written */
+  uint32_t stamp;          /* Time of the last access, for the LRU */
+};
+
 struct bchlib_s
 {
   FAR struct inode *inode; /* I-node of the block driver */
@@ -52,10 +73,13 @@ struct bchlib_s
   size_t sector;           /* The current sector in the buffer */
   mutex_t lock;            /* For atomic accesses to this structure */
   uint8_t refs;            /* Number of references */
-  bool dirty;              /* true: Data has been written to the buffer */
   bool readonly;           /* true: Only read operations are supported */
   bool unlinked;           /* true: The driver has been unlinked */
-  FAR uint8_t *buffer;     /* One sector buffer */
+  FAR uint8_t *buffer;     /* The current sector in the cache */
+  FAR uint8_t *cache;      /* Storage of all the cache windows */
+  FAR struct bchlib_window_s *window;  /* The window of the current sector */
+  uint32_t stamp;          /* Access counter for the LRU */
+  struct bchlib_window_s windows[CONFIG_BCH_CACHE_NWAYS];
 
 #if defined(CONFIG_BCH_ENCRYPTION)
   uint8_t key[CONFIG_BCH_ENCRYPTION_KEY_SIZE];  /* Encryption key */
@@ -82,7 +106,10 @@ EXTERN const struct file_operations g_bch_fops;
  ****************************************************************************/
 
 EXTERN int  bchlib_flushsector(FAR struct bchlib_s *bch, bool discard);
+EXTERN int  bchlib_flushrange(FAR struct bchlib_s *bch, size_t sector,
+                              size_t nsectors, bool discard);
 EXTERN int  bchlib_readsector(FAR struct bchlib_s *bch, size_t sector);
+EXTERN void bchlib_dirtysector(FAR struct bchlib_s *bch);
 
 #undef EXTERN
 #if defined(__cplusplus)
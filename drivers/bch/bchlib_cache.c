@@ -26,7 +26,9 @@
 #include <nuttx/kmalloc.h>
 
 #include <sys/types.h>
+#include <stdint.h>
 #include <stdbool.h>
+#include <strings.h>
 #include <errno.h>
 #include <assert.h>
 #include <debug.h>
@@ -37,6 +39,14 @@
 #  include <nuttx/crypto/crypto.h>
 #endif
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* A mask of the n lowest bits of a window bitmap */
+
+#define BCH_RUN(n) ((n) >= 32 ? UINT32_MAX : ((uint32_t)1 << (n)) - 1)
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -57,32 +67,43 @@ static void bch_xor(uint32_t *R, uint32_t *A, uint32_t *B)
 
 /****************************************************************************
  * Name: bch_cypher
+ *
+ * Description:
+ *   Encrypt or decrypt in place nsectors consecutive sectors starting at
+ *   'sector'.  Each sector is tweaked with its own sector number.
+ *
  ****************************************************************************/
 
 #if defined(CONFIG_BCH_ENCRYPTION)
-static int bch_cypher(FAR struct bchlib_s *bch, int encrypt)
+static int bch_cypher(FAR struct bchlib_s *bch, FAR uint8_t *sectbuf,
+                      size_t sector, size_t nsectors, int encrypt)
 {
   int blocks = bch->sectsize / 16;
-  FAR uint32_t *buffer = (FAR uint32_t *)bch->buffer;
+  FAR uint32_t *buffer = (FAR uint32_t *)sectbuf;
   int i;
 
-  for (i = 0; i < blocks; i++, buffer += 16 / sizeof(uint32_t) )
+  for (; nsectors > 0; nsectors--, sector++)
     {
-      uint32_t T[4];
-      uint32_t X[4] =
-      {
-        bch->sector, 0, 0, i
-      };
-
-      aes_cypher(X, X, 16, NULL, bch->key, CONFIG_BCH_ENCRYPTION_KEY_SIZE,
-                 AES_MODE_ECB, CYPHER_ENCRYPT);
-
-      /* Xor-Encrypt-Xor */
-
-      bch_xor(T, X, buffer);
-      aes_cypher(T, T, 16, NULL, bch->key, CONFIG_BCH_ENCRYPTION_KEY_SIZE,
-                 AES_MODE_ECB, encrypt);
-      bch_xor(buffer, X, T);
+      for (i = 0; i < blocks; i++, buffer += 16 / sizeof(uint32_t))
+        {
+          uint32_t T[4];
+          uint32_t X[4] =
+          {
+            sector, 0, 0, i
+          };
+
+          aes_cypher(X, X, 16, NULL, bch->key,
+                     CONFIG_BCH_ENCRYPTION_KEY_SIZE,
+                     AES_MODE_ECB, CYPHER_ENCRYPT);
+
+          /* Xor-Encrypt-Xor */
+
+          bch_xor(T, X, buffer);
+          aes_cypher(T, T, 16, NULL, bch->key,
+                     CONFIG_BCH_ENCRYPTION_KEY_SIZE,
+                     AES_MODE_ECB, encrypt);
+          bch_xor(buffer, X, T);
+        }
     }
 
   return OK;
@@ -90,74 +111,173 @@ static int bch_cypher(FAR struct bchlib_s *bch, int encrypt)
 #endif
 
 /****************************************************************************
- * Public Functions
+ * Name: bch_winbuffer
+ *
+ * Description:
+ *   Return the cache storage of the sector 'index' of a window.
+ *
  ****************************************************************************/
 
+static FAR uint8_t *bch_winbuffer(FAR struct bchlib_s *bch,
+                                  FAR struct bchlib_window_s *window,
+                                  unsigned int index)
+{
+  size_t nth = (window - bch->windows) * CONFIG_BCH_CACHE_WINDOW + index;
+
+  return bch->cache + nth * bch->sectsize;
+}
+
 /****************************************************************************
- * Name: bchlib_flushsector
+ * Name: bch_winflush
  *
  * Description:
- *   Flush the current contents of the sector buffer (if dirty)
- *
- * Assumptions:
- *   Caller must assume mutual exclusion
+ *   Write back the dirty sectors of a window, one write request per
+ *   contiguous run of dirty sectors.
  *
  ****************************************************************************/
 
-int bchlib_flushsector(FAR struct bchlib_s *bch, bool discard)
+static int bch_winflush(FAR struct bchlib_s *bch,
+                        FAR struct bchlib_window_s *window)
 {
-  FAR struct inode *inode;
-  ssize_t ret = OK;
+  FAR struct inode *inode = bch->inode;
+  FAR uint8_t *buffer;
+  unsigned int first;
+  unsigned int count;
+  uint32_t run;
+  ssize_t ret;
+
+  while (window->dirty != 0)
+    {
+      /* Find the next run of dirty sectors */
 
-  /* Check if the sector has been modified and is out of synch with the
-   * media.
-   */
+      first = ffs(window->dirty) - 1;
+      run   = window->dirty >> first;
+      count = run == UINT32_MAX ? 32 : ffs(~run) - 1;
 
-  if (bch->dirty && bch->buffer != NULL)
-    {
-      inode = bch->inode;
+      buffer = bch_winbuffer(bch, window, first);
 
 #if defined(CONFIG_BCH_ENCRYPTION)
       /* Encrypt data as necessary */
 
-      bch_cypher(bch, CYPHER_ENCRYPT);
+      bch_cypher(bch, buffer, window->base + first, count, CYPHER_ENCRYPT);
 #endif
 
-      /* Write the sector to the media */
+      /* Write the sectors to the media */
+
+      ret = inode->u.i_bops->write(inode, buffer, window->base + first,
+                                   count);
+
+#if defined(CONFIG_BCH_ENCRYPTION)
+      /* Computation overhead to save memory for extra sector buffer */
+
+      bch_cypher(bch, buffer, window->base + first, count, CYPHER_DECRYPT);
+#endif
 
-      ret = inode->u.i_bops->write(inode, bch->buffer, bch->sector, 1);
       if (ret < 0)
         {
           ferr("Write failed: %zd\n", ret);
           return (int)ret;
         }
 
-#if defined(CONFIG_BCH_ENCRYPTION)
-      /* Computation overhead to save memory for extra sector buffer
-       * TODO: Add configuration switch for extra sector buffer
-       */
+      /* The sectors are now in sync with the media */
 
-      bch_cypher(bch, CYPHER_DECRYPT);
-#endif
+      window->dirty &= ~(BCH_RUN(count) << first);
+    }
 
-      /* The sector is now in sync with the media */
+  return OK;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
 
-      bch->dirty = false;
+/****************************************************************************
+ * Name: bchlib_flushrange
+ *
+ * Description:
+ *   Flush the cache windows holding any of the sectors
+ *   [sector, sector + nsectors).  If discard is true, the cached copies of
+ *   these sectors are dropped as well.
+ *
+ * Assumptions:
+ *   Caller must assume mutual exclusion
+ *
+ ****************************************************************************/
+
+int bchlib_flushrange(FAR struct bchlib_s *bch, size_t sector,
+                      size_t nsectors, bool discard)
+{
+  FAR struct bchlib_window_s *window;
+  size_t first;
+  size_t last;
+  int ret;
+  int i;
+
+  if (bch->cache == NULL)
+    {
+      return OK;
     }
 
-  if (discard)
+  for (i = 0; i < CONFIG_BCH_CACHE_NWAYS; i++)
+    {
+      window = &bch->windows[i];
+      if (window->base == (size_t)-1 ||
+          window->base >= sector + nsectors ||
+          window->base + CONFIG_BCH_CACHE_WINDOW <= sector)
+        {
+          continue;
+        }
+
+      ret = bch_winflush(bch, window);
+      if (ret < 0)
+        {
+          return ret;
+        }
+
+      if (discard)
+        {
+          first = sector > window->base ? sector - window->base : 0;
+          last  = sector + nsectors - window->base;
+          if (last > CONFIG_BCH_CACHE_WINDOW)
+            {
+              last = CONFIG_BCH_CACHE_WINDOW;
+            }
+
+          window->valid &= ~(BCH_RUN(last - first) << first);
+        }
+    }
+
+  if (discard && bch->sector >= sector && bch->sector < sector + nsectors)
     {
       bch->sector = (size_t)-1;
     }
 
-  return (int)ret;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: bchlib_flushsector
+ *
+ * Description:
+ *   Flush all the dirty sectors of the cache
+ *
+ * Assumptions:
+ *   Caller must assume mutual exclusion
+ *
+ ****************************************************************************/
+
+int bchlib_flushsector(FAR struct bchlib_s *bch, bool discard)
+{
+  return bchlib_flushrange(bch, 0, bch->nsectors, discard);
 }
 
 /****************************************************************************
  * Name: bchlib_readsector
  *
  * Description:
- *   Read the current sector contents into buffer
+ *   Bring the sector into the cache and make it the current sector.  When
+ *   the sector follows the previous one, the rest of its window is read
+ *   ahead with the same request.
  *
  * Assumptions:
  *   Caller must assume mutual exclusion
@@ -166,46 +286,130 @@ int bchlib_flushsector(FAR struct bchlib_s *bch, bool discard)
 
 int bchlib_readsector(FAR struct bchlib_s *bch, size_t sector)
 {
+  FAR struct bchlib_window_s *window = NULL;
+  FAR struct bchlib_window_s *victim = NULL;
   FAR struct inode *inode;
-  ssize_t ret = OK;
+  FAR uint8_t *buffer;
+  unsigned int index;
+  size_t count;
+  size_t base;
+  uint32_t rest;
+  ssize_t ret;
+  int i;
 
-  if (bch->buffer == NULL)
+  if (bch->cache == NULL)
     {
+      size_t size = (size_t)CONFIG_BCH_CACHE_NWAYS *
+                    CONFIG_BCH_CACHE_WINDOW * bch->sectsize;
+
 #if CONFIG_BCH_BUFFER_ALIGNMENT != 0
-      bch->buffer = kmm_memalign(CONFIG_BCH_BUFFER_ALIGNMENT, bch->sectsize);
+      bch->cache = kmm_memalign(CONFIG_BCH_BUFFER_ALIGNMENT, size);
 #else
-      bch->buffer = kmm_malloc(bch->sectsize);
+      bch->cache = kmm_malloc(size);
 #endif
-      if (bch->buffer == NULL)
+      if (bch->cache == NULL)
         {
           ferr("Failed to allocate sector buffer\n");
           return -ENOMEM;
         }
     }
 
-  if (bch->sector != sector)
+  base  = sector - sector % CONFIG_BCH_CACHE_WINDOW;
+  index = sector - base;
+
+  /* Look for the window of the sector, or else the least recently used */
+
+  for (i = 0; i < CONFIG_BCH_CACHE_NWAYS; i++)
     {
-      inode = bch->inode;
+      if (bch->windows[i].base == base)
+        {
+          window = &bch->windows[i];
+          break;
+        }
 
-      ret = bchlib_flushsector(bch, true);
+      if (victim == NULL || bch->windows[i].base == (size_t)-1 ||
+          (victim->base != (size_t)-1 &&
+           bch->stamp - bch->windows[i].stamp > bch->stamp - victim->stamp))
+        {
+          victim = &bch->windows[i];
+        }
+    }
+
+  if (window == NULL)
+    {
+      ret = bch_winflush(bch, victim);
       if (ret < 0)
         {
           ferr("Flush failed: %zd\n", ret);
           return (int)ret;
         }
 
-      ret = inode->u.i_bops->read(inode, bch->buffer, sector, 1);
+      window        = victim;
+      window->base  = base;
+      window->valid = 0;
+    }
+
+  window->stamp = ++bch->stamp;
+  buffer = bch_winbuffer(bch, window, index);
+
+  if ((window->valid & ((uint32_t)1 << index)) == 0)
+    {
+      inode = bch->inode;
+
+      /* Read ahead up to the end of the window, the end of the media or the
+       * next sector already in the cache on sequential accesses.
+       */
+
+      count = 1;
+      if (sector == bch->sector + 1)
+        {
+          count = CONFIG_BCH_CACHE_WINDOW - index;
+          if (count > bch->nsectors - sector)
+            {
+              count = bch->nsectors - sector;
+            }
+
+          rest = window->valid >> index;
+          if (rest != 0 && count > ffs(rest) - 1)
+            {
+              count = ffs(rest) - 1;
+            }
+        }
+
+      ret = inode->u.i_bops->read(inode, buffer, sector, count);
       if (ret < 0)
         {
           ferr("Read failed: %zd\n", ret);
           return (int)ret;
         }
 
-      bch->sector = sector;
 #if defined(CONFIG_BCH_ENCRYPTION)
-      bch_cypher(bch, CYPHER_DECRYPT);
+      bch_cypher(bch, buffer, sector, count, CYPHER_DECRYPT);
 #endif
+
+      window->valid |= BCH_RUN(count) << index;
     }
 
-  return (int)ret;
+  bch->sector = sector;
+  bch->window = window;
+  bch->buffer = buffer;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: bchlib_dirtysector
+ *
+ * Description:
+ *   Mark the current sector as modified
+ *
+ * Assumptions:
+ *   Caller must assume mutual exclusion
+ *
+ ****************************************************************************/
+
+void bchlib_dirtysector(FAR struct bchlib_s *bch)
+{
+  FAR struct bchlib_window_s *window = bch->window;
+
+  window->dirty |= (uint32_t)1 << (bch->sector - window->base);
 }
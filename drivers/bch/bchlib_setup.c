@@ -58,6 +58,7 @@ int bchlib_setup(FAR const char *blkdev, bool readonly, FAR void **handle)
   FAR struct bchlib_s *bch;
   struct geometry geo;
   int ret;
+  int i;
 
   DEBUGASSERT(blkdev);
 
@@ -110,6 +111,12 @@ int bchlib_setup(FAR const char *blkdev, bool readonly, FAR void **handle)
   bch->sectsize = geo.geo_sectorsize;
   bch->sector   = (size_t)-1;
   bch->readonly = readonly;
+
+  for (i = 0; i < CONFIG_BCH_CACHE_NWAYS; i++)
+    {
+      bch->windows[i].base = (size_t)-1;
+    }
+
   *handle = bch;
   return OK;
 
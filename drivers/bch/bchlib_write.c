@@ -103,7 +103,7 @@ ssize_t bchlib_write(FAR void *handle, FAR const char *buffer, off_t offset,
         }
 
       memcpy(&bch->buffer[sectoffset], buffer, nbytes);
-      bch->dirty = true;
+      bchlib_dirtysector(bch);
 
       /* Adjust pointers and counts */
 
@@ -131,10 +131,16 @@ ssize_t bchlib_write(FAR void *handle, FAR const char *buffer, off_t offset,
           nsectors = bch->nsectors - sector;
         }
 
-      /* Flush the dirty sector to keep the sector sequence */
+      /* Flush the dirty sectors to keep the sector sequence and drop the
+       * cached copies of the sectors about to be overwritten.
+       */
+
+      ret = bchlib_flushsector(bch, false);
+      if (ret >= 0)
+        {
+          ret = bchlib_flushrange(bch, sector, nsectors, true);
+        }
 
-      ret = bchlib_flushsector(bch, sector <= bch->sector &&
-                               bch->sector < (sector + nsectors));
       if (ret < 0)
         {
           ferr("ERROR: Flush failed: %d\n", ret);
@@ -181,7 +187,7 @@ ssize_t bchlib_write(FAR void *handle, FAR const char *buffer, off_t offset,
       /* Copy the head end of the sector from the user buffer */
 
       memcpy(bch->buffer, buffer, len);
-      bch->dirty = true;
+      bchlib_dirtysector(bch);
 
       /* Adjust counts */
 
@@ -290,7 +290,8 @@ static int netdev_upper_txpoll(FAR struct net_driver_s *dev)
 
   pkt = netpkt_get(dev, NETPKT_TX);
 
-  if (netpkt_getdatalen(lower, pkt) > NETDEV_PKTSIZE(dev))
+  if (netpkt_getdatalen(lower, pkt) > NETDEV_PKTSIZE(dev) &&
+      netpkt_gsosize(pkt) == 0)
     {
       nerr("ERROR: Packet too long to send!\n");
       ret = -EMSGSIZE;
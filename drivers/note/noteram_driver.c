@@ -24,6 +24,7 @@
 
 #include <nuttx/config.h>
 
+#include <sys/param.h>
 #include <sys/types.h>
 #include <sched.h>
 #include <fcntl.h>
@@ -68,20 +69,58 @@
 #define get_task_state(s)                                                    \
   ((s) == 0 ? 'X' : ((s) <= LAST_READY_TO_RUN_STATE ? 'R' : 'S'))
 
+/* The per-CPU buffers are the largest power of two that fits in their
+ * share of the buffer, so that their free running positions wrap around
+ * consistently.
+ */
+
+#ifdef CONFIG_DRIVERS_NOTERAM_PERCPU
+#  define NOTERAM_FILL1(n)      ((n) | ((n) >> 1))
+#  define NOTERAM_FILL2(n)      (NOTERAM_FILL1(n) | (NOTERAM_FILL1(n) >> 2))
+#  define NOTERAM_FILL4(n)      (NOTERAM_FILL2(n) | (NOTERAM_FILL2(n) >> 4))
+#  define NOTERAM_FILL8(n)      (NOTERAM_FILL4(n) | (NOTERAM_FILL4(n) >> 8))
+#  define NOTERAM_FILL16(n)     (NOTERAM_FILL8(n) | (NOTERAM_FILL8(n) >> 16))
+#  define NOTERAM_CPUSIZE(s)    (NOTERAM_FILL16((s) / NCPUS) - \
+                                 (NOTERAM_FILL16((s) / NCPUS) >> 1))
+#else
+#  define NOTERAM_CPUSIZE(s)    (s)
+#endif
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
 
+#ifdef CONFIG_DRIVERS_NOTERAM_PERCPU
+/* The circular buffer of one CPU.  Only that CPU adds notes, with its
+ * interrupts disabled, and the positions are free running.  The reader
+ * detects the notes overwritten while it copies them by checking the tail
+ * afterwards.
+ */
+
+struct noteram_cpu_s
+{
+  volatile unsigned int head;   /* Position of the next note to add */
+  volatile unsigned int tail;   /* Position of the oldest note */
+  unsigned int read;            /* Position of the next note to read */
+  unsigned int base;            /* The notes before it were cleared */
+};
+#endif
+
 struct noteram_driver_s
 {
   struct note_driver_s driver;
   FAR uint8_t *ni_buffer;
-  size_t ni_bufsize;
+  size_t ni_bufsize;            /* Size of the buffer of each CPU */
   unsigned int ni_overwrite;
+  unsigned int ni_read_mode;
+#ifdef CONFIG_DRIVERS_NOTERAM_PERCPU
+  struct noteram_cpu_s ni_cpu[NCPUS];
+#else
   volatile unsigned int ni_head;
   volatile unsigned int ni_tail;
   volatile unsigned int ni_read;
-  spinlock_t lock;
+#endif
+  spinlock_t lock;              /* Serializes the readers (and writers) */
 };
 
 /* The structure to hold the context data of trace dump */
@@ -147,7 +186,7 @@ struct noteram_driver_s g_noteram_driver =
 {
   {&g_noteram_ops},
   g_ramnote_buffer,
-  CONFIG_DRIVERS_NOTERAM_BUFSIZE,
+  NOTERAM_CPUSIZE(CONFIG_DRIVERS_NOTERAM_BUFSIZE),
 #ifdef CONFIG_DRIVERS_NOTERAM_DEFAULT_NOOVERWRITE
   NOTERAM_MODE_OVERWRITE_DISABLE
 #else
@@ -159,6 +198,202 @@ struct noteram_driver_s g_noteram_driver =
  * Private Functions
  ****************************************************************************/
 
+#ifdef CONFIG_DRIVERS_NOTERAM_PERCPU
+
+/****************************************************************************
+ * Name: noteram_buffer_clear
+ *
+ * Description:
+ *   Clear all contents of the per-CPU buffers.  The tails belong to the
+ *   writers, so the notes are only hidden from the readers.
+ *
+ * Assumptions:
+ *   drv->lock is held.
+ *
+ ****************************************************************************/
+
+static void noteram_buffer_clear(FAR struct noteram_driver_s *drv)
+{
+  int cpu;
+
+  for (cpu = 0; cpu < NCPUS; cpu++)
+    {
+      FAR struct noteram_cpu_s *c = &drv->ni_cpu[cpu];
+
+      c->base = c->head;
+      c->read = c->base;
+    }
+
+  if (drv->ni_overwrite == NOTERAM_MODE_OVERWRITE_OVERFLOW)
+    {
+      drv->ni_overwrite = NOTERAM_MODE_OVERWRITE_DISABLE;
+    }
+}
+
+/****************************************************************************
+ * Name: noteram_rewind
+ *
+ * Description:
+ *   Reset the read positions to the oldest notes that were not cleared.
+ *
+ ****************************************************************************/
+
+static void noteram_rewind(FAR struct noteram_driver_s *drv)
+{
+  int cpu;
+
+  for (cpu = 0; cpu < NCPUS; cpu++)
+    {
+      FAR struct noteram_cpu_s *c = &drv->ni_cpu[cpu];
+      unsigned int tail = c->tail;
+
+      c->read = (int)(c->base - tail) > 0 ? c->base : tail;
+    }
+}
+
+/****************************************************************************
+ * Name: noteram_cpu_copy
+ *
+ * Description:
+ *   Copy data from the buffer of a CPU, handling wraparound.
+ *
+ ****************************************************************************/
+
+static void noteram_cpu_copy(FAR struct noteram_driver_s *drv, int cpu,
+                             unsigned int pos, FAR void *dest, size_t len)
+{
+  FAR const uint8_t *buffer = drv->ni_buffer + cpu * drv->ni_bufsize;
+  unsigned int index = pos & (drv->ni_bufsize - 1);
+  size_t space = drv->ni_bufsize - index;
+
+  space = space < len ? space : len;
+  memcpy(dest, buffer + index, space);
+  memcpy((FAR uint8_t *)dest + space, buffer, len - space);
+}
+
+/****************************************************************************
+ * Name: noteram_cpu_peek
+ *
+ * Description:
+ *   Get the common header of the next note to read from the buffer of a
+ *   CPU, skipping the notes that were overwritten.
+ *
+ * Returned Value:
+ *   True if there is a note to read.
+ *
+ ****************************************************************************/
+
+static bool noteram_cpu_peek(FAR struct noteram_driver_s *drv, int cpu,
+                             FAR struct note_common_s *note)
+{
+  FAR struct noteram_cpu_s *c = &drv->ni_cpu[cpu];
+  unsigned int head;
+  unsigned int tail;
+
+  for (; ; )
+    {
+      /* Order the reads of the positions before the reads of the note */
+
+      tail = c->tail;
+      head = c->head;
+      SP_DMB();
+
+      if ((int)(tail - c->read) > 0)
+        {
+          c->read = tail;
+        }
+
+      if (c->read == head)
+        {
+          return false;
+        }
+
+      noteram_cpu_copy(drv, cpu, c->read, note, sizeof(*note));
+      SP_DMB();
+
+      /* The note is valid if the writer did not move the tail over it */
+
+      if ((int)(c->tail - c->read) <= 0)
+        {
+          return true;
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: noteram_get
+ *
+ * Description:
+ *   Get the oldest note from the read positions of the per-CPU buffers.
+ *
+ * Input Parameters:
+ *   buffer - Location to return the next note
+ *   buflen - The length of the user provided buffer.
+ *
+ * Returned Value:
+ *   On success, the positive, non-zero length of the return note is
+ *   provided.  Zero is returned only if the buffers are empty.  -EFBIG is
+ *   returned, and the note left in place, if it does not fit in the user
+ *   buffer.
+ *
+ ****************************************************************************/
+
+static ssize_t noteram_get(FAR struct noteram_driver_s *drv,
+                           FAR uint8_t *buffer, size_t buflen)
+{
+  struct note_common_s oldest;
+  struct note_common_s note;
+  FAR struct noteram_cpu_s *c;
+  unsigned int read;
+  int found;
+  int cpu;
+
+  DEBUGASSERT(buffer != NULL);
+
+  for (; ; )
+    {
+      /* Find the CPU with the oldest next note */
+
+      found = -1;
+      for (cpu = 0; cpu < NCPUS; cpu++)
+        {
+          if (noteram_cpu_peek(drv, cpu, &note) &&
+              (found < 0 || note.nc_systime_sec < oldest.nc_systime_sec ||
+               (note.nc_systime_sec == oldest.nc_systime_sec &&
+                note.nc_systime_nsec < oldest.nc_systime_nsec)))
+            {
+              found  = cpu;
+              oldest = note;
+            }
+        }
+
+      if (found < 0)
+        {
+          return 0;
+        }
+
+      if (buflen < oldest.nc_length)
+        {
+          return -EFBIG;
+        }
+
+      /* Copy the note, and start over if it was overwritten meanwhile */
+
+      c    = &drv->ni_cpu[found];
+      read = c->read;
+      noteram_cpu_copy(drv, found, read, buffer, oldest.nc_length);
+      SP_DMB();
+
+      if ((int)(c->tail - read) <= 0)
+        {
+          c->read = read + NOTE_ALIGN(oldest.nc_length);
+          return oldest.nc_length;
+        }
+    }
+}
+
+#else /* CONFIG_DRIVERS_NOTERAM_PERCPU */
+
 /****************************************************************************
  * Name: noteram_buffer_clear
  *
@@ -266,6 +501,19 @@ static unsigned int noteram_unread_length(FAR struct noteram_driver_s *drv)
   return head - read;
 }
 
+/****************************************************************************
+ * Name: noteram_rewind
+ *
+ * Description:
+ *   Reset the read index to the oldest note.
+ *
+ ****************************************************************************/
+
+static void noteram_rewind(FAR struct noteram_driver_s *drv)
+{
+  drv->ni_read = drv->ni_tail;
+}
+
 /****************************************************************************
  * Name: noteram_remove
  *
@@ -324,8 +572,9 @@ static void noteram_remove(FAR struct noteram_driver_s *drv)
  *
  * Returned Value:
  *   On success, the positive, non-zero length of the return note is
- *   provided.  Zero is returned only if the circular buffer is empty.  A
- *   negated errno value is returned in the event of any failure.
+ *   provided.  Zero is returned only if the circular buffer is empty.
+ *   -EFBIG is returned, and the note left in place, if it does not fit in
+ *   the user buffer.
  *
  ****************************************************************************/
 
@@ -363,12 +612,6 @@ static ssize_t noteram_get(FAR struct noteram_driver_s *drv,
 
   if (buflen < notelen)
     {
-      /* Skip the large note so that we do not get constipated. */
-
-      drv->ni_read = noteram_next(drv, read, NOTE_ALIGN(notelen));
-
-      /* and return an error */
-
       return -EFBIG;
     }
 
@@ -392,6 +635,8 @@ static ssize_t noteram_get(FAR struct noteram_driver_s *drv,
   return notelen;
 }
 
+#endif /* CONFIG_DRIVERS_NOTERAM_PERCPU */
+
 /****************************************************************************
  * Name: noteram_open
  ****************************************************************************/
@@ -404,7 +649,7 @@ static int noteram_open(FAR struct file *filep)
 
   /* Reset the read index of the circular buffer */
 
-  drv->ni_read = drv->ni_tail;
+  noteram_rewind(drv);
   ctx = kmm_zalloc(sizeof(*ctx));
   if (ctx == NULL)
     {
@@ -423,6 +668,44 @@ int noteram_close(FAR struct file *filep)
   return OK;
 }
 
+/****************************************************************************
+ * Name: noteram_read_binary
+ *
+ * Description:
+ *   Copy as many whole notes as fit into the user buffer, without
+ *   formatting them.  The notes are taken one at a time into a local buffer
+ *   under the lock, so that the interrupts are only disabled for one note
+ *   and the user buffer is never written with the lock held.
+ *
+ ****************************************************************************/
+
+static ssize_t noteram_read_binary(FAR struct noteram_driver_s *drv,
+                                   FAR uint8_t *buffer, size_t buflen)
+{
+  irqstate_t flags;
+  ssize_t nread = 0;
+  ssize_t ret;
+
+  do
+    {
+      uint8_t note[256];
+
+      flags = spin_lock_irqsave_wo_note(&drv->lock);
+      ret = noteram_get(drv, note, MIN(sizeof(note), buflen - nread));
+      spin_unlock_irqrestore_wo_note(&drv->lock, flags);
+      if (ret > 0)
+        {
+          memcpy(buffer + nread, note, ret);
+          nread += ret;
+        }
+    }
+  while (ret > 0);
+
+  /* Fail only if the user buffer cannot hold even the first note */
+
+  return nread > 0 ? nread : ret;
+}
+
 /****************************************************************************
  * Name: noteram_read
  ****************************************************************************/
@@ -435,6 +718,11 @@ static ssize_t noteram_read(FAR struct file *filep, FAR char *buffer,
   FAR struct lib_memoutstream_s stream;
   ssize_t ret;
 
+  if (drv->ni_read_mode == NOTERAM_MODE_READ_BINARY)
+    {
+      return noteram_read_binary(drv, (FAR uint8_t *)buffer, buflen);
+    }
+
   lib_memoutstream(&stream, buffer, buflen);
 
   do
@@ -520,6 +808,42 @@ static int noteram_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
           }
         break;
 
+      /* NOTERAM_GETREADMODE
+       *      - Get read mode
+       *        Argument: A writable pointer to unsigned int
+       */
+
+      case NOTERAM_GETREADMODE:
+        if (arg == 0)
+          {
+            ret = -EINVAL;
+          }
+        else
+          {
+            *(FAR unsigned int *)arg = drv->ni_read_mode;
+            ret = OK;
+          }
+        break;
+
+      /* NOTERAM_SETREADMODE
+       *      - Set read mode
+       *        Argument: A read-only pointer to unsigned int
+       */
+
+      case NOTERAM_SETREADMODE:
+        if (arg == 0 ||
+            (*(FAR unsigned int *)arg != NOTERAM_MODE_READ_ASCII &&
+             *(FAR unsigned int *)arg != NOTERAM_MODE_READ_BINARY))
+          {
+            ret = -EINVAL;
+          }
+        else
+          {
+            drv->ni_read_mode = *(FAR unsigned int *)arg;
+            ret = OK;
+          }
+        break;
+
       default:
           break;
     }
@@ -546,6 +870,79 @@ static int noteram_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
  *
  ****************************************************************************/
 
+#ifdef CONFIG_DRIVERS_NOTERAM_PERCPU
+static void noteram_add(FAR struct note_driver_s *driver,
+                        FAR const void *note, size_t notelen)
+{
+  FAR struct noteram_driver_s *drv = (FAR struct noteram_driver_s *)driver;
+  FAR struct noteram_cpu_s *c;
+  FAR uint8_t *buffer;
+  unsigned int size = drv->ni_bufsize;
+  unsigned int head;
+  unsigned int tail;
+  unsigned int index;
+  unsigned int space;
+  irqstate_t flags;
+  int cpu;
+
+  /* Only this CPU adds notes to its buffer, so disabling the local
+   * interrupts is enough.
+   */
+
+  flags = up_irq_save();
+
+  if (drv->ni_overwrite == NOTERAM_MODE_OVERWRITE_OVERFLOW)
+    {
+      up_irq_restore(flags);
+      return;
+    }
+
+  DEBUGASSERT(note != NULL && notelen < size);
+
+  cpu    = this_cpu();
+  c      = &drv->ni_cpu[cpu];
+  buffer = drv->ni_buffer + cpu * size;
+  head   = c->head;
+  tail   = c->tail;
+
+  if (size - (head - tail) <= NOTE_ALIGN(notelen))
+    {
+      if (drv->ni_overwrite == NOTERAM_MODE_OVERWRITE_DISABLE)
+        {
+          /* Stop recording if not in overwrite mode */
+
+          drv->ni_overwrite = NOTERAM_MODE_OVERWRITE_OVERFLOW;
+          up_irq_restore(flags);
+          return;
+        }
+
+      /* Remove the notes at the tail, make sure there is enough space.
+       * The tail is published before the notes are overwritten.
+       */
+
+      do
+        {
+          tail += NOTE_ALIGN(buffer[tail & (size - 1)]);
+        }
+      while (size - (head - tail) <= NOTE_ALIGN(notelen));
+
+      c->tail = tail;
+      SP_DMB();
+    }
+
+  index = head & (size - 1);
+  space = size - index;
+  space = space < notelen ? space : notelen;
+  memcpy(buffer + index, note, space);
+  memcpy(buffer, (FAR const uint8_t *)note + space, notelen - space);
+
+  /* Publish the note */
+
+  SP_DMB();
+  c->head = head + NOTE_ALIGN(notelen);
+  up_irq_restore(flags);
+}
+#else
 static void noteram_add(FAR struct note_driver_s *driver,
                         FAR const void *note, size_t notelen)
 {
@@ -597,6 +994,7 @@ static void noteram_add(FAR struct note_driver_s *driver,
   drv->ni_head = noteram_next(drv, head, NOTE_ALIGN(notelen));
   spin_unlock_irqrestore_wo_note(&drv->lock, flags);
 }
+#endif
 
 /****************************************************************************
  * Name: noteram_dump_init_context
@@ -1130,19 +1528,17 @@ noteram_initialize(FAR const char *devpath, size_t bufsize, bool overwrite)
   FAR struct noteram_driver_s *drv;
   int ret;
 
-  drv = kmm_malloc(sizeof(*drv) + bufsize);
+  drv = kmm_zalloc(sizeof(*drv) + bufsize);
   if (drv == NULL)
     {
       return NULL;
     }
 
   drv->driver.ops = &g_noteram_ops;
-  drv->ni_bufsize = bufsize;
+  drv->ni_bufsize = NOTERAM_CPUSIZE(bufsize);
   drv->ni_buffer = (FAR uint8_t *)(drv + 1);
   drv->ni_overwrite = overwrite;
-  drv->ni_head = 0;
-  drv->ni_tail = 0;
-  drv->ni_read = 0;
+  drv->ni_read_mode = NOTERAM_MODE_READ_ASCII;
 
   ret = note_driver_register(&drv->driver);
   if (ret < 0)
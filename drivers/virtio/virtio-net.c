@@ -24,13 +24,20 @@
 
 #include <debug.h>
 #include <errno.h>
+#include <stdbool.h>
 #include <stdint.h>
 #include <string.h>
+#include <sys/param.h>
 
+#include <nuttx/arch.h>
 #include <nuttx/compiler.h>
 #include <nuttx/kmalloc.h>
+#include <nuttx/sched.h>
+#include <nuttx/net/ethernet.h>
 #include <nuttx/net/ip.h>
 #include <nuttx/net/netdev_lowerhalf.h>
+#include <nuttx/net/tcp.h>
+#include <nuttx/net/udp.h>
 #include <nuttx/virtio/virtio.h>
 #include <nuttx/net/wifi_sim.h>
 
@@ -42,31 +49,79 @@
 
 /* Virtio net feature bits */
 
-#define VIRTIO_NET_F_MAC      5
+#define VIRTIO_NET_F_CSUM       0
+#define VIRTIO_NET_F_GUEST_CSUM 1
+#define VIRTIO_NET_F_MAC        5
+#define VIRTIO_NET_F_HOST_TSO4  11
+#define VIRTIO_NET_F_HOST_TSO6  12
+#define VIRTIO_NET_F_MRG_RXBUF  15
+#define VIRTIO_NET_F_CTRL_VQ    17
+#define VIRTIO_NET_F_MQ         22
 
-/* Virtio net header size and packet buffer size */
+/* Virtio net header flags and GSO types */
 
-#define VIRTIO_NET_HDRSIZE    (sizeof(struct virtio_net_hdr_s))
+#define VIRTIO_NET_HDR_F_NEEDS_CSUM   1
+#define VIRTIO_NET_HDR_F_DATA_VALID   2
+
+#define VIRTIO_NET_HDR_GSO_NONE       0
+#define VIRTIO_NET_HDR_GSO_TCPV4      1
+#define VIRTIO_NET_HDR_GSO_TCPV6      4
+
+/* Virtio net control commands */
+
+#define VIRTIO_NET_CTRL_MQ            4
+#define VIRTIO_NET_CTRL_MQ_VQ_PAIRS_SET 0
+#define VIRTIO_NET_OK                 0
+
+/* Time to wait for the device to complete a control command, in ms */
+
+#define VIRTIO_NET_CTRL_TIMEOUT       1000
+
+/* Virtio net header size, without and with VIRTIO_NET_F_MRG_RXBUF, and
+ * packet buffer size
+ */
+
+#define VIRTIO_NET_HDRSIZE    offsetof(struct virtio_net_hdr_s, num_buffers)
+#define VIRTIO_NET_MRGHDRSIZE (sizeof(struct virtio_net_hdr_s))
 #define VIRTIO_NET_LLHDRSIZE  (sizeof(struct virtio_net_llhdr_s))
 #define VIRTIO_NET_BUFSIZE    (CONFIG_NET_ETH_PKTSIZE + CONFIG_NET_GUARDSIZE)
 
-/* Virtio net virtqueue index and number */
+/* Virtio net virtqueue index and number.  With VIRTIO_NET_F_MQ, the queue
+ * pair n uses the virtqueues 2n and 2n + 1, and the control virtqueue
+ * follows the last pair the device supports.
+ */
 
-#define VIRTIO_NET_RX         0
-#define VIRTIO_NET_TX         1
+#define VIRTIO_NET_RX(n)      (2 * (n))
+#define VIRTIO_NET_TX(n)      (2 * (n) + 1)
+#define VIRTIO_NET_CTRL(max)  (2 * (max))
 #define VIRTIO_NET_NUM        2
 
 #define VIRTIO_NET_MAX_PKT_SIZE \
     ((CONFIG_NET_LL_GUARDSIZE - ETH_HDRLEN) + VIRTIO_NET_BUFSIZE)
-#define VIRTIO_NET_MAX_NIOB \
+#define VIRTIO_NET_BUF_NIOB \
     ((VIRTIO_NET_MAX_PKT_SIZE + CONFIG_IOB_BUFSIZE - 1) / CONFIG_IOB_BUFSIZE)
 
+/* The largest packet handed down for TCP segmentation, which should not
+ * hog too many IOBs either.
+ */
+
+#ifdef CONFIG_NETDEV_OFFLOAD
+#  define VIRTIO_NET_TSOMAX \
+     MIN(UINT16_MAX, CONFIG_IOB_NBUFFERS * CONFIG_IOB_BUFSIZE / 4)
+#  define VIRTIO_NET_TSO_NIOB \
+     ((CONFIG_NET_LL_GUARDSIZE + VIRTIO_NET_TSOMAX + \
+       CONFIG_IOB_BUFSIZE - 1) / CONFIG_IOB_BUFSIZE)
+#  define VIRTIO_NET_MAX_NIOB MAX(VIRTIO_NET_BUF_NIOB, VIRTIO_NET_TSO_NIOB)
+#else
+#  define VIRTIO_NET_MAX_NIOB VIRTIO_NET_BUF_NIOB
+#endif
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
 
-/* Virtio net header, just define it here for further, now only use it
- * to calculate the virto net header size, see marco VIRTIO_NET_HDRSIZE
+/* Virtio net header.  num_buffers is only present if
+ * VIRTIO_NET_F_MRG_RXBUF is negotiated, see priv->hdrsize.
  */
 
 begin_packed_struct struct virtio_net_hdr_s
@@ -77,6 +132,17 @@ begin_packed_struct struct virtio_net_hdr_s
   uint16_t gso_size;
   uint16_t csum_start;
   uint16_t csum_offset;
+  uint16_t num_buffers;
+} end_packed_struct;
+
+/* Virtio net control command, only used to set the number of queue pairs */
+
+begin_packed_struct struct virtio_net_ctrl_s
+{
+  uint8_t  class;
+  uint8_t  cmd;
+  uint16_t pairs;
+  uint8_t  ack;
 } end_packed_struct;
 
 /* The definition of the struct virtio_net_config refers to the link
@@ -113,7 +179,30 @@ struct virtio_net_priv_s
   /* Virtio device information */
 
   FAR struct virtio_device *vdev;      /* Virtio device pointer */
-  int                       bufnum;    /* TX and RX Buffer number */
+  int                       bufnum;    /* TX Buffer number */
+  int                       rxbufnum;  /* RX Buffer number per queue */
+  uint16_t                  rxbuflen;  /* Length of the RX buffers */
+  uint8_t                   hdrsize;   /* Virtio net header size */
+  uint8_t                   npairs;    /* Number of queue pairs in use */
+  uint8_t                   rxnext;    /* Next RX queue to poll */
+
+  /* Queue pairs, the TX queue is selected by the sending CPU */
+
+  struct
+  {
+    FAR struct virtqueue   *rxq;
+    FAR struct virtqueue   *txq;
+    int                     rxposted;  /* RX buffers held by the device */
+  } queue[CONFIG_DRIVERS_VIRTIO_NET_QUEUE_PAIRS];
+
+  /* Scratch buffers to add a packet to a virtqueue, serialized by the
+   * network lock.
+   */
+
+  struct virtqueue_buf      vb[VIRTIO_NET_MAX_NIOB + 1];
+  struct iovec              iov[VIRTIO_NET_MAX_NIOB];
+
+  struct virtio_net_ctrl_s  ctrl;      /* Control command */
 };
 
 /* Virtio Link Layer Header, follow shows the iob buffer layout:
@@ -125,10 +214,15 @@ struct virtio_net_priv_s
  * |               |<--------- datalen -------->|
  * ^base           ^data
  *
- * CONFIG_NET_LL_GUARDSIZE >= VIRTIO_NET_LLHDRSIZE + ETH_HDR_SIZE
+ * CONFIG_NET_LL_GUARDSIZE >= VIRTIO_NET_LLHDRSIZE - 2 + ETH_HDR_SIZE
  *                          = sizeof(uintptr) + 10 + 14
  *                          = 32 (64-Bit)
  *                          = 28 (32-Bit)
+ *
+ * The header is placed right before the Ethernet header, so that without
+ * VIRTIO_NET_F_MRG_RXBUF its num_buffers field overlaps the data and is
+ * never accessed.  VIRTIO_NET_F_MRG_RXBUF is only negotiated if the guard
+ * size leaves room for the full header.
  */
 
 begin_packed_struct struct virtio_net_llhdr_s
@@ -137,7 +231,8 @@ begin_packed_struct struct virtio_net_llhdr_s
   struct virtio_net_hdr_s vhdr;        /* Virtio net header */
 } end_packed_struct;
 
-static_assert(CONFIG_NET_LL_GUARDSIZE >= VIRTIO_NET_LLHDRSIZE + ETH_HDRLEN,
+static_assert(CONFIG_NET_LL_GUARDSIZE >= VIRTIO_NET_LLHDRSIZE -
+              VIRTIO_NET_MRGHDRSIZE + VIRTIO_NET_HDRSIZE + ETH_HDRLEN,
               "CONFIG_NET_LL_GUARDSIZE cannot be less than ETH_HDRLEN"
               " + VIRTIO_NET_LLHDRSIZE");
 
@@ -201,18 +296,114 @@ static uint8_t g_netdev_num = 0;
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: virtio_net_llhdr
+ *
+ * Description:
+ *   Return the link layer header of a netpkt, right before its data.
+ *
+ ****************************************************************************/
+
+static FAR struct virtio_net_llhdr_s *
+virtio_net_llhdr(FAR struct virtio_net_priv_s *priv, FAR uint8_t *data)
+{
+  return (FAR struct virtio_net_llhdr_s *)
+    (data - priv->hdrsize - offsetof(struct virtio_net_llhdr_s, vhdr));
+}
+
+/****************************************************************************
+ * Name: virtio_net_txoffload
+ *
+ * Description:
+ *   Fill the checksum and segmentation offload requests of a packet in its
+ *   virtio net header.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NETDEV_OFFLOAD
+static int virtio_net_txoffload(FAR struct netdev_lowerhalf_s *dev,
+                                FAR netpkt_t *pkt,
+                                FAR struct virtio_net_hdr_s *vhdr)
+{
+  uint8_t buf[ETH_HDRLEN + sizeof(struct ipv6_hdr_s) + TCP_HDRLEN];
+  FAR struct eth_hdr_s *eth = (FAR struct eth_hdr_s *)buf;
+  FAR struct tcp_hdr_s *tcp;
+  unsigned int len;
+  uint16_t l4off;
+  uint8_t proto;
+  bool ipv4;
+
+  if (!netpkt_csum_partial(pkt))
+    {
+      /* A segmentation request always comes with a checksum request */
+
+      return netpkt_gsosize(pkt) > 0 ? -EINVAL : OK;
+    }
+
+  /* Only the headers built by the stack are expected here: IPv4 without
+   * options or IPv6 without extension headers, followed by TCP or UDP.
+   */
+
+  len = MIN(netpkt_getdatalen(dev, pkt), sizeof(buf));
+  netpkt_copyout(dev, buf, pkt, len, 0);
+
+  ipv4 = eth->type == HTONS(ETHTYPE_IP);
+  if (ipv4)
+    {
+      l4off = ETH_HDRLEN + ((buf[ETH_HDRLEN] & 0x0f) << 2);
+      proto = buf[ETH_HDRLEN + offsetof(struct ipv4_hdr_s, proto)];
+    }
+  else if (eth->type == HTONS(ETHTYPE_IP6))
+    {
+      l4off = ETH_HDRLEN + sizeof(struct ipv6_hdr_s);
+      proto = buf[ETH_HDRLEN + offsetof(struct ipv6_hdr_s, proto)];
+    }
+  else
+    {
+      return -EINVAL;
+    }
+
+  vhdr->flags      = VIRTIO_NET_HDR_F_NEEDS_CSUM;
+  vhdr->csum_start = l4off;
+  if (proto == IP_PROTO_TCP && l4off + TCP_HDRLEN <= len)
+    {
+      vhdr->csum_offset = offsetof(struct tcp_hdr_s, tcpchksum);
+    }
+  else if (proto == IP_PROTO_UDP)
+    {
+      vhdr->csum_offset = offsetof(struct udp_hdr_s, udpchksum);
+      return OK;
+    }
+  else
+    {
+      return -EINVAL;
+    }
+
+  if (netpkt_gsosize(pkt) > 0)
+    {
+      tcp = (FAR struct tcp_hdr_s *)&buf[l4off];
+      vhdr->gso_type = ipv4 ? VIRTIO_NET_HDR_GSO_TCPV4 :
+                              VIRTIO_NET_HDR_GSO_TCPV6;
+      vhdr->gso_size = netpkt_gsosize(pkt);
+      vhdr->hdr_len  = l4off + ((tcp->tcpoffset >> 4) << 2);
+    }
+
+  return OK;
+}
+#endif
+
 /****************************************************************************
  * Name: virtio_net_addbuffer
  ****************************************************************************/
 
 static int virtio_net_addbuffer(FAR struct netdev_lowerhalf_s *dev,
                                 FAR struct virtqueue *vq, FAR netpkt_t *pkt,
-                                unsigned int vq_id)
+                                bool rx)
 {
   FAR struct virtio_net_priv_s *priv = (FAR struct virtio_net_priv_s *)dev;
+  FAR struct virtqueue_buf *vb = priv->vb;
+  FAR struct iovec *iov = priv->iov;
   FAR struct virtio_net_llhdr_s *hdr;
-  struct virtqueue_buf vb[VIRTIO_NET_MAX_NIOB + 1];
-  struct iovec iov[VIRTIO_NET_MAX_NIOB];
   int iov_cnt;
   int i;
 
@@ -222,12 +413,23 @@ static int virtio_net_addbuffer(FAR struct netdev_lowerhalf_s *dev,
 
   /* Alloc cookie and net header from transport layer */
 
-  hdr = (FAR struct virtio_net_llhdr_s *)
-          ((FAR uint8_t *)iov[0].iov_base - VIRTIO_NET_LLHDRSIZE);
+  hdr = virtio_net_llhdr(priv, iov[0].iov_base);
   DEBUGASSERT((FAR uint8_t *)hdr >= netpkt_getbase(pkt));
-  memset(&hdr->vhdr, 0, sizeof(hdr->vhdr));
+  memset(&hdr->vhdr, 0, priv->hdrsize);
   hdr->pkt = pkt;
 
+#ifdef CONFIG_NETDEV_OFFLOAD
+  if (!rx)
+    {
+      int ret = virtio_net_txoffload(dev, pkt, &hdr->vhdr);
+      if (ret < 0)
+        {
+          vrterr("Unsupported offload request\n");
+          return ret;
+        }
+    }
+#endif
+
   /* Prepare buffers depends on the feature VIRTIO_F_ANY_LAYOUT */
 
   if (virtio_has_feature(priv->vdev, VIRTIO_F_ANY_LAYOUT))
@@ -235,22 +437,20 @@ static int virtio_net_addbuffer(FAR struct netdev_lowerhalf_s *dev,
       /* Append the virtio net header to the first buffer */
 
       vb[0].buf = &hdr->vhdr;
-      vb[0].len = iov[0].iov_len + VIRTIO_NET_HDRSIZE;
+      vb[0].len = iov[0].iov_len + priv->hdrsize;
 
-#if VIRTIO_NET_MAX_NIOB > 1
       for (i = 1; i < iov_cnt; i++)
         {
           vb[i].buf = iov[i].iov_base;
           vb[i].len = iov[i].iov_len;
         }
-#endif
     }
   else
     {
       /* Buffer 0 is only for virtio net header */
 
       vb[0].buf = &hdr->vhdr;
-      vb[0].len = VIRTIO_NET_HDRSIZE;
+      vb[0].len = priv->hdrsize;
 
       for (i = 0; i < iov_cnt; i++)
         {
@@ -261,8 +461,8 @@ static int virtio_net_addbuffer(FAR struct netdev_lowerhalf_s *dev,
       iov_cnt++;
     }
 
-  vrtinfo("Fill vq=%u, hdr=%p, count=%d\n", vq_id, hdr, iov_cnt);
-  if (vq_id == VIRTIO_NET_RX)
+  vrtinfo("Fill vq=%p, hdr=%p, count=%d\n", vq, hdr, iov_cnt);
+  if (rx)
     {
       return virtqueue_add_buffer(vq, vb, 0, iov_cnt, hdr);
     }
@@ -279,39 +479,52 @@ static int virtio_net_addbuffer(FAR struct netdev_lowerhalf_s *dev,
 static void virtio_net_rxfill(FAR struct netdev_lowerhalf_s *dev)
 {
   FAR struct virtio_net_priv_s *priv = (FAR struct virtio_net_priv_s *)dev;
-  FAR struct virtqueue *vq = priv->vdev->vrings_info[VIRTIO_NET_RX].vq;
+  FAR struct virtqueue *vq;
   FAR netpkt_t *pkt;
-  int i;
+  int added;
+  int n;
 
-  for (i = 0; i < priv->bufnum; i++)
+  for (n = 0; n < priv->npairs; n++)
     {
-      /* IOB Offload, Alloc buffer from RX netpkt */
+      vq    = priv->queue[n].rxq;
+      added = 0;
 
-      pkt = netpkt_alloc(dev, NETPKT_RX);
-      if (pkt == NULL)
+      while (priv->queue[n].rxposted < priv->rxbufnum)
         {
-          vrtinfo("Has ran out of the RX buffer, i=%d\n", i);
-          break;
+          /* IOB Offload, Alloc buffer from RX netpkt */
+
+          pkt = netpkt_alloc(dev, NETPKT_RX);
+          if (pkt == NULL)
+            {
+              vrtinfo("Has ran out of the RX buffer, n=%d\n", n);
+              break;
+            }
+
+          /* Preserve data length */
+
+          if (netpkt_setdatalen(dev, pkt, priv->rxbuflen) < priv->rxbuflen)
+            {
+              vrtwarn("No enough buffer to prepare RX buffer, n=%d\n", n);
+              netpkt_free(dev, pkt, NETPKT_RX);
+              break;
+            }
+
+          /* Add buffer to RX virtqueue */
+
+          if (virtio_net_addbuffer(dev, vq, pkt, true) < 0)
+            {
+              netpkt_free(dev, pkt, NETPKT_RX);
+              break;
+            }
+
+          priv->queue[n].rxposted++;
+          added++;
         }
 
-      /* Preserve data length */
-
-      if (netpkt_setdatalen(dev, pkt, VIRTIO_NET_BUFSIZE) <
-          VIRTIO_NET_BUFSIZE)
+      if (added > 0)
         {
-          vrtwarn("No enough buffer to prepare RX buffer, i=%d\n", i);
-          netpkt_free(dev, pkt, NETPKT_RX);
-          break;
+          virtqueue_kick(vq);
         }
-
-      /* Add buffer to RX virtqueue */
-
-      virtio_net_addbuffer(dev, vq, pkt, VIRTIO_NET_RX);
-    }
-
-  if (i > 0)
-    {
-      virtqueue_kick(vq);
     }
 }
 
@@ -322,21 +535,19 @@ static void virtio_net_rxfill(FAR struct netdev_lowerhalf_s *dev)
 static void virtio_net_txfree(FAR struct netdev_lowerhalf_s *dev)
 {
   FAR struct virtio_net_priv_s *priv = (FAR struct virtio_net_priv_s *)dev;
-  FAR struct virtqueue *vq = priv->vdev->vrings_info[VIRTIO_NET_TX].vq;
   FAR struct virtio_net_llhdr_s *hdr;
+  int n;
 
-  while (1)
+  for (n = 0; n < priv->npairs; n++)
     {
       /* Get buffer from tx virtqueue */
 
-      hdr = virtqueue_get_buffer(vq, NULL, NULL);
-      if (hdr == NULL)
+      while ((hdr = virtqueue_get_buffer(priv->queue[n].txq,
+                                         NULL, NULL)) != NULL)
         {
-          break;
+          netpkt_free(dev, hdr->pkt, NETPKT_TX);
+          vrtinfo("Free, hdr: %p, pkt: %p\n", hdr, hdr->pkt);
         }
-
-      netpkt_free(dev, hdr->pkt, NETPKT_TX);
-      vrtinfo("Free, hdr: %p, pkt: %p\n", hdr, hdr->pkt);
     }
 }
 
@@ -347,6 +558,7 @@ static void virtio_net_txfree(FAR struct netdev_lowerhalf_s *dev)
 static int virtio_net_ifup(FAR struct netdev_lowerhalf_s *dev)
 {
   FAR struct virtio_net_priv_s *priv = (FAR struct virtio_net_priv_s *)dev;
+  int n;
 
 #ifdef CONFIG_NET_IPv4
   vrtinfo("Bringing up: %u.%u.%u.%u\n",
@@ -363,7 +575,11 @@ static int virtio_net_ifup(FAR struct netdev_lowerhalf_s *dev)
 
   /* Prepare interrupt and packets for receiving */
 
-  virtqueue_enable_cb(priv->vdev->vrings_info[VIRTIO_NET_RX].vq);
+  for (n = 0; n < priv->npairs; n++)
+    {
+      virtqueue_enable_cb(priv->queue[n].rxq);
+    }
+
   virtio_net_rxfill(dev);
 
 #ifdef CONFIG_DRIVERS_WIFI_SIM
@@ -383,13 +599,14 @@ static int virtio_net_ifup(FAR struct netdev_lowerhalf_s *dev)
 static int virtio_net_ifdown(FAR struct netdev_lowerhalf_s *dev)
 {
   FAR struct virtio_net_priv_s *priv = (FAR struct virtio_net_priv_s *)dev;
-  int i;
+  int n;
 
   /* Disable the Ethernet interrupt */
 
-  for (i = 0; i < VIRTIO_NET_NUM; i++)
+  for (n = 0; n < priv->npairs; n++)
     {
-      virtqueue_disable_cb(priv->vdev->vrings_info[i].vq);
+      virtqueue_disable_cb(priv->queue[n].rxq);
+      virtqueue_disable_cb(priv->queue[n].txq);
     }
 
 #ifdef CONFIG_DRIVERS_WIFI_SIM
@@ -413,11 +630,14 @@ static int virtio_net_send(FAR struct netdev_lowerhalf_s *dev,
                            FAR netpkt_t *pkt)
 {
   FAR struct virtio_net_priv_s *priv = (FAR struct virtio_net_priv_s *)dev;
-  FAR struct virtqueue *vq = priv->vdev->vrings_info[VIRTIO_NET_TX].vq;
+  FAR struct virtqueue *vq = priv->queue[this_cpu() % priv->npairs].txq;
+  int ret;
+  int n;
 
   /* Check the send length */
 
-  if (netpkt_getdatalen(dev, pkt) > VIRTIO_NET_BUFSIZE)
+  if (netpkt_getdatalen(dev, pkt) > VIRTIO_NET_BUFSIZE &&
+      netpkt_gsosize(pkt) == 0)
     {
       vrterr("net send buffer too large\n");
       return -EINVAL;
@@ -425,7 +645,12 @@ static int virtio_net_send(FAR struct netdev_lowerhalf_s *dev,
 
   /* Add buffer to vq and notify the other side */
 
-  virtio_net_addbuffer(dev, vq, pkt, VIRTIO_NET_TX);
+  ret = virtio_net_addbuffer(dev, vq, pkt, false);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
   virtqueue_kick(vq);
 
   /* Try return Netpkt TX buffer to upper-half. */
@@ -436,12 +661,83 @@ static int virtio_net_send(FAR struct netdev_lowerhalf_s *dev,
 
   if (netdev_lower_quota_load(dev, NETPKT_TX) <= 0)
     {
-      virtqueue_enable_cb(vq);
+      for (n = 0; n < priv->npairs; n++)
+        {
+          virtqueue_enable_cb(priv->queue[n].txq);
+        }
     }
 
   return OK;
 }
 
+/****************************************************************************
+ * Name: virtio_net_rxmerge
+ *
+ * Description:
+ *   Set up a received packet.  With VIRTIO_NET_F_MRG_RXBUF, the packet may
+ *   span several RX buffers, which are chained to the first one without
+ *   copying the data.
+ *
+ ****************************************************************************/
+
+static FAR netpkt_t *virtio_net_rxmerge(FAR struct netdev_lowerhalf_s *dev,
+                                        int n,
+                                        FAR struct virtio_net_llhdr_s *hdr,
+                                        uint32_t len)
+{
+  FAR struct virtio_net_priv_s *priv = (FAR struct virtio_net_priv_s *)dev;
+  FAR netpkt_t *pkt = hdr->pkt;
+  FAR netpkt_t *next;
+  uint16_t nbufs = 1;
+
+  if (priv->hdrsize == VIRTIO_NET_MRGHDRSIZE)
+    {
+      nbufs = MAX(hdr->vhdr.num_buffers, 1);
+    }
+
+#ifdef CONFIG_NETDEV_OFFLOAD
+  /* A packet whose checksum the device verified, or which never went
+   * through a wire (VIRTIO_NET_HDR_F_NEEDS_CSUM), is not checked again.
+   */
+
+  if ((hdr->vhdr.flags & (VIRTIO_NET_HDR_F_NEEDS_CSUM |
+                          VIRTIO_NET_HDR_F_DATA_VALID)) != 0)
+    {
+      netpkt_set_csum_valid(pkt);
+    }
+#endif
+
+  /* Set the received pkt length */
+
+  netpkt_setdatalen(dev, pkt, len - priv->hdrsize);
+  vrtinfo("Recv, hdr=%p, pkt=%p, len=%" PRIu32 "\n", hdr, pkt, len);
+
+  while (--nbufs > 0)
+    {
+      hdr = virtqueue_get_buffer(priv->queue[n].rxq, &len, NULL);
+      if (hdr == NULL)
+        {
+          vrterr("Missing RX buffer of a merged packet\n");
+          netpkt_free(dev, pkt, NETPKT_RX);
+          return NULL;
+        }
+
+      priv->queue[n].rxposted--;
+
+      /* The data of the following buffers starts where the header would
+       * be.  The chained buffer no longer counts against the RX quota.
+       */
+
+      next = hdr->pkt;
+      next->io_offset = (FAR uint8_t *)&hdr->vhdr - next->io_data;
+      iob_update_pktlen(next, len, false);
+      iob_concat(pkt, next);
+      atomic_fetch_add(&dev->quota[NETPKT_RX], 1);
+    }
+
+  return pkt;
+}
+
 /****************************************************************************
  * Name: virtio_net_recv
  ****************************************************************************/
@@ -449,32 +745,48 @@ static int virtio_net_send(FAR struct netdev_lowerhalf_s *dev,
 static netpkt_t *virtio_net_recv(FAR struct netdev_lowerhalf_s *dev)
 {
   FAR struct virtio_net_priv_s *priv = (FAR struct virtio_net_priv_s *)dev;
-  FAR struct virtqueue *vq = priv->vdev->vrings_info[VIRTIO_NET_RX].vq;
   FAR struct virtio_net_llhdr_s *hdr;
+  FAR netpkt_t *pkt;
   uint32_t len;
+  int empty = 0;
+  int n;
 
-  /* Fill the free Netpkt RX buffer to the RX virtqueue */
+  /* Fill the free Netpkt RX buffer to the RX virtqueues */
 
   virtio_net_rxfill(dev);
 
-  /* Get received buffer form RX virtqueue */
+  /* Get received buffer form the RX virtqueues in turn */
 
-  hdr = virtqueue_get_buffer(vq, &len, NULL);
-  if (hdr == NULL)
+  while (empty < priv->npairs)
     {
-      /* If we have no buffer left, enable RX callback. */
+      n = priv->rxnext;
+      priv->rxnext = (n + 1) % priv->npairs;
+
+      hdr = virtqueue_get_buffer(priv->queue[n].rxq, &len, NULL);
+      if (hdr == NULL)
+        {
+          empty++;
+          continue;
+        }
 
-      virtqueue_enable_cb(vq);
+      priv->queue[n].rxposted--;
 
-      vrtinfo("get NULL buffer\n");
-      return NULL;
+      pkt = virtio_net_rxmerge(dev, n, hdr, len);
+      if (pkt != NULL)
+        {
+          return pkt;
+        }
     }
 
-  /* Set the received pkt length */
+  /* If we have no buffer left, enable RX callback. */
 
-  netpkt_setdatalen(dev, hdr->pkt, len - VIRTIO_NET_HDRSIZE);
-  vrtinfo("Recv, hdr=%p, pkt=%p, len=%" PRIu32 "\n", hdr, hdr->pkt, len);
-  return hdr->pkt;
+  for (n = 0; n < priv->npairs; n++)
+    {
+      virtqueue_enable_cb(priv->queue[n].rxq);
+    }
+
+  vrtinfo("get NULL buffer\n");
+  return NULL;
 }
 
 #ifdef CONFIG_NET_MCASTGROUP
@@ -535,6 +847,56 @@ static void virtio_net_txdone(FAR struct virtqueue *vq)
   netdev_lower_txdone((FAR struct netdev_lowerhalf_s *)priv);
 }
 
+/****************************************************************************
+ * Name: virtio_net_setpairs
+ *
+ * Description:
+ *   Tell the device how many queue pairs are used.  Like the other control
+ *   commands, this is only issued at initialization and the completion is
+ *   polled, for at most VIRTIO_NET_CTRL_TIMEOUT milliseconds.
+ *
+ ****************************************************************************/
+
+static int virtio_net_setpairs(FAR struct virtio_net_priv_s *priv,
+                               FAR struct virtqueue *vq)
+{
+  FAR struct virtio_net_ctrl_s *ctrl = &priv->ctrl;
+  struct virtqueue_buf vb[3];
+  int ret;
+  int n;
+
+  ctrl->class = VIRTIO_NET_CTRL_MQ;
+  ctrl->cmd   = VIRTIO_NET_CTRL_MQ_VQ_PAIRS_SET;
+  ctrl->pairs = priv->npairs;
+  ctrl->ack   = ~VIRTIO_NET_OK;
+
+  vb[0].buf = &ctrl->class;
+  vb[0].len = 2;
+  vb[1].buf = &ctrl->pairs;
+  vb[1].len = sizeof(ctrl->pairs);
+  vb[2].buf = &ctrl->ack;
+  vb[2].len = sizeof(ctrl->ack);
+
+  ret = virtqueue_add_buffer(vq, vb, 2, 1, ctrl);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  virtqueue_kick(vq);
+  for (n = 0; virtqueue_get_buffer(vq, NULL, NULL) == NULL; n++)
+    {
+      if (n >= VIRTIO_NET_CTRL_TIMEOUT)
+        {
+          return -ETIMEDOUT;
+        }
+
+      up_udelay(1000);
+    }
+
+  return ctrl->ack == VIRTIO_NET_OK ? OK : -EIO;
+}
+
 /****************************************************************************
  * Name: virtio_net_init
  ****************************************************************************/
@@ -542,26 +904,90 @@ static void virtio_net_txdone(FAR struct virtqueue *vq)
 static int virtio_net_init(FAR struct virtio_net_priv_s *priv,
                            FAR struct virtio_device *vdev)
 {
-  FAR const char *vqnames[VIRTIO_NET_NUM];
-  vq_callback callbacks[VIRTIO_NET_NUM];
+  FAR const char **vqnames;
+  FAR vq_callback *callbacks;
+  uint16_t maxpairs = 1;
+  uint32_t features;
+  int nvqs = VIRTIO_NET_NUM;
   int ret;
+  int n;
 
   priv->vdev = vdev;
   vdev->priv = priv;
 
   /* Initialize the virtio device */
 
+  features = (1UL << VIRTIO_NET_F_MAC) | (1UL << VIRTIO_F_ANY_LAYOUT);
+#ifdef CONFIG_NETDEV_OFFLOAD
+  features |= (1UL << VIRTIO_NET_F_CSUM) |
+              (1UL << VIRTIO_NET_F_GUEST_CSUM);
+#  ifdef CONFIG_NET_TCP_CHECKSUMS
+  /* The segments are only checksummed by the device if the stack seeds
+   * their checksum, which it does not without TCP checksums.
+   */
+
+  features |= (1UL << VIRTIO_NET_F_HOST_TSO4) |
+              (1UL << VIRTIO_NET_F_HOST_TSO6);
+#  endif
+#endif
+  if (CONFIG_NET_LL_GUARDSIZE >= VIRTIO_NET_LLHDRSIZE + ETH_HDRLEN)
+    {
+      features |= 1UL << VIRTIO_NET_F_MRG_RXBUF;
+    }
+
+#if CONFIG_DRIVERS_VIRTIO_NET_QUEUE_PAIRS > 1
+  features |= (1UL << VIRTIO_NET_F_CTRL_VQ) | (1UL << VIRTIO_NET_F_MQ);
+#endif
+
   virtio_set_status(vdev, VIRTIO_CONFIG_STATUS_DRIVER);
-  virtio_negotiate_features(vdev, (1UL << VIRTIO_NET_F_MAC) |
-                                  (1UL << VIRTIO_F_ANY_LAYOUT));
+  virtio_negotiate_features(vdev, features);
   virtio_set_status(vdev, VIRTIO_CONFIG_FEATURES_OK);
 
-  vqnames[VIRTIO_NET_RX]   = "virtio_net_rx";
-  vqnames[VIRTIO_NET_TX]   = "virtio_net_tx";
-  callbacks[VIRTIO_NET_RX] = virtio_net_rxready;
-  callbacks[VIRTIO_NET_TX] = virtio_net_txdone;
-  ret = virtio_create_virtqueues(vdev, 0, VIRTIO_NET_NUM, vqnames,
-                                 callbacks);
+  if (virtio_has_feature(vdev, VIRTIO_NET_F_MQ) &&
+      virtio_has_feature(vdev, VIRTIO_NET_F_CTRL_VQ))
+    {
+      virtio_read_config_member(vdev, struct virtio_net_config_s,
+                                max_virtqueue_pairs, &maxpairs);
+      maxpairs = MAX(maxpairs, 1);
+      nvqs     = VIRTIO_NET_CTRL(maxpairs) + 1;
+    }
+
+  priv->npairs  = MIN(maxpairs, CONFIG_DRIVERS_VIRTIO_NET_QUEUE_PAIRS);
+  priv->hdrsize = virtio_has_feature(vdev, VIRTIO_NET_F_MRG_RXBUF) ?
+                  VIRTIO_NET_MRGHDRSIZE : VIRTIO_NET_HDRSIZE;
+
+  /* All the queue pairs of the device must be created for the control
+   * virtqueue to be found, even if only some of them are used.
+   */
+
+  vqnames   = kmm_malloc(nvqs * (sizeof(*vqnames) + sizeof(*callbacks)));
+  if (vqnames == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  callbacks = (FAR vq_callback *)&vqnames[nvqs];
+  for (n = 0; n < nvqs; n++)
+    {
+      if (n == VIRTIO_NET_CTRL(maxpairs))
+        {
+          vqnames[n]   = "virtio_net_ctrl";
+          callbacks[n] = NULL;
+        }
+      else if (n % 2 == 0)
+        {
+          vqnames[n]   = "virtio_net_rx";
+          callbacks[n] = virtio_net_rxready;
+        }
+      else
+        {
+          vqnames[n]   = "virtio_net_tx";
+          callbacks[n] = virtio_net_txdone;
+        }
+    }
+
+  ret = virtio_create_virtqueues(vdev, 0, nvqs, vqnames, callbacks);
+  kmm_free(vqnames);
   if (ret < 0)
     {
       vrterr("virtio_device_create_virtqueue failed, ret=%d\n", ret);
@@ -570,22 +996,115 @@ static int virtio_net_init(FAR struct virtio_net_priv_s *priv,
 
   virtio_set_status(vdev, VIRTIO_CONFIG_STATUS_DRIVER_OK);
 
+  if (nvqs > VIRTIO_NET_NUM)
+    {
+      ret = virtio_net_setpairs(priv,
+                vdev->vrings_info[VIRTIO_NET_CTRL(maxpairs)].vq);
+      if (ret < 0)
+        {
+          /* The device keeps using a single queue pair until the command
+           * succeeds.
+           */
+
+          vrtwarn("Set queue pairs failed, ret=%d, use one pair\n", ret);
+          priv->npairs = 1;
+        }
+    }
+
 #if CONFIG_DRIVERS_VIRTIO_NET_BUFNUM > 0
-  priv->bufnum = CONFIG_DRIVERS_VIRTIO_NET_BUFNUM;
+  priv->bufnum   = CONFIG_DRIVERS_VIRTIO_NET_BUFNUM;
+  priv->rxbufnum = CONFIG_DRIVERS_VIRTIO_NET_BUFNUM;
 #else
   /* Calculate the virtio network buffer number:
-   * 1/4 for the TX netpkts, 1/4 for the RX netpkts.
+   * 1/4 for the TX netpkts, 1/4 for the RX netpkts.  Merged RX buffers
+   * only take one IOB each.
    */
 
-  priv->bufnum = CONFIG_IOB_NBUFFERS / VIRTIO_NET_MAX_NIOB / 4;
+  priv->bufnum   = CONFIG_IOB_NBUFFERS / VIRTIO_NET_BUF_NIOB / 4;
+  priv->rxbufnum = priv->hdrsize == VIRTIO_NET_MRGHDRSIZE ?
+                   CONFIG_IOB_NBUFFERS / 4 : priv->bufnum;
 #endif
-  priv->bufnum = MIN(vdev->vrings_info[VIRTIO_NET_RX].info.num_descs,
-                     priv->bufnum);
-  priv->bufnum = MIN(vdev->vrings_info[VIRTIO_NET_TX].info.num_descs,
-                     priv->bufnum);
+
+  /* With merged RX buffers, a large packet is received in several IOBs
+   * rather than every RX buffer being large enough for it.
+   */
+
+  priv->rxbuflen = VIRTIO_NET_BUFSIZE;
+  if (priv->hdrsize == VIRTIO_NET_MRGHDRSIZE)
+    {
+      priv->rxbuflen = MIN(priv->rxbuflen, CONFIG_IOB_BUFSIZE -
+                           CONFIG_NET_LL_GUARDSIZE + ETH_HDRLEN);
+    }
+
+  priv->rxbufnum = MAX(priv->rxbufnum / priv->npairs, 1);
+  for (n = 0; n < priv->npairs; n++)
+    {
+      FAR struct virtio_vring_info *rx =
+        &vdev->vrings_info[VIRTIO_NET_RX(n)];
+      FAR struct virtio_vring_info *tx =
+        &vdev->vrings_info[VIRTIO_NET_TX(n)];
+
+      priv->queue[n].rxq = rx->vq;
+      priv->queue[n].txq = tx->vq;
+      priv->rxbufnum = MIN(rx->info.num_descs, priv->rxbufnum);
+      priv->bufnum   = MIN(tx->info.num_descs, priv->bufnum);
+    }
+
   return OK;
 }
 
+/****************************************************************************
+ * Name: virtio_net_setfeatures
+ *
+ * Description:
+ *   Advertise the offloads negotiated with the device to the stack.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NETDEV_OFFLOAD
+static void virtio_net_setfeatures(FAR struct virtio_net_priv_s *priv)
+{
+  FAR struct net_driver_s *dev =
+                   &((FAR struct netdev_lowerhalf_s *)&priv->lower)->netdev;
+  FAR struct virtio_device *vdev = priv->vdev;
+  int maxniob = VIRTIO_NET_MAX_NIOB;
+  int n;
+
+  dev->d_features = 0;
+  if (virtio_has_feature(vdev, VIRTIO_NET_F_GUEST_CSUM))
+    {
+      dev->d_features |= NETDEV_F_RXCSUM;
+    }
+
+  if (!virtio_has_feature(vdev, VIRTIO_NET_F_CSUM))
+    {
+      return;
+    }
+
+  dev->d_features |= NETDEV_F_TXCSUM;
+  if (virtio_has_feature(vdev, VIRTIO_NET_F_HOST_TSO4))
+    {
+      dev->d_features |= NETDEV_F_TSO4;
+    }
+
+  if (virtio_has_feature(vdev, VIRTIO_NET_F_HOST_TSO6))
+    {
+      dev->d_features |= NETDEV_F_TSO6;
+    }
+
+  /* A segmentation request must fit in every TX virtqueue */
+
+  for (n = 0; n < priv->npairs; n++)
+    {
+      maxniob = MIN(maxniob,
+                    vdev->vrings_info[VIRTIO_NET_TX(n)].info.num_descs - 1);
+    }
+
+  dev->d_tsomax = MIN(VIRTIO_NET_TSOMAX, maxniob * CONFIG_IOB_BUFSIZE -
+                      CONFIG_NET_LL_GUARDSIZE);
+}
+#endif
+
 static void virtio_net_set_macaddr(FAR struct virtio_net_priv_s *priv)
 {
   FAR struct net_driver_s *dev =
@@ -650,10 +1169,14 @@ static int virtio_net_probe(FAR struct virtio_device *vdev)
   /* Initialize the netdev lower half */
 
   netdev = (FAR struct netdev_lowerhalf_s *)priv;
-  netdev->quota[NETPKT_RX] = priv->bufnum;
+  netdev->quota[NETPKT_RX] = priv->rxbufnum * priv->npairs;
   netdev->quota[NETPKT_TX] = priv->bufnum;
   netdev->ops = &g_virtio_net_ops;
 
+#ifdef CONFIG_NETDEV_OFFLOAD
+  virtio_net_setfeatures(priv);
+#endif
+
 #ifdef CONFIG_DRIVERS_WIFI_SIM
   /* If the WiFi interfaces has reached the setting value,
    * no more WiFi interfaces will be created.
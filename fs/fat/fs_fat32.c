@@ -24,6 +24,7 @@
 
 #include <nuttx/config.h>
 
+#include <sys/param.h>
 #include <sys/types.h>
 #include <sys/stat.h>
 #include <sys/statfs.h>
@@ -467,6 +468,10 @@ static int fat_close(FAR struct file *filep)
       fat_io_free(ff->ff_buffer, fs->fs_hwsectorsize);
     }
 
+#ifdef CONFIG_FAT_EXTENT_MAP
+  fat_extentmap_free(ff);
+#endif
+
   /* Then free the file structure itself. */
 
   fs_heap_free(ff);
@@ -615,6 +620,26 @@ static int fat_get_sectors(FAR struct file *filep, bool read)
       num_traversed = 1;
     }
 
+#ifdef CONFIG_FAT_EXTENT_MAP
+  /* Look the cluster up in the extent map instead of walking the chain */
+
+  if (num_traversed > 0 && num_traversed < MIN(num_clu, new_num_clu))
+    {
+      off_t mapped = fat_extentmap_cluster(fs, ff,
+                                           MIN(num_clu, new_num_clu) - 1,
+                                           NULL);
+      if (mapped >= 0)
+        {
+          cluster       = mapped;
+          num_traversed = MIN(num_clu, new_num_clu);
+        }
+      else if (mapped != -ENOMEM)
+        {
+          return mapped;
+        }
+    }
+#endif
+
   /* Traverse the existing chain */
 
   for (i = num_traversed; i < num_clu && i < new_num_clu; i++)
@@ -739,6 +764,113 @@ out:
   return 0;
 }
 
+#ifndef CONFIG_FAT_FORCE_INDIRECT
+/****************************************************************************
+ * Name: fat_contig_sectors
+ *
+ * Description:
+ *   Return how many of the next 'nsectors' sectors of the file, starting
+ *   at the current sector, are contiguous on the media and can be
+ *   transferred with a single request.  These are the sectors remaining in
+ *   the current cluster and, with the cluster extent map, the sectors of
+ *   the contiguous clusters that follow it.  When writing, the clusters
+ *   past the end of the chain are allocated as long as they are contiguous
+ *   with it.
+ *
+ ****************************************************************************/
+
+static unsigned int fat_contig_sectors(FAR struct file *filep,
+                                       unsigned int nsectors, bool read)
+{
+  FAR struct fat_file_s *ff = filep->f_priv;
+  unsigned int avail = ff->ff_sectorsincluster;
+#ifdef CONFIG_FAT_EXTENT_MAP
+  FAR struct fat_mountpt_s *fs = filep->f_inode->i_private;
+  off_t clu_size = fs->fs_fatsecperclus * fs->fs_hwsectorsize;
+  uint32_t num_clu = DIV_ROUND_UP(ff->ff_size, clu_size);
+  uint32_t index = filep->f_pos / clu_size;
+  uint32_t last;
+  uint32_t ncontig;
+  int32_t next;
+  off_t cluster;
+
+  if (avail >= nsectors)
+    {
+      return nsectors;
+    }
+
+  /* Map the chain up to the last cluster of the transfer within the file */
+
+  last = (filep->f_pos + (off_t)nsectors * fs->fs_hwsectorsize - 1) /
+         clu_size;
+  if (last >= num_clu)
+    {
+      last = num_clu > 0 ? num_clu - 1 : 0;
+    }
+
+  if (last > index && fat_extentmap_cluster(fs, ff, last, NULL) < 0)
+    {
+      return avail;
+    }
+
+  cluster = fat_extentmap_cluster(fs, ff, index, &ncontig);
+  if (cluster < 0)
+    {
+      return avail;
+    }
+
+  avail += (ncontig - 1) * fs->fs_fatsecperclus;
+
+  /* Extend the chain of a write past the end of the file while the new
+   * clusters follow the last one.  A cluster that does not is still linked
+   * and will be used by the next transfer.
+   */
+
+  while (!read && avail < nsectors && index + ncontig >= num_clu)
+    {
+      next = fat_extendchain(fs, cluster + ncontig - 1);
+      if (next != cluster + ncontig ||
+          fat_extentmap_cluster(fs, ff, index + ncontig, NULL) < 0)
+        {
+          break;
+        }
+
+      ncontig++;
+      avail += fs->fs_fatsecperclus;
+    }
+#endif
+
+  return MIN(avail, nsectors);
+}
+
+/****************************************************************************
+ * Name: fat_skip_sectors
+ *
+ * Description:
+ *   Advance the current sector past 'nsectors' contiguous sectors that
+ *   have been transferred directly, which may have crossed into the
+ *   following clusters.
+ *
+ ****************************************************************************/
+
+static void fat_skip_sectors(FAR struct fat_mountpt_s *fs,
+                             FAR struct fat_file_s *ff,
+                             unsigned int nsectors)
+{
+  unsigned int total = fs->fs_fatsecperclus - ff->ff_sectorsincluster +
+                       nsectors;
+  unsigned int crossed = (total - 1) / fs->fs_fatsecperclus;
+
+  /* The clusters crossed are contiguous like the sectors */
+
+  ff->ff_currentcluster   += crossed;
+  ff->ff_pos              += (off_t)crossed * fs->fs_fatsecperclus *
+                             fs->fs_hwsectorsize;
+  ff->ff_sectorsincluster  = (crossed + 1) * fs->fs_fatsecperclus - total;
+  ff->ff_currentsector    += nsectors;
+}
+#endif /* CONFIG_FAT_FORCE_INDIRECT */
+
 /****************************************************************************
  * Name: fat_read
  ****************************************************************************/
@@ -864,13 +996,10 @@ fat_read_restart:
            *
            * Limit the number of sectors that we read on this time
            * through the loop to the remaining contiguous sectors
-           * in this cluster
+           * in this cluster (or run of clusters)
            */
 
-          if (nsectors > ff->ff_sectorsincluster)
-            {
-              nsectors = ff->ff_sectorsincluster;
-            }
+          nsectors = fat_contig_sectors(filep, nsectors, true);
 
           /* We are not sure of the state of the file buffer so
            * the safest thing to do is just invalidate it
@@ -904,9 +1033,8 @@ fat_read_restart:
               goto errout_with_lock;
             }
 
-          ff->ff_sectorsincluster -= nsectors;
-          ff->ff_currentsector    += nsectors;
-          bytesread                = nsectors * fs->fs_hwsectorsize;
+          fat_skip_sectors(fs, ff, nsectors);
+          bytesread = nsectors * fs->fs_hwsectorsize;
         }
       else
 #endif /* CONFIG_FAT_FORCE_INDIRECT */
@@ -1062,13 +1190,10 @@ fat_write_restart:
            *
            * Limit the number of sectors that we write on this time
            * through the loop to the remaining contiguous sectors
-           * in this cluster
+           * in this cluster (or run of clusters)
            */
 
-          if (nsectors > ff->ff_sectorsincluster)
-            {
-              nsectors = ff->ff_sectorsincluster;
-            }
+          nsectors = fat_contig_sectors(filep, nsectors, false);
 
           /* We are not sure of the state of the sector cache so the
            * safest thing to do is write back any dirty, cached sector
@@ -1103,10 +1228,9 @@ fat_write_restart:
               goto errout_with_lock;
             }
 
-          ff->ff_sectorsincluster -= nsectors;
-          ff->ff_currentsector    += nsectors;
-          writesize                = nsectors * fs->fs_hwsectorsize;
-          ff->ff_bflags           |= FFBUFF_MODIFIED;
+          fat_skip_sectors(fs, ff, nsectors);
+          writesize      = nsectors * fs->fs_hwsectorsize;
+          ff->ff_bflags |= FFBUFF_MODIFIED;
         }
       else
 #endif /* CONFIG_FAT_FORCE_INDIRECT */
@@ -1594,6 +1718,11 @@ static int fat_dup(FAR const struct file *oldp, FAR struct file *newp)
   newff->ff_startcluster     = oldff->ff_startcluster;     /* Start cluster of file on media */
   newff->ff_currentsector    = oldff->ff_currentsector;    /* Current sector */
   newff->ff_cachesector      = 0;                          /* Sector in file buffer */
+#ifdef CONFIG_FAT_EXTENT_MAP
+  newff->ff_extents          = NULL;                       /* Extent map */
+  newff->ff_nextents         = 0;
+  newff->ff_maxextents       = 0;
+#endif
 
   /* Attach the private date to the struct file instance */
 
@@ -1834,6 +1963,9 @@ static int fat_truncate(FAR struct file *filep, off_t length)
   FAR struct inode *inode;
   FAR struct fat_mountpt_s *fs;
   FAR struct fat_file_s *ff;
+#ifdef CONFIG_FAT_EXTENT_MAP
+  FAR struct fat_file_s *currff;
+#endif
   off_t oldsize;
   int ret;
 
@@ -1935,6 +2067,21 @@ static int fat_truncate(FAR struct file *filep, off_t length)
           ff->ff_size = length;
           ret = OK;
         }
+
+#ifdef CONFIG_FAT_EXTENT_MAP
+      /* The clusters released may be in the extent map of any opened
+       * instance of the file.
+       */
+
+      for (currff = fs->fs_head; currff; currff = currff->ff_next)
+        {
+          if (currff->ff_dirsector == ff->ff_dirsector &&
+              currff->ff_dirindex == ff->ff_dirindex)
+            {
+              fat_extentmap_reset(currff);
+            }
+        }
+#endif
     }
   else
     {
@@ -2353,6 +2500,14 @@ static int fat_unbind(FAR void *handle, FAR struct inode **blkdriver,
       fat_io_free(fs->fs_buffer, fs->fs_hwsectorsize);
     }
 
+#if CONFIG_FAT_FATCACHE_SECTORS > 0
+  if (fs->fs_fatbuffer)
+    {
+      fat_io_free(fs->fs_fatbuffer,
+                  CONFIG_FAT_FATCACHE_SECTORS * fs->fs_hwsectorsize);
+    }
+#endif
+
   nxmutex_destroy(&fs->fs_lock);
   fs_heap_free(fs);
   return OK;
@@ -270,6 +270,12 @@
 
 #define CLUS_NDXMASK(f)     ((f)->fs_fatsecperclus - 1)
 
+/* Number of sectors in the FAT table cache */
+
+#ifndef CONFIG_FAT_FATCACHE_SECTORS
+#  define CONFIG_FAT_FATCACHE_SECTORS 0
+#endif
+
 /* The FAT "long" file name (LFN) directory entry */
 
 #ifdef CONFIG_FAT_LFN
@@ -860,6 +866,16 @@
  * is mounted with a fat32 filesystem.
  */
 
+/* A sector of the FAT held in the FAT table cache */
+
+#if CONFIG_FAT_FATCACHE_SECTORS > 0
+struct fat_fatcache_s
+{
+  off_t    fc_sector;              /* The cached FAT sector, 0 if none */
+  bool     fc_dirty;               /* true: The sector must be written back */
+};
+#endif
+
 struct fat_file_s;
 struct fat_mountpt_s
 {
@@ -889,8 +905,23 @@ struct fat_mountpt_s
   uint8_t  fs_fatsecperclus;       /* MBR: Sectors per allocation unit: 2**n, n=0..7 */
   uint8_t *fs_buffer;              /* This is an allocated buffer to hold one
                                     * sector from the device */
+#if CONFIG_FAT_FATCACHE_SECTORS > 0
+  uint8_t *fs_fatbuffer;           /* Buffer of the FAT table cache */
+  struct fat_fatcache_s fs_fatcache[CONFIG_FAT_FATCACHE_SECTORS];
+#endif
 };
 
+/* A run of contiguous clusters of a file */
+
+#ifdef CONFIG_FAT_EXTENT_MAP
+struct fat_extent_s
+{
+  uint32_t fe_index;               /* Index of its first cluster in file */
+  uint32_t fe_cluster;             /* First cluster of the run on the media */
+  uint32_t fe_count;               /* Number of clusters in the run */
+};
+#endif
+
 /* This structure represents on open file under the mountpoint.  An instance
  * of this structure is retained as struct file specific information on each
  * opened file.
@@ -911,6 +942,11 @@ struct fat_file_s
   off_t    ff_cachesector;         /* Current sector in the file buffer */
   off_t    ff_pos;                 /* Current position in the file */
   uint8_t *ff_buffer;              /* File buffer (for partial sector accesses) */
+#ifdef CONFIG_FAT_EXTENT_MAP
+  FAR struct fat_extent_s *ff_extents; /* Extents of the chain visited */
+  uint32_t ff_nextents;            /* Number of extents in the map */
+  uint32_t ff_maxextents;          /* Number of extents allocated */
+#endif
 };
 
 /* This structure holds the sequence of directory entries used by one
@@ -1053,6 +1089,16 @@ EXTERN int32_t fat_extendchain(FAR struct fat_mountpt_s *fs,
 
 #define fat_createchain(fs) fat_extendchain(fs, 0)
 
+/* Cluster extent map of an opened file */
+
+#ifdef CONFIG_FAT_EXTENT_MAP
+EXTERN off_t  fat_extentmap_cluster(FAR struct fat_mountpt_s *fs,
+                                    FAR struct fat_file_s *ff,
+                                    uint32_t index, FAR uint32_t *ncontig);
+EXTERN void   fat_extentmap_reset(FAR struct fat_file_s *ff);
+EXTERN void   fat_extentmap_free(FAR struct fat_file_s *ff);
+#endif
+
 /* Help for traversing directory trees and accessing directory entries */
 
 EXTERN int    fat_nextdirentry(FAR struct fat_mountpt_s *fs,
@@ -1091,6 +1137,9 @@ EXTERN int    fat_remove(FAR struct fat_mountpt_s *fs,
 
 EXTERN int    fat_fscacheflush(FAR struct fat_mountpt_s *fs);
 EXTERN int    fat_fscacheread(FAR struct fat_mountpt_s *fs, off_t sector);
+#if CONFIG_FAT_FATCACHE_SECTORS > 0
+EXTERN int    fat_fatcacheflush(FAR struct fat_mountpt_s *fs);
+#endif
 EXTERN int    fat_ffcacheflush(FAR struct fat_mountpt_s *fs,
                                FAR struct fat_file_s *ff);
 EXTERN int    fat_ffcacheread(FAR struct fat_mountpt_s *fs,
@@ -263,6 +263,178 @@ static int fat_checkbootrecord(struct fat_mountpt_s *fs)
   return OK;
 }
 
+/****************************************************************************
+ * Name: fat_fatcachewrite
+ *
+ * Description:
+ *   Write 'nsectors' consecutive FAT sectors held in the FAT table cache,
+ *   starting at slot 'index', to every copy of the FAT.
+ *
+ ****************************************************************************/
+
+#if CONFIG_FAT_FATCACHE_SECTORS > 0
+static int fat_fatcachewrite(FAR struct fat_mountpt_s *fs, int index,
+                             unsigned int nsectors)
+{
+  FAR uint8_t *buffer = &fs->fs_fatbuffer[index * fs->fs_hwsectorsize];
+  off_t sector = fs->fs_fatcache[index].fc_sector;
+  unsigned int i;
+  int ret;
+
+  for (i = 0; i < fs->fs_fatnumfats; i++)
+    {
+      ret = fat_hwwrite(fs, buffer, sector, nsectors);
+      if (ret < 0)
+        {
+          return ret;
+        }
+
+      sector += fs->fs_nfatsects;
+    }
+
+  for (i = 0; i < nsectors; i++)
+    {
+      fs->fs_fatcache[index + i].fc_dirty = false;
+    }
+
+  return OK;
+}
+#endif
+
+/****************************************************************************
+ * Name: fat_fatread
+ *
+ * Description:
+ *   Return the buffer holding the FAT sector 'sector', reading it from the
+ *   media as necessary.  If 'modify' is true, the sector is marked dirty
+ *   so that it is written back to every copy of the FAT.
+ *
+ *   With the FAT table cache, the sectors are direct-mapped to the slots
+ *   of the cache.  A miss also reads ahead the following sectors of the
+ *   FAT into the following slots, in the same request, up to the end of
+ *   the cache or the first slot holding a modified sector.  Without it,
+ *   the FAT shares fs_buffer with the directory entries.
+ *
+ ****************************************************************************/
+
+static int fat_fatread(FAR struct fat_mountpt_s *fs, off_t sector,
+                       bool modify, FAR uint8_t **buffer)
+{
+#if CONFIG_FAT_FATCACHE_SECTORS > 0
+  FAR struct fat_fatcache_s *slot;
+  off_t fatend = fs->fs_fatbase + fs->fs_nfatsects;
+  unsigned int nsectors;
+  int index;
+  int ret;
+
+  index = (sector - fs->fs_fatbase) % CONFIG_FAT_FATCACHE_SECTORS;
+  slot  = &fs->fs_fatcache[index];
+
+  if (slot->fc_sector != sector)
+    {
+      /* Write back the sector evicted from the slot */
+
+      if (slot->fc_dirty)
+        {
+          ret = fat_fatcachewrite(fs, index, 1);
+          if (ret < 0)
+            {
+              return ret;
+            }
+        }
+
+      for (nsectors = 1;
+           index + nsectors < CONFIG_FAT_FATCACHE_SECTORS &&
+           sector + nsectors < fatend &&
+           !slot[nsectors].fc_dirty;
+           nsectors++);
+
+      ret = fat_hwread(fs, &fs->fs_fatbuffer[index * fs->fs_hwsectorsize],
+                       sector, nsectors);
+      if (ret < 0)
+        {
+          /* The content of the slots is unknown */
+
+          while (nsectors-- > 0)
+            {
+              slot[nsectors].fc_sector = 0;
+            }
+
+          return ret;
+        }
+
+      while (nsectors-- > 0)
+        {
+          slot[nsectors].fc_sector = sector + nsectors;
+        }
+    }
+
+  slot->fc_dirty |= modify;
+  *buffer = &fs->fs_fatbuffer[index * fs->fs_hwsectorsize];
+  return OK;
+#else
+  int ret;
+
+  ret = fat_fscacheread(fs, sector);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  fs->fs_dirty |= modify;
+  *buffer = fs->fs_buffer;
+  return OK;
+#endif
+}
+
+/****************************************************************************
+ * Name: fat_extentmap_add
+ *
+ * Description:
+ *   Add the cluster at 'index' in the file, which follows the last cluster
+ *   in the map, to the cluster extent map.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FAT_EXTENT_MAP
+static int fat_extentmap_add(FAR struct fat_file_s *ff, uint32_t index,
+                             uint32_t cluster)
+{
+  FAR struct fat_extent_s *extent;
+
+  if (ff->ff_nextents > 0)
+    {
+      extent = &ff->ff_extents[ff->ff_nextents - 1];
+      if (extent->fe_cluster + extent->fe_count == cluster)
+        {
+          extent->fe_count++;
+          return OK;
+        }
+    }
+
+  if (ff->ff_nextents >= ff->ff_maxextents)
+    {
+      uint32_t maxextents = ff->ff_maxextents ? 2 * ff->ff_maxextents : 4;
+
+      extent = fs_heap_realloc(ff->ff_extents,
+                               maxextents * sizeof(struct fat_extent_s));
+      if (extent == NULL)
+        {
+          return -ENOMEM;
+        }
+
+      ff->ff_extents    = extent;
+      ff->ff_maxextents = maxextents;
+    }
+
+  extent             = &ff->ff_extents[ff->ff_nextents++];
+  extent->fe_index   = index;
+  extent->fe_cluster = cluster;
+  extent->fe_count   = 1;
+  return OK;
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -513,6 +685,18 @@ int fat_mount(struct fat_mountpt_s *fs, bool writeable)
       goto errout;
     }
 
+#if CONFIG_FAT_FATCACHE_SECTORS > 0
+  /* Allocate the buffer of the FAT table cache */
+
+  fs->fs_fatbuffer = (FAR uint8_t *)
+    fat_io_alloc(CONFIG_FAT_FATCACHE_SECTORS * fs->fs_hwsectorsize);
+  if (!fs->fs_fatbuffer)
+    {
+      ret = -ENOMEM;
+      goto errout_with_buffer;
+    }
+#endif
+
   /* Search FAT boot record on the drive.  First check the MBR at sector
    * zero.  This could be either the boot record or a partition that refers
    * to the boot record.
@@ -651,6 +835,15 @@ int fat_mount(struct fat_mountpt_s *fs, bool writeable)
   return OK;
 
 errout_with_buffer:
+#if CONFIG_FAT_FATCACHE_SECTORS > 0
+  if (fs->fs_fatbuffer)
+    {
+      fat_io_free(fs->fs_fatbuffer,
+                  CONFIG_FAT_FATCACHE_SECTORS * fs->fs_hwsectorsize);
+      fs->fs_fatbuffer = NULL;
+    }
+#endif
+
   fat_io_free(fs->fs_buffer, fs->fs_hwsectorsize);
   fs->fs_buffer = NULL;
 
@@ -815,6 +1008,7 @@ off_t fat_getcluster(struct fat_mountpt_s *fs, uint32_t clusterno)
         {
           case FSTYPE_FAT12 :
             {
+              FAR uint8_t  *fatbuffer;
               off_t        fatsector;
               unsigned int fatoffset;
               unsigned int cluster;
@@ -829,7 +1023,7 @@ off_t fat_getcluster(struct fat_mountpt_s *fs, uint32_t clusterno)
 
               /* Read the sector at this offset */
 
-              if (fat_fscacheread(fs, fatsector) < 0)
+              if (fat_fatread(fs, fatsector, false, &fatbuffer) < 0)
                 {
                   /* Read error */
 
@@ -839,7 +1033,7 @@ off_t fat_getcluster(struct fat_mountpt_s *fs, uint32_t clusterno)
               /* Get the first, LS byte of the cluster from the FAT */
 
               fatindex = fatoffset & SEC_NDXMASK(fs);
-              cluster  = fs->fs_buffer[fatindex];
+              cluster  = fatbuffer[fatindex];
 
               /* With FAT12, the second byte of the cluster number may lie in
                * a different sector than the first byte.
@@ -851,7 +1045,7 @@ off_t fat_getcluster(struct fat_mountpt_s *fs, uint32_t clusterno)
                   fatsector++;
                   fatindex = 0;
 
-                  if (fat_fscacheread(fs, fatsector) < 0)
+                  if (fat_fatread(fs, fatsector, false, &fatbuffer) < 0)
                     {
                       /* Read error */
 
@@ -864,7 +1058,7 @@ off_t fat_getcluster(struct fat_mountpt_s *fs, uint32_t clusterno)
                * on the fact that the byte stream is little-endian.
                */
 
-              cluster |= (unsigned int)fs->fs_buffer[fatindex] << 8;
+              cluster |= (unsigned int)fatbuffer[fatindex] << 8;
 
               /* Now, pick out the correct 12 bit cluster start sector
                * value.
@@ -894,15 +1088,16 @@ off_t fat_getcluster(struct fat_mountpt_s *fs, uint32_t clusterno)
               off_t        fatsector = fs->fs_fatbase +
                                        SEC_NSECTORS(fs, fatoffset);
               unsigned int fatindex  = fatoffset & SEC_NDXMASK(fs);
+              FAR uint8_t  *fatbuffer;
 
-              if (fat_fscacheread(fs, fatsector) < 0)
+              if (fat_fatread(fs, fatsector, false, &fatbuffer) < 0)
                 {
                   /* Read error */
 
                   break;
                 }
 
-              return FAT_GETFAT16(fs->fs_buffer, fatindex);
+              return FAT_GETFAT16(fatbuffer, fatindex);
             }
 
           case FSTYPE_FAT32 :
@@ -913,15 +1108,16 @@ off_t fat_getcluster(struct fat_mountpt_s *fs, uint32_t clusterno)
               off_t        fatsector = fs->fs_fatbase +
                                        SEC_NSECTORS(fs, fatoffset);
               unsigned int fatindex  = fatoffset & SEC_NDXMASK(fs);
+              FAR uint8_t  *fatbuffer;
 
-              if (fat_fscacheread(fs, fatsector) < 0)
+              if (fat_fatread(fs, fatsector, false, &fatbuffer) < 0)
                 {
                   /* Read error */
 
                   break;
                 }
 
-              return FAT_GETFAT32(fs->fs_buffer, fatindex) & 0x0fffffff;
+              return FAT_GETFAT32(fatbuffer, fatindex) & 0x0fffffff;
             }
 
           default:
@@ -959,6 +1155,7 @@ int fat_putcluster(struct fat_mountpt_s *fs, uint32_t clusterno,
         {
           case FSTYPE_FAT12 :
             {
+              FAR uint8_t  *fatbuffer;
               off_t        fatsector;
               unsigned int fatoffset;
               unsigned int fatindex;
@@ -973,7 +1170,7 @@ int fat_putcluster(struct fat_mountpt_s *fs, uint32_t clusterno,
 
               /* Make sure that the sector at this offset is in the cache */
 
-              if (fat_fscacheread(fs, fatsector) < 0)
+              if (fat_fatread(fs, fatsector, true, &fatbuffer) < 0)
                 {
                   /* Read error */
 
@@ -989,7 +1186,7 @@ int fat_putcluster(struct fat_mountpt_s *fs, uint32_t clusterno,
                 {
                   /* Save the LS four bits of the next cluster */
 
-                  value = (fs->fs_buffer[fatindex] & 0x0f) |
+                  value = (fatbuffer[fatindex] & 0x0f) |
                            (uint8_t)nextcluster << 4;
                 }
               else
@@ -999,7 +1196,7 @@ int fat_putcluster(struct fat_mountpt_s *fs, uint32_t clusterno,
                   value = (uint8_t)nextcluster;
                 }
 
-              fs->fs_buffer[fatindex] = value;
+              fatbuffer[fatindex] = value;
 
               /* With FAT12, the second byte of the cluster number may lie in
                * a different sector than the first byte.
@@ -1008,17 +1205,14 @@ int fat_putcluster(struct fat_mountpt_s *fs, uint32_t clusterno,
               fatindex++;
               if (fatindex >= fs->fs_hwsectorsize)
                 {
-                  /* Read the next sector */
+                  /* Read the next sector.  The sector that we just modified
+                   * is already marked dirty.
+                   */
 
                   fatsector++;
                   fatindex = 0;
 
-                  /* Set the dirty flag to make sure the sector that we
-                   * just modified is written out.
-                   */
-
-                  fs->fs_dirty = true;
-                  if (fat_fscacheread(fs, fatsector) < 0)
+                  if (fat_fatread(fs, fatsector, true, &fatbuffer) < 0)
                     {
                       /* Read error */
 
@@ -1040,11 +1234,11 @@ int fat_putcluster(struct fat_mountpt_s *fs, uint32_t clusterno,
                 {
                   /* Save the MS four bits of the next cluster */
 
-                  value = (fs->fs_buffer[fatindex] & 0xf0) |
+                  value = (fatbuffer[fatindex] & 0xf0) |
                           ((nextcluster >> 8) & 0x0f);
                 }
 
-              fs->fs_buffer[fatindex] = value;
+              fatbuffer[fatindex] = value;
             }
           break;
 
@@ -1054,15 +1248,16 @@ int fat_putcluster(struct fat_mountpt_s *fs, uint32_t clusterno,
               off_t        fatsector = fs->fs_fatbase +
                                        SEC_NSECTORS(fs, fatoffset);
               unsigned int fatindex  = fatoffset & SEC_NDXMASK(fs);
+              FAR uint8_t  *fatbuffer;
 
-              if (fat_fscacheread(fs, fatsector) < 0)
+              if (fat_fatread(fs, fatsector, true, &fatbuffer) < 0)
                 {
                   /* Read error */
 
                   break;
                 }
 
-              FAT_PUTFAT16(fs->fs_buffer, fatindex, nextcluster & 0xffff);
+              FAT_PUTFAT16(fatbuffer, fatindex, nextcluster & 0xffff);
             }
           break;
 
@@ -1072,9 +1267,10 @@ int fat_putcluster(struct fat_mountpt_s *fs, uint32_t clusterno,
               off_t        fatsector = fs->fs_fatbase +
                                        SEC_NSECTORS(fs, fatoffset);
               unsigned int fatindex  = fatoffset & SEC_NDXMASK(fs);
+              FAR uint8_t  *fatbuffer;
               uint32_t     val;
 
-              if (fat_fscacheread(fs, fatsector) < 0)
+              if (fat_fatread(fs, fatsector, true, &fatbuffer) < 0)
                 {
                   /* Read error */
 
@@ -1083,8 +1279,8 @@ int fat_putcluster(struct fat_mountpt_s *fs, uint32_t clusterno,
 
               /* Keep the top 4 bits */
 
-              val = FAT_GETFAT32(fs->fs_buffer, fatindex) & 0xf0000000;
-              FAT_PUTFAT32(fs->fs_buffer, fatindex,
+              val = FAT_GETFAT32(fatbuffer, fatindex) & 0xf0000000;
+              FAT_PUTFAT32(fatbuffer, fatindex,
                            val | (nextcluster & 0x0fffffff));
             }
           break;
@@ -1093,9 +1289,8 @@ int fat_putcluster(struct fat_mountpt_s *fs, uint32_t clusterno,
             return -EINVAL;
         }
 
-      /* Mark the modified sector as "dirty" and return success */
+      /* The modified sector was marked "dirty" when it was read */
 
-      fs->fs_dirty = true;
       return OK;
     }
 
@@ -1316,6 +1511,127 @@ int32_t fat_extendchain(struct fat_mountpt_s *fs, uint32_t cluster)
   return newcluster;
 }
 
+#ifdef CONFIG_FAT_EXTENT_MAP
+/****************************************************************************
+ * Name: fat_extentmap_cluster
+ *
+ * Description:
+ *   Return the cluster at 'index' in the cluster chain of a file.  The
+ *   part of the chain already visited is looked up in the extent map of the
+ *   file, only the part beyond it is walked (and added to the map).  The
+ *   chain must have at least index + 1 clusters.
+ *
+ *   If 'ncontig' is not NULL, it receives the number of contiguous
+ *   clusters in the map starting at 'index'.
+ *
+ * Returned Value:
+ *   <0: error, >=2: the cluster number.  -ENOMEM is returned if the map
+ *   cannot grow, in which case the caller may still walk the chain.
+ *
+ ****************************************************************************/
+
+off_t fat_extentmap_cluster(FAR struct fat_mountpt_s *fs,
+                            FAR struct fat_file_s *ff,
+                            uint32_t index, FAR uint32_t *ncontig)
+{
+  FAR struct fat_extent_s *extent;
+  uint32_t mapped;
+  off_t cluster;
+  int lo;
+  int hi;
+  int ret;
+
+  if (ff->ff_nextents == 0)
+    {
+      ret = fat_extentmap_add(ff, 0, ff->ff_startcluster);
+      if (ret < 0)
+        {
+          return ret;
+        }
+    }
+
+  /* Walk the part of the chain that is not mapped yet */
+
+  extent  = &ff->ff_extents[ff->ff_nextents - 1];
+  mapped  = extent->fe_index + extent->fe_count;
+  cluster = extent->fe_cluster + extent->fe_count - 1;
+
+  for (; mapped <= index; mapped++)
+    {
+      cluster = fat_getcluster(fs, cluster);
+      if (cluster < 2 || cluster >= fs->fs_nclusters + 2)
+        {
+          return -EIO;
+        }
+
+      ret = fat_extentmap_add(ff, mapped, cluster);
+      if (ret < 0)
+        {
+          return ret;
+        }
+    }
+
+  /* Find the last extent starting at or before the index */
+
+  lo = 0;
+  hi = ff->ff_nextents - 1;
+  while (lo < hi)
+    {
+      int mid = (lo + hi + 1) / 2;
+
+      if (ff->ff_extents[mid].fe_index <= index)
+        {
+          lo = mid;
+        }
+      else
+        {
+          hi = mid - 1;
+        }
+    }
+
+  extent = &ff->ff_extents[lo];
+  if (ncontig != NULL)
+    {
+      *ncontig = extent->fe_index + extent->fe_count - index;
+    }
+
+  return extent->fe_cluster + (index - extent->fe_index);
+}
+
+/****************************************************************************
+ * Name: fat_extentmap_reset
+ *
+ * Description:
+ *   Forget the cluster extent map of a file whose chain has been shrunk.
+ *
+ ****************************************************************************/
+
+void fat_extentmap_reset(FAR struct fat_file_s *ff)
+{
+  ff->ff_nextents = 0;
+}
+
+/****************************************************************************
+ * Name: fat_extentmap_free
+ *
+ * Description:
+ *   Release the cluster extent map of a file.
+ *
+ ****************************************************************************/
+
+void fat_extentmap_free(FAR struct fat_file_s *ff)
+{
+  if (ff->ff_extents != NULL)
+    {
+      fs_heap_free(ff->ff_extents);
+      ff->ff_extents = NULL;
+    }
+
+  ff->ff_nextents   = 0;
+  ff->ff_maxextents = 0;
+}
+#endif
+
 /****************************************************************************
  * Name: fat_nextdirentry
  *
@@ -1755,7 +2071,8 @@ int fat_dirextend(FAR struct fat_mountpt_s *fs, FAR struct fat_file_s *ff,
  * Name: fat_fscacheflush
  *
  * Description:
- *   Flush any dirty sector if fs_buffer as necessary
+ *   Flush any dirty sector if fs_buffer as necessary, and any dirty sector
+ *   of the FAT table cache.
  *
  ****************************************************************************/
 
@@ -1802,8 +2119,58 @@ int fat_fscacheflush(struct fat_mountpt_s *fs)
       fs->fs_dirty = false;
     }
 
+#if CONFIG_FAT_FATCACHE_SECTORS > 0
+  /* Write back the FAT along with the directory entries, as when the FAT
+   * shares fs_buffer with them.
+   */
+
+  return fat_fatcacheflush(fs);
+#else
+  return OK;
+#endif
+}
+
+/****************************************************************************
+ * Name: fat_fatcacheflush
+ *
+ * Description:
+ *   Write back the modified sectors of the FAT table cache.  Runs of
+ *   consecutive sectors are written with a single request per FAT copy.
+ *
+ ****************************************************************************/
+
+#if CONFIG_FAT_FATCACHE_SECTORS > 0
+int fat_fatcacheflush(FAR struct fat_mountpt_s *fs)
+{
+  FAR struct fat_fatcache_s *slot = fs->fs_fatcache;
+  int start;
+  int end;
+  int ret;
+
+  for (start = 0; start < CONFIG_FAT_FATCACHE_SECTORS; start = end)
+    {
+      end = start + 1;
+      if (!slot[start].fc_dirty)
+        {
+          continue;
+        }
+
+      while (end < CONFIG_FAT_FATCACHE_SECTORS && slot[end].fc_dirty &&
+             slot[end].fc_sector == slot[start].fc_sector + end - start)
+        {
+          end++;
+        }
+
+      ret = fat_fatcachewrite(fs, start, end - start);
+      if (ret < 0)
+        {
+          return ret;
+        }
+    }
+
   return OK;
 }
+#endif
 
 /****************************************************************************
  * Name: fat_fscacheread
@@ -2051,6 +2418,7 @@ int fat_computefreeclusters(struct fat_mountpt_s *fs)
     }
   else
     {
+      FAR uint8_t  *fatbuffer = NULL;
       unsigned int cluster;
       off_t        fatsector;
       unsigned int offset;
@@ -2063,13 +2431,11 @@ int fat_computefreeclusters(struct fat_mountpt_s *fs)
 
       for (cluster = fs->fs_nclusters; cluster > 0; cluster--)
         {
-          /* If we are starting a new sector, then read the new sector in
-           * fs_buffer
-           */
+          /* If we are starting a new sector, then read the new sector */
 
           if (offset >= fs->fs_hwsectorsize)
             {
-              ret = fat_fscacheread(fs, fatsector);
+              ret = fat_fatread(fs, fatsector, false, &fatbuffer);
               if (ret < 0)
                 {
                   return ret;
@@ -2089,7 +2455,7 @@ int fat_computefreeclusters(struct fat_mountpt_s *fs)
 
           if (fs->fs_type == FSTYPE_FAT16)
             {
-              if (FAT_GETFAT16(fs->fs_buffer, offset) == 0)
+              if (FAT_GETFAT16(fatbuffer, offset) == 0)
                 {
                   nfreeclusters++;
                 }
@@ -2098,7 +2464,7 @@ int fat_computefreeclusters(struct fat_mountpt_s *fs)
             }
           else
             {
-              if (FAT_GETFAT32(fs->fs_buffer, offset) == 0)
+              if (FAT_GETFAT32(fatbuffer, offset) == 0)
                 {
                   nfreeclusters++;
                 }
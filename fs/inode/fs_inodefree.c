@@ -51,6 +51,10 @@ void inode_free(FAR struct inode *node)
 
   if (node != NULL)
     {
+      /* The children of an unlinked inode are still indexed */
+
+      inode_hashdel(node);
+
 #ifdef CONFIG_PSEUDOFS_SOFTLINKS
       /* Symbol links should never have peers or children */
 
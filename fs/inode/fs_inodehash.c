@@ -0,0 +1,405 @@
+/****************************************************************************
+ * fs/inode/fs_inodehash.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <string.h>
+#include <assert.h>
+#include <errno.h>
+
+#include <nuttx/spinlock.h>
+#include <nuttx/fs/fs.h>
+
+#include "inode/inode.h"
+
+#if CONFIG_PSEUDOFS_HASHSIZE > 0 || CONFIG_PSEUDOFS_PATHCACHE > 0
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#if CONFIG_PSEUDOFS_HASHSIZE & (CONFIG_PSEUDOFS_HASHSIZE - 1)
+#  error CONFIG_PSEUDOFS_HASHSIZE must be a power of two
+#endif
+
+#if CONFIG_PSEUDOFS_PATHCACHE & (CONFIG_PSEUDOFS_PATHCACHE - 1)
+#  error CONFIG_PSEUDOFS_PATHCACHE must be a power of two
+#endif
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+#if CONFIG_PSEUDOFS_PATHCACHE > 0
+struct inode_pathcache_s
+{
+  FAR struct inode *node;                     /* The inode of the path */
+  uint32_t          gen;                      /* Generation of the entry */
+  char              path[CONFIG_PSEUDOFS_PATHCACHE_LEN];
+};
+#endif
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+#if CONFIG_PSEUDOFS_HASHSIZE > 0
+/* The buckets are only modified with the inode lock held for writing, so
+ * readers of the inode tree may walk them concurrently.
+ */
+
+static FAR struct inode *g_inode_hash[CONFIG_PSEUDOFS_HASHSIZE];
+#endif
+
+#if CONFIG_PSEUDOFS_PATHCACHE > 0
+/* The path cache is filled by the readers of the inode tree, hence its own
+ * lock.  An entry is only valid if it was recorded in the current
+ * generation, which changes with every modification of the tree.
+ */
+
+static struct inode_pathcache_s g_inode_pathcache[CONFIG_PSEUDOFS_PATHCACHE];
+static spinlock_t g_inode_pathlock = SP_UNLOCKED;
+static uint32_t g_inode_generation = 1;
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+#if CONFIG_PSEUDOFS_HASHSIZE > 0
+
+/****************************************************************************
+ * Name: inode_strhash
+ *
+ * Description:
+ *   FNV-1a hash of a path segment, terminated by '/' or NUL.
+ *
+ ****************************************************************************/
+
+static uint32_t inode_strhash(uint32_t hash, FAR const char *name)
+{
+  for (; *name != '\0' && *name != '/'; name++)
+    {
+      hash = (hash ^ (uint8_t)*name) * 16777619u;
+    }
+
+  return hash;
+}
+
+/****************************************************************************
+ * Name: inode_bucket
+ ****************************************************************************/
+
+static FAR struct inode **inode_bucket(FAR const struct inode *parent,
+                                       FAR const char *name)
+{
+  uint32_t hash = 2166136261u ^ (uint32_t)((uintptr_t)parent >> 2);
+
+  hash = inode_strhash(hash, name);
+  return &g_inode_hash[hash & (CONFIG_PSEUDOFS_HASHSIZE - 1)];
+}
+
+/****************************************************************************
+ * Name: inode_hashunlink
+ *
+ * Description:
+ *   Remove an inode from the bucket of its current parent, if it is there.
+ *
+ ****************************************************************************/
+
+static void inode_hashunlink(FAR struct inode *node)
+{
+  FAR struct inode **link = inode_bucket(node->i_parent, node->i_name);
+
+  for (; *link != NULL; link = &(*link)->i_hash)
+    {
+      if (*link == node)
+        {
+          *link = node->i_hash;
+          node->i_hash = NULL;
+          break;
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: inode_hashlink
+ ****************************************************************************/
+
+static void inode_hashlink(FAR struct inode *node)
+{
+  FAR struct inode **link = inode_bucket(node->i_parent, node->i_name);
+
+  node->i_hash = *link;
+  *link        = node;
+}
+
+#endif /* CONFIG_PSEUDOFS_HASHSIZE > 0 */
+
+#if CONFIG_PSEUDOFS_PATHCACHE > 0
+
+/****************************************************************************
+ * Name: inode_pathcache_entry
+ ****************************************************************************/
+
+static FAR struct inode_pathcache_s *
+inode_pathcache_entry(FAR const char *path)
+{
+  uint32_t hash = 2166136261u;
+
+  /* Hash all the segments of the path, including the separators */
+
+  for (; *path != '\0'; path++)
+    {
+      hash = (hash ^ (uint8_t)*path) * 16777619u;
+    }
+
+  return &g_inode_pathcache[hash & (CONFIG_PSEUDOFS_PATHCACHE - 1)];
+}
+
+/****************************************************************************
+ * Name: inode_pathmatch
+ *
+ * Description:
+ *   Check that the names of the inode and of its ancestors spell out the
+ *   path exactly.  This rejects the paths that went through soft links or
+ *   that were not in canonical form.
+ *
+ ****************************************************************************/
+
+static bool inode_pathmatch(FAR struct inode *node, FAR const char *path,
+                            size_t len)
+{
+  FAR const char *end = path + len;
+  size_t namelen;
+
+  for (; node != g_root_inode; node = node->i_parent)
+    {
+      if (node == NULL)
+        {
+          return false;
+        }
+
+      namelen = strlen(node->i_name);
+      if ((size_t)(end - path) < namelen + 1 || end[-namelen - 1] != '/' ||
+          memcmp(end - namelen, node->i_name, namelen) != 0)
+        {
+          return false;
+        }
+
+      end -= namelen + 1;
+    }
+
+  return end == path;
+}
+
+#endif /* CONFIG_PSEUDOFS_PATHCACHE > 0 */
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: inode_hashadd
+ *
+ * Description:
+ *   Add an inode just linked into the inode tree to the children hash and
+ *   invalidate the path cache.
+ *
+ ****************************************************************************/
+
+void inode_hashadd(FAR struct inode *node)
+{
+#if CONFIG_PSEUDOFS_HASHSIZE > 0
+  DEBUGASSERT(node->i_parent != NULL);
+  inode_hashlink(node);
+#endif
+
+#if CONFIG_PSEUDOFS_PATHCACHE > 0
+  g_inode_generation++;
+#endif
+}
+
+/****************************************************************************
+ * Name: inode_hashdel
+ *
+ * Description:
+ *   Remove an inode from the children hash and invalidate the path cache.
+ *   This is called before the inode is unlinked from its parent, and again
+ *   when inodes are freed: the children of an unlinked inode stay in the
+ *   hash until then.  Unlinked inodes have no parent and are skipped.
+ *
+ ****************************************************************************/
+
+void inode_hashdel(FAR struct inode *node)
+{
+  if (node->i_parent != NULL)
+    {
+#if CONFIG_PSEUDOFS_HASHSIZE > 0
+      inode_hashunlink(node);
+#endif
+
+#if CONFIG_PSEUDOFS_PATHCACHE > 0
+      g_inode_generation++;
+#endif
+    }
+}
+
+#if CONFIG_PSEUDOFS_HASHSIZE > 0
+
+/****************************************************************************
+ * Name: inode_hashfind
+ *
+ * Description:
+ *   Look up the child of 'parent' named by the first segment of 'name'.
+ *
+ ****************************************************************************/
+
+FAR struct inode *inode_hashfind(FAR struct inode *parent,
+                                 FAR const char *name)
+{
+  FAR struct inode *node = *inode_bucket(parent, name);
+  size_t len = 0;
+
+  while (name[len] != '\0' && name[len] != '/')
+    {
+      len++;
+    }
+
+  for (; node != NULL; node = node->i_hash)
+    {
+      if (node->i_parent == parent && node->i_name[len] == '\0' &&
+          strncmp(node->i_name, name, len) == 0)
+        {
+          break;
+        }
+    }
+
+  return node;
+}
+
+/****************************************************************************
+ * Name: inode_hashmove
+ *
+ * Description:
+ *   Re-index the children of 'parent' after they were moved to it from
+ *   another inode, updating their parent link at the same time.
+ *
+ ****************************************************************************/
+
+void inode_hashmove(FAR struct inode *parent)
+{
+  FAR struct inode *node;
+
+  for (node = parent->i_child; node != NULL; node = node->i_peer)
+    {
+      inode_hashunlink(node);
+      node->i_parent = parent;
+      inode_hashlink(node);
+    }
+}
+
+#endif /* CONFIG_PSEUDOFS_HASHSIZE > 0 */
+
+#if CONFIG_PSEUDOFS_PATHCACHE > 0
+
+/****************************************************************************
+ * Name: inode_pathcache_find
+ *
+ * Description:
+ *   Look up an absolute path in the path cache.
+ *
+ * Returned Value:
+ *   OK with the search descriptor filled in on a hit, -ENOENT on a miss.
+ *
+ ****************************************************************************/
+
+int inode_pathcache_find(FAR struct inode_search_s *desc)
+{
+  FAR struct inode_pathcache_s *entry;
+  FAR struct inode *node = NULL;
+  irqstate_t flags;
+
+  entry = inode_pathcache_entry(desc->path);
+
+  flags = spin_lock_irqsave(&g_inode_pathlock);
+  if (entry->gen == g_inode_generation && entry->node != NULL &&
+      strcmp(entry->path, desc->path) == 0)
+    {
+      node = entry->node;
+    }
+
+  spin_unlock_irqrestore(&g_inode_pathlock, flags);
+
+  if (node == NULL)
+    {
+      return -ENOENT;
+    }
+
+  desc->path    += strlen(desc->path);
+  desc->node     = node;
+  desc->peer     = NULL;
+  desc->parent   = node->i_parent;
+  desc->relpath  = desc->path;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: inode_pathcache_add
+ *
+ * Description:
+ *   Record the successful search of the absolute 'path'.
+ *
+ ****************************************************************************/
+
+void inode_pathcache_add(FAR const char *path,
+                         FAR struct inode_search_s *desc)
+{
+  FAR struct inode_pathcache_s *entry;
+  FAR struct inode *node = desc->node;
+  irqstate_t flags;
+  size_t len;
+
+  len = strlen(path);
+  if (len >= CONFIG_PSEUDOFS_PATHCACHE_LEN || INODE_IS_MOUNTPT(node) ||
+      desc->relpath == NULL || *desc->relpath != '\0' ||
+      !inode_pathmatch(node, path, len))
+    {
+      return;
+    }
+
+  entry = inode_pathcache_entry(path);
+
+  flags = spin_lock_irqsave(&g_inode_pathlock);
+  entry->node = node;
+  entry->gen  = g_inode_generation;
+  memcpy(entry->path, path, len + 1);
+  spin_unlock_irqrestore(&g_inode_pathlock, flags);
+}
+
+#endif /* CONFIG_PSEUDOFS_PATHCACHE > 0 */
+#endif /* CONFIG_PSEUDOFS_HASHSIZE > 0 || CONFIG_PSEUDOFS_PATHCACHE > 0 */
@@ -77,6 +77,24 @@ static FAR struct inode *inode_unlink(FAR const char *path)
       node = desc.node;
       DEBUGASSERT(node != NULL);
 
+      inode_hashdel(node);
+
+#if CONFIG_PSEUDOFS_HASHSIZE > 0 || CONFIG_PSEUDOFS_PATHCACHE > 0
+      /* The peer is not reported when the node was found through the
+       * children hash or the path cache.
+       */
+
+      if (desc.peer == NULL && desc.parent != NULL &&
+          desc.parent->i_child != node)
+        {
+          desc.peer = desc.parent->i_child;
+          while (desc.peer->i_peer != node)
+            {
+              desc.peer = desc.peer->i_peer;
+            }
+        }
+#endif
+
       /* If peer is non-null, then remove the node from the right of
        * of that peer node.
        */
@@ -239,7 +239,27 @@ static int _inode_search(FAR struct inode_search_s *desc)
 
   while (node != NULL)
     {
-      int result = _inode_compare(name, node);
+      int result;
+
+#if CONFIG_PSEUDOFS_HASHSIZE > 0
+      /* At the head of a directory, look the name up in the children hash
+       * first.  On a miss, the ordered walk below also finds the insertion
+       * point of the name.
+       */
+
+      FAR struct inode *found;
+
+      if (above != NULL && left == NULL &&
+          (found = inode_hashfind(above, name)) != NULL)
+        {
+          node   = found;
+          result = 0;
+        }
+      else
+#endif
+        {
+          result = _inode_compare(name, node);
+        }
 
       /* Case 1:  The name is less than the name of the node.
        * Since the names are ordered, these means that there
@@ -465,6 +485,9 @@ static FAR const char *_inode_getcwd(void)
 
 int inode_search(FAR struct inode_search_s *desc)
 {
+#if CONFIG_PSEUDOFS_PATHCACHE > 0
+  FAR const char *path;
+#endif
   int ret;
 
   /* Perform the common _inode_search() logic.  This does everything except
@@ -487,7 +510,20 @@ int inode_search(FAR struct inode_search_s *desc)
       desc->path = desc->buffer;
     }
 
+#if CONFIG_PSEUDOFS_PATHCACHE > 0
+  path = desc->path;
+  ret  = inode_pathcache_find(desc);
+  if (ret < 0)
+    {
+      ret = _inode_search(desc);
+      if (ret >= 0)
+        {
+          inode_pathcache_add(path, desc);
+        }
+    }
+#else
   ret = _inode_search(desc);
+#endif
 
 #ifdef CONFIG_PSEUDOFS_SOFTLINKS
   if (ret >= 0)
@@ -95,7 +95,9 @@
  *  node     - INPUT:  (not used)
  *             OUTPUT: On success, holds the pointer to the inode found.
  *  peer     - INPUT:  (not used)
- *             OUTPUT: The inode to the "left" of the inode found.
+ *             OUTPUT: The inode to the "left" of the inode found.  This
+ *                     may be NULL for an inode found through the children
+ *                     hash or the path cache.
  *  parent   - INPUT:  (not used)
  *             OUTPUT: The inode to the "above" of the inode found.
  *  relpath  - INPUT:  (not used)
@@ -331,6 +333,71 @@ void inode_free(FAR struct inode *node);
 
 const char *inode_nextname(FAR const char *name);
 
+/****************************************************************************
+ * Name: inode_hashadd and inode_hashdel
+ *
+ * Description:
+ *   Add an inode just linked into the inode tree to the children hash, or
+ *   remove an inode about to be unlinked from it.  Either way the path
+ *   cache is invalidated.
+ *
+ * Assumptions:
+ *   The caller holds the inode lock for writing.
+ *
+ ****************************************************************************/
+
+#if CONFIG_PSEUDOFS_HASHSIZE > 0 || CONFIG_PSEUDOFS_PATHCACHE > 0
+void inode_hashadd(FAR struct inode *node);
+void inode_hashdel(FAR struct inode *node);
+#else
+#  define inode_hashadd(n)
+#  define inode_hashdel(n)
+#endif
+
+/****************************************************************************
+ * Name: inode_hashfind
+ *
+ * Description:
+ *   Look up the child of 'parent' named by the first segment of 'name'.
+ *
+ * Returned Value:
+ *   The child inode, or NULL if there is none.
+ *
+ ****************************************************************************/
+
+#if CONFIG_PSEUDOFS_HASHSIZE > 0
+FAR struct inode *inode_hashfind(FAR struct inode *parent,
+                                 FAR const char *name);
+
+/****************************************************************************
+ * Name: inode_hashmove
+ *
+ * Description:
+ *   Re-index the children of 'parent' after they were moved to it from
+ *   another inode.
+ *
+ ****************************************************************************/
+
+void inode_hashmove(FAR struct inode *parent);
+#endif
+
+/****************************************************************************
+ * Name: inode_pathcache_find and inode_pathcache_add
+ *
+ * Description:
+ *   Look up or record the result of the search of an absolute path in the
+ *   path cache.  Only paths resolved to an inode of the pseudo file system
+ *   itself, not through a mountpoint or a soft link, are recorded.  A hit
+ *   does not report the peer of the inode found.
+ *
+ ****************************************************************************/
+
+#if CONFIG_PSEUDOFS_PATHCACHE > 0
+int  inode_pathcache_find(FAR struct inode_search_s *desc);
+void inode_pathcache_add(FAR const char *path,
+                         FAR struct inode_search_s *desc);
+#endif
+
 /****************************************************************************
  * Name: inode_root_reserve
  *
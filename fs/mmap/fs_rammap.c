@@ -25,6 +25,8 @@
 #include <nuttx/config.h>
 #include <sys/types.h>
 #include <sys/ioctl.h>
+#include <sys/mman.h>
+#include <sys/param.h>
 
 #include <assert.h>
 #include <debug.h>
@@ -33,14 +35,51 @@
 #include <string.h>
 #include <unistd.h>
 
+#include <nuttx/arch.h>
 #include <nuttx/fs/fs.h>
 #include <nuttx/kmalloc.h>
+#include <nuttx/mutex.h>
+#include <nuttx/nuttx.h>
 #include <nuttx/sched.h>
 
 #include "fs_rammap.h"
 #include "sched/sched.h"
 #include "fs_heap.h"
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_RAMMAP_PAGED
+#  define RAMMAP_PAGESIZE  CONFIG_FS_RAMMAP_PAGESIZE
+
+/* The state of one page of a demand paged mapping */
+
+#  define RAMMAP_PRESENT   (1 << 0)  /* Filled from the file */
+#  define RAMMAP_DIRTY     (1 << 1)  /* Written since the last write back */
+#endif
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_RAMMAP_PAGED
+/* A demand paged mapping.  The pages are inaccessible until the first
+ * access to them fills them from the file and makes them read-only.  A
+ * write then faults once more to mark the page dirty and make it
+ * writable, until the page is written back.
+ */
+
+struct rammap_paged_s
+{
+  FAR struct file *filep;       /* The backing file */
+  enum mm_map_type_e type;      /* MAP_KERNEL or MAP_USER */
+  mutex_t lock;                 /* Serializes the faults and write backs */
+  size_t npages;                /* Number of pages of the region */
+  uint8_t state[1];             /* RAMMAP_* state of each page */
+};
+#endif
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -203,6 +242,341 @@ static int unmap_rammap(FAR struct task_group_s *group,
   return ret;
 }
 
+#ifdef CONFIG_FS_RAMMAP_PAGED
+/****************************************************************************
+ * Name: rammap_free_paged
+ ****************************************************************************/
+
+static void rammap_free_paged(FAR struct rammap_paged_s *paged,
+                              FAR void *vaddr)
+{
+  /* Make the region accessible again before it goes back to the heap */
+
+  up_mprotect(vaddr, paged->npages * RAMMAP_PAGESIZE,
+              PROT_READ | PROT_WRITE);
+
+  if (paged->type == MAP_KERNEL)
+    {
+      kmm_free(vaddr);
+    }
+  else
+    {
+      kumm_free(vaddr);
+    }
+
+  nxmutex_destroy(&paged->lock);
+  fs_heap_free(paged);
+}
+
+/****************************************************************************
+ * Name: msync_rammap_paged
+ *
+ * Description:
+ *   Write the dirty pages of the range back to the file.  A page is write
+ *   protected again before it is written, so that a concurrent write marks
+ *   it dirty once more.
+ *
+ ****************************************************************************/
+
+static int msync_rammap_paged(FAR struct mm_map_entry_s *entry,
+                              FAR void *start, size_t length, int flags)
+{
+  FAR struct rammap_paged_s *paged = entry->priv.p;
+  FAR uint8_t *pgaddr;
+  ssize_t nwrite;
+  size_t offset;
+  size_t page;
+  size_t last;
+  size_t len;
+  int ret;
+
+  offset = (uintptr_t)start - (uintptr_t)entry->vaddr;
+  if (length > entry->length - offset)
+    {
+      length = entry->length - offset;
+    }
+
+  if (length == 0)
+    {
+      return OK;
+    }
+
+  ret = nxmutex_lock(&paged->lock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  last = (offset + length - 1) / RAMMAP_PAGESIZE;
+  for (page = offset / RAMMAP_PAGESIZE; page <= last; page++)
+    {
+      if ((paged->state[page] & RAMMAP_DIRTY) == 0)
+        {
+          continue;
+        }
+
+      pgaddr = (FAR uint8_t *)entry->vaddr + page * RAMMAP_PAGESIZE;
+      ret = up_mprotect(pgaddr, RAMMAP_PAGESIZE, PROT_READ);
+      if (ret < 0)
+        {
+          break;
+        }
+
+      paged->state[page] &= ~RAMMAP_DIRTY;
+
+      offset = page * RAMMAP_PAGESIZE;
+      len    = MIN(entry->length - offset, RAMMAP_PAGESIZE);
+      while (len > 0)
+        {
+          nwrite = file_pwrite(paged->filep, pgaddr, len,
+                               entry->offset + offset);
+          if (nwrite < 0)
+            {
+              if (nwrite == -EINTR)
+                {
+                  continue;
+                }
+
+              ferr("ERROR: Write failed: offset=%" PRIdOFF " nwrite=%zd\n",
+                   entry->offset + offset, nwrite);
+
+              /* Keep the page dirty so that a later msync() retries it */
+
+              paged->state[page] |= RAMMAP_DIRTY;
+              up_mprotect((FAR uint8_t *)entry->vaddr +
+                          page * RAMMAP_PAGESIZE, RAMMAP_PAGESIZE,
+                          PROT_READ | PROT_WRITE);
+              ret = nwrite;
+              goto out;
+            }
+
+          pgaddr += nwrite;
+          offset += nwrite;
+          len    -= nwrite;
+        }
+    }
+
+out:
+  nxmutex_unlock(&paged->lock);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: fault_rammap_paged
+ *
+ * Description:
+ *   Resolve an access to a protected page of the mapping.  The first access
+ *   fills the page, a later one can only be a write to a clean page.
+ *
+ ****************************************************************************/
+
+static int fault_rammap_paged(FAR struct mm_map_entry_s *entry,
+                              FAR void *vaddr)
+{
+  FAR struct rammap_paged_s *paged = entry->priv.p;
+  FAR uint8_t *pgaddr;
+  FAR uint8_t *buffer;
+  ssize_t nread;
+  size_t offset;
+  size_t page;
+  size_t len;
+  int ret;
+
+  page   = ((uintptr_t)vaddr - (uintptr_t)entry->vaddr) / RAMMAP_PAGESIZE;
+  offset = page * RAMMAP_PAGESIZE;
+  pgaddr = (FAR uint8_t *)entry->vaddr + offset;
+
+  ret = nxmutex_lock(&paged->lock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  if ((paged->state[page] & RAMMAP_PRESENT) == 0)
+    {
+      ret = up_mprotect(pgaddr, RAMMAP_PAGESIZE, PROT_READ | PROT_WRITE);
+      if (ret < 0)
+        {
+          goto out;
+        }
+
+      /* Read the page, zeroing what lies beyond the end of the file */
+
+      buffer = pgaddr;
+      len    = MIN(entry->length - offset, RAMMAP_PAGESIZE);
+      while (len > 0)
+        {
+          nread = file_pread(paged->filep, buffer, len,
+                             entry->offset + offset);
+          if (nread < 0)
+            {
+              if (nread == -EINTR)
+                {
+                  continue;
+                }
+
+              ferr("ERROR: Read failed: offset=%" PRIdOFF " ret=%zd\n",
+                   entry->offset + offset, nread);
+
+              up_mprotect(pgaddr, RAMMAP_PAGESIZE, PROT_NONE);
+              ret = nread;
+              goto out;
+            }
+          else if (nread == 0)
+            {
+              break;
+            }
+
+          buffer += nread;
+          offset += nread;
+          len    -= nread;
+        }
+
+      memset(buffer, 0, pgaddr + RAMMAP_PAGESIZE - buffer);
+
+      paged->state[page] |= RAMMAP_PRESENT;
+      ret = up_mprotect(pgaddr, RAMMAP_PAGESIZE, PROT_READ);
+    }
+  else if ((paged->state[page] & RAMMAP_DIRTY) == 0)
+    {
+      paged->state[page] |= RAMMAP_DIRTY;
+      ret = up_mprotect(pgaddr, RAMMAP_PAGESIZE, PROT_READ | PROT_WRITE);
+    }
+
+out:
+  nxmutex_unlock(&paged->lock);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: unmap_rammap_paged
+ ****************************************************************************/
+
+static int unmap_rammap_paged(FAR struct task_group_s *group,
+                              FAR struct mm_map_entry_s *entry,
+                              FAR void *start,
+                              size_t length)
+{
+  FAR struct rammap_paged_s *paged = entry->priv.p;
+  off_t offset;
+  int ret = OK;
+
+  /* As for the copied mappings, all unmappings must extend to the end of
+   * the region.
+   */
+
+  offset = (uintptr_t)start - (uintptr_t)entry->vaddr;
+  if (offset + length < entry->length)
+    {
+      ferr("ERROR: Cannot umap without unmapping to the end\n");
+      return -ENOSYS;
+    }
+
+  length = entry->length - offset;
+
+  /* Write the dirty pages of a shared mapping back to the file */
+
+  if ((entry->flags & MAP_SHARED) != 0)
+    {
+      ret = msync_rammap_paged(entry, start, length, 0);
+      if (ret < 0)
+        {
+          ferr("ERROR: Write back failed: %d\n", ret);
+        }
+    }
+
+  if (length >= entry->length)
+    {
+      fs_putfilep(paged->filep);
+      rammap_free_paged(paged, entry->vaddr);
+
+      /* Then remove the mapping from the list */
+
+      ret = mm_map_remove(get_group_mm(group), entry);
+    }
+
+  /* Only shorten the mapping.  The pages beyond its end stay allocated,
+   * and inaccessible, until the whole region is unmapped.
+   */
+
+  else
+    {
+      entry->length = offset;
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: rammap_paged
+ *
+ * Description:
+ *   Set up a demand paged mapping of the file.  Nothing is read now.
+ *
+ ****************************************************************************/
+
+static int rammap_paged(FAR struct file *filep,
+                        FAR struct mm_map_entry_s *entry,
+                        enum mm_map_type_e type)
+{
+  FAR struct rammap_paged_s *paged;
+  size_t npages;
+  int ret;
+
+  npages = ALIGN_UP(entry->length, RAMMAP_PAGESIZE) / RAMMAP_PAGESIZE;
+  paged  = fs_heap_zalloc(sizeof(*paged) + npages);
+  if (paged == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  nxmutex_init(&paged->lock);
+  paged->filep  = filep;
+  paged->type   = type;
+  paged->npages = npages;
+
+  /* Whole pages are protected, so the region must not share one with any
+   * other allocation.
+   */
+
+  entry->vaddr = type == MAP_KERNEL ?
+                 kmm_memalign(RAMMAP_PAGESIZE, npages * RAMMAP_PAGESIZE) :
+                 kumm_memalign(RAMMAP_PAGESIZE, npages * RAMMAP_PAGESIZE);
+  if (entry->vaddr == NULL)
+    {
+      ferr("ERROR: Region allocation failed, length: %zu\n",
+           entry->length);
+      nxmutex_destroy(&paged->lock);
+      fs_heap_free(paged);
+      return -ENOMEM;
+    }
+
+  ret = up_mprotect(entry->vaddr, npages * RAMMAP_PAGESIZE, PROT_NONE);
+  if (ret < 0)
+    {
+      goto errout_with_region;
+    }
+
+  entry->priv.p = paged;
+  entry->munmap = unmap_rammap_paged;
+  entry->msync  = msync_rammap_paged;
+  entry->fault  = fault_rammap_paged;
+
+  ret = mm_map_add(get_current_mm(), entry);
+  if (ret < 0)
+    {
+      goto errout_with_region;
+    }
+
+  fs_reffilep(filep);
+  return OK;
+
+errout_with_region:
+  rammap_free_paged(paged, entry->vaddr);
+  return ret;
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -248,6 +622,10 @@ int rammap(FAR struct file *filep, FAR struct mm_map_entry_s *entry,
       goto out;
     }
 
+#ifdef CONFIG_FS_RAMMAP_PAGED
+  return rammap_paged(filep, entry, type);
+#endif
+
   /* There is a major design flaw that I have not yet thought of fix for:
    * The goal is to have a single region of memory that represents a single
    * file and can be shared by many threads.  That is, given a filename a
@@ -29,7 +29,8 @@
  *
  * - All of the file must be present in memory.  This limits the size of
  *   files that may be memory mapped (especially on MCUs with no significant
- *   RAM resources).
+ *   RAM resources).  With CONFIG_FS_RAMMAP_PAGED, the memory is still
+ *   allocated up front but each page is only read on its first access.
  * - All mapped files are read-only.  You can write to the in-memory image,
  *   but the file contents will not change.
  * - There are not access privileges.
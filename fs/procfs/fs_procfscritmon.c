@@ -56,7 +56,7 @@
  * to handle the longest line generated by this logic.
  */
 
-#define CRITMON_LINELEN 64
+#define CRITMON_LINELEN 96
 
 /****************************************************************************
  * Private Types
@@ -284,6 +284,68 @@ static ssize_t critmon_read_cpu(FAR struct critmon_file_s *attr,
   return totalsize;
 }
 
+/****************************************************************************
+ * Name: critmon_read_contention
+ *
+ * Description:
+ *   Generate one line per lock acquisition site that had to wait:  the
+ *   caller address, the number of waits, the total and the maximum time
+ *   spent waiting.  The counters are reset once reported.
+ *
+ ****************************************************************************/
+
+#if defined(CONFIG_SCHED_CRITMONITOR_CONTENTION) && \
+    CONFIG_SCHED_CRITMONITOR_CONTENTION > 0
+static ssize_t critmon_read_contention(FAR struct critmon_file_s *attr,
+                                       FAR char *buffer, size_t buflen,
+                                       FAR off_t *offset)
+{
+  FAR struct critmon_contention_s *site;
+  struct timespec maxtime;
+  struct timespec total;
+  size_t linesize;
+  size_t copysize;
+  size_t totalsize = 0;
+  int i;
+
+  for (i = 0; i < CONFIG_SCHED_CRITMONITOR_CONTENTION && buflen > 0; i++)
+    {
+      site = &g_crit_contention[i];
+      if (site->count == 0)
+        {
+          continue;
+        }
+
+      perf_convert(site->total, &total);
+      perf_convert(site->max, &maxtime);
+
+      linesize = procfs_snprintf(attr->line, CRITMON_LINELEN,
+                                 "%p,%lu,%lu.%09lu,%lu.%09lu\n",
+                                 site->caller,
+                                 (unsigned long)site->count,
+                                 (unsigned long)total.tv_sec,
+                                 (unsigned long)total.tv_nsec,
+                                 (unsigned long)maxtime.tv_sec,
+                                 (unsigned long)maxtime.tv_nsec);
+
+      /* Reset the counters, the site keeps its slot */
+
+      site->count = 0;
+      site->total = 0;
+      site->max   = 0;
+
+      copysize = procfs_memcpy(attr->line, linesize, buffer, buflen,
+                               offset);
+
+      totalsize += copysize;
+      buffer    += copysize;
+      buflen    -= copysize;
+    }
+
+  return totalsize;
+}
+#endif
+
 /****************************************************************************
  * Name: critmon_read
  ****************************************************************************/
@@ -320,6 +382,17 @@ static ssize_t critmon_read(FAR struct file *filep, FAR char *buffer,
         }
     }
 
+#if defined(CONFIG_SCHED_CRITMONITOR_CONTENTION) && \
+    CONFIG_SCHED_CRITMONITOR_CONTENTION > 0
+  /* Then the contended lock acquisition sites */
+
+  if (ret < buflen)
+    {
+      ret += critmon_read_contention(attr, buffer + ret, buflen - ret,
+                                     &offset);
+    }
+#endif
+
   if (ret > 0)
     {
       filep->f_pos += ret;
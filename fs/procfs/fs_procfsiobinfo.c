@@ -221,6 +221,33 @@ static ssize_t iobinfo_read(FAR struct file *filep, FAR char *buffer,
                              &offset);
   totalsize += copysize;
 
+#if defined(CONFIG_IOB_PERCPU_CACHE) && \
+    CONFIG_IOB_PERCPU_CACHE > 0
+  /* Followed by the per-CPU cache statistics */
+
+  buffer    += copysize;
+  buflen    -= copysize;
+
+  linesize   = procfs_snprintf(iobfile->line, IOBINFO_LINELEN,
+                               "%10s%10s%10s%10s%10s\n",
+                               "ncached", "nhits", "nmisses", "ndrains",
+                               "ncontend");
+  copysize   = procfs_memcpy(iobfile->line, linesize, buffer, buflen,
+                             &offset);
+  totalsize += copysize;
+
+  buffer    += copysize;
+  buflen    -= copysize;
+
+  linesize   = procfs_snprintf(iobfile->line, IOBINFO_LINELEN,
+                               "%10d%10lu%10lu%10lu%10lu\n",
+                               stats.ncached, stats.nhits, stats.nmisses,
+                               stats.ndrains, stats.ncontended);
+  copysize   = procfs_memcpy(iobfile->line, linesize, buffer, buflen,
+                             &offset);
+  totalsize += copysize;
+#endif
+
   /* Update the file offset */
 
   filep->f_pos += totalsize;
@@ -43,6 +43,7 @@
 #include <nuttx/progmem.h>
 #include <nuttx/sched.h>
 #include <nuttx/mm/mm.h>
+#include <nuttx/mm/mempool.h>
 #include <nuttx/fs/fs.h>
 #include <nuttx/fs/procfs.h>
 
@@ -339,6 +340,31 @@ static ssize_t meminfo_read(FAR struct file *filep, FAR char *buffer,
           copysize   = procfs_memcpy(procfile->line, linesize, buffer,
                                      buflen, &offset);
           totalsize += copysize;
+
+#if defined(CONFIG_MM_HEAP_MEMPOOL_PERCPU_CACHE) && \
+    CONFIG_MM_HEAP_MEMPOOL_PERCPU_CACHE > 0
+          /* Show the per-CPU mempool cache statistics */
+
+          if (buflen > 0)
+            {
+              struct mempool_cacheinfo_s cacheinfo;
+
+              buffer    += copysize;
+              buflen    -= copysize;
+
+              mm_mempool_cacheinfo(entry->heap, &cacheinfo);
+              linesize   = procfs_snprintf(procfile->line, MEMINFO_LINELEN,
+                                           "%10s: pcache hits %lu misses "
+                                           "%lu drains %lu cached %lu\n",
+                                           entry->name, cacheinfo.hits,
+                                           cacheinfo.misses,
+                                           cacheinfo.drains,
+                                           cacheinfo.cached);
+              copysize   = procfs_memcpy(procfile->line, linesize, buffer,
+                                         buflen, &offset);
+              totalsize += copysize;
+            }
+#endif
         }
     }
 
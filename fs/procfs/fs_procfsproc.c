@@ -458,6 +458,8 @@ static FAR const struct proc_node_s *proc_findnode(FAR const char *relpath)
  *   PPID:       xxxxx              Parent thread ID
  *   Group:      xxxxx              Group ID
  *   CPU:        xxx                CPU (CONFIG_SMP only)
+ *   Migrations: nnn                Number of changes of CPU (CONFIG_SMP and
+ *                                  CONFIG_SCHED_CPUSELECT_AFFINITY only)
  *   State:      xxxxxxxx,xxxxxxxxx {Invalid, Waiting, Ready, Running,
  *                                   Inactive},
  *                                  {Unlock, Semaphore, Signal, MQ empty,
@@ -558,6 +560,23 @@ static ssize_t proc_status(FAR struct proc_file_s *procfile,
     {
       return totalsize;
     }
+
+#ifdef CONFIG_SCHED_CPUSELECT_AFFINITY
+  linesize   = procfs_snprintf(procfile->line, STATUS_LINELEN,
+                               "%-12s%" PRIu32 "\n", "Migrations:",
+                               tcb->nmigrations);
+  copysize   = procfs_memcpy(procfile->line, linesize, buffer, remaining,
+                             &offset);
+
+  totalsize += copysize;
+  buffer    += copysize;
+  remaining -= copysize;
+
+  if (totalsize >= buflen)
+    {
+      return totalsize;
+    }
+#endif
 #endif
 
   /* Show the thread state */
@@ -24,6 +24,7 @@
 
 #include <nuttx/config.h>
 
+#include <sys/param.h>
 #include <sys/types.h>
 #include <sys/statfs.h>
 #include <sys/stat.h>
@@ -105,6 +106,11 @@ static int     romfs_stat_common(uint8_t type, uint32_t size,
 static int     romfs_stat(FAR struct inode *mountpt, FAR const char *relpath,
                           FAR struct stat *buf);
 
+static int     romfs_splice(FAR struct file *filep,
+                            FAR struct splice_ref_s *ref);
+static void    romfs_unsplice(FAR struct file *filep,
+                              FAR struct splice_ref_s *ref, size_t nused);
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -145,7 +151,11 @@ const struct mountpt_operations g_romfs_operations =
   NULL,            /* rmdir */
   NULL,            /* rename */
   romfs_stat,      /* stat */
-  NULL             /* chstat */
+  NULL,            /* chstat */
+  NULL,            /* syncfs */
+
+  romfs_splice,    /* splice */
+  romfs_unsplice   /* unsplice */
 };
 
 /****************************************************************************
@@ -652,6 +662,47 @@ static int romfs_mmap(FAR struct file *filep, FAR struct mm_map_entry_s *map)
   return -ENOTTY;
 }
 
+/****************************************************************************
+ * Name: romfs_splice
+ ****************************************************************************/
+
+static int romfs_splice(FAR struct file *filep,
+                        FAR struct splice_ref_s *ref)
+{
+  FAR struct romfs_mountpt_s *rm = filep->f_inode->i_private;
+  FAR struct romfs_file_s *rf = filep->f_priv;
+
+  /* The image is immutable, lend the data in place if it is mapped */
+
+  if (rm->rm_xipbase == 0)
+    {
+      return -ENXIO;
+    }
+
+  ref->pos = filep->f_pos;
+  if (filep->f_pos >= rf->rf_size)
+    {
+      ref->len = 0;
+    }
+  else
+    {
+      ref->data = rm->rm_xipbase + rf->rf_startoffset + filep->f_pos;
+      ref->len  = MIN(ref->len, rf->rf_size - filep->f_pos);
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: romfs_unsplice
+ ****************************************************************************/
+
+static void romfs_unsplice(FAR struct file *filep,
+                           FAR struct splice_ref_s *ref, size_t nused)
+{
+  filep->f_pos += nused;
+}
+
 /****************************************************************************
  * Name: romfs_dup
  ****************************************************************************/
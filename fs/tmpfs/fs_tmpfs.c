@@ -24,6 +24,7 @@
 
 #include <nuttx/config.h>
 
+#include <sys/param.h>
 #include <sys/stat.h>
 #include <sys/statfs.h>
 #include <stdint.h>
@@ -51,7 +52,18 @@
 #  warning CONFIG_FS_TMPFS_DIRECTORY_FREEGUARD needs to be > ALLOCGUARD
 #endif
 
-#if CONFIG_FS_TMPFS_FILE_FREEGUARD <= CONFIG_FS_TMPFS_FILE_ALLOCGUARD
+#ifdef CONFIG_FS_TMPFS_PAGED
+#  if (CONFIG_FS_TMPFS_PAGESIZE & (CONFIG_FS_TMPFS_PAGESIZE - 1)) != 0
+#    error CONFIG_FS_TMPFS_PAGESIZE must be a power of two
+#  endif
+
+/* Page arithmetic for the paged file storage */
+
+#  define TMPFS_PAGESIZE      CONFIG_FS_TMPFS_PAGESIZE
+#  define TMPFS_PAGEMASK      (TMPFS_PAGESIZE - 1)
+#  define TMPFS_PAGE(o)       ((size_t)(o) / TMPFS_PAGESIZE)
+#  define TMPFS_NPAGES(s)     (TMPFS_PAGE(s) + (((s) & TMPFS_PAGEMASK) != 0))
+#elif CONFIG_FS_TMPFS_FILE_FREEGUARD <= CONFIG_FS_TMPFS_FILE_ALLOCGUARD
 #  warning CONFIG_FS_TMPFS_FILE_FREEGUARD needs to be > ALLOCGUARD
 #endif
 
@@ -93,6 +105,17 @@ static int  tmpfs_realloc_directory(FAR struct tmpfs_directory_s *tdo,
               unsigned int nentries);
 static int  tmpfs_realloc_file(FAR struct tmpfs_file_s *tfo,
               size_t newsize);
+static void tmpfs_free_filedata(FAR struct tmpfs_file_s *tfo);
+#ifdef CONFIG_FS_TMPFS_PAGED
+static int  tmpfs_alloc_pages(FAR struct tmpfs_file_s *tfo, off_t pos,
+              size_t len);
+static void tmpfs_read_pages(FAR struct tmpfs_file_s *tfo,
+              FAR char *buffer, off_t pos, size_t len);
+static void tmpfs_write_pages(FAR struct tmpfs_file_s *tfo,
+              FAR const char *buffer, off_t pos, size_t len);
+static int  tmpfs_map_page(FAR struct tmpfs_file_s *tfo,
+              FAR struct mm_map_entry_s *map);
+#endif
 static void tmpfs_release_lockedobject(FAR struct tmpfs_object_s *to);
 static void tmpfs_release_lockedfile(FAR struct tmpfs_file_s *tfo);
 static int  tmpfs_release_file(FAR struct tmpfs_file_s *tfo);
@@ -171,6 +194,12 @@ static void tmpfs_stat_common(FAR struct tmpfs_object_s *to,
               FAR struct stat *buf);
 static int  tmpfs_stat(FAR struct inode *mountpt, FAR const char *relpath,
               FAR struct stat *buf);
+#ifdef CONFIG_FS_TMPFS_PAGED
+static int  tmpfs_splice(FAR struct file *filep,
+              FAR struct splice_ref_s *ref);
+static void tmpfs_unsplice(FAR struct file *filep,
+              FAR struct splice_ref_s *ref, size_t nused);
+#endif
 
 /****************************************************************************
  * Public Data
@@ -207,7 +236,13 @@ const struct mountpt_operations g_tmpfs_operations =
   tmpfs_rmdir,      /* rmdir */
   tmpfs_rename,     /* rename */
   tmpfs_stat,       /* stat */
-  NULL              /* chstat */
+  NULL,             /* chstat */
+  NULL,             /* syncfs */
+
+#ifdef CONFIG_FS_TMPFS_PAGED
+  tmpfs_splice,     /* splice */
+  tmpfs_unsplice    /* unsplice */
+#endif
 };
 
 /****************************************************************************
@@ -263,10 +298,141 @@ static int tmpfs_realloc_directory(FAR struct tmpfs_directory_s *tdo,
   return ret;
 }
 
+#ifdef CONFIG_FS_TMPFS_PAGED
+/****************************************************************************
+ * Name: tmpfs_spliced
+ *
+ * Description:
+ *   Return true if the page is lent by tmpfs_splice().
+ *
+ ****************************************************************************/
+
+static bool tmpfs_spliced(FAR struct tmpfs_file_s *tfo, FAR uint8_t *page)
+{
+  FAR struct splice_ref_s *ref;
+
+  for (ref = tfo->tfo_splices; ref != NULL; ref = ref->flink)
+    {
+      if (ref->priv == page)
+        {
+          return true;
+        }
+    }
+
+  return false;
+}
+#endif
+
 /****************************************************************************
  * Name: tmpfs_realloc_file
+ *
+ * Description:
+ *   Change the size of the file to 'newsize'.  With the paged storage, only
+ *   the page table is grown: the new pages are holes until they are
+ *   written.  Shrinking frees the pages beyond the new end of the file and
+ *   zeroes the tail of the last page, so that the bytes of an allocated
+ *   page beyond the end of the file always read as zero.  A page lent by
+ *   tmpfs_splice() is only dropped from the file, tmpfs_unsplice() frees
+ *   it.
+ *
  ****************************************************************************/
 
+#ifdef CONFIG_FS_TMPFS_PAGED
+static int tmpfs_realloc_file(FAR struct tmpfs_file_s *tfo,
+                              size_t newsize)
+{
+  FAR uint8_t **newpages;
+  size_t npages;
+  size_t offset;
+  size_t i;
+
+  npages = TMPFS_NPAGES(newsize);
+
+  if (newsize < tfo->tfo_size)
+    {
+      /* Free the pages beyond the new end of the file */
+
+      for (i = npages; i < TMPFS_NPAGES(tfo->tfo_size); i++)
+        {
+          if (tfo->tfo_pages[i] != NULL)
+            {
+              if (!tmpfs_spliced(tfo, tfo->tfo_pages[i]))
+                {
+                  fs_heap_free(tfo->tfo_pages[i]);
+                }
+
+              tfo->tfo_pages[i] = NULL;
+              tfo->tfo_alloc   -= TMPFS_PAGESIZE;
+            }
+        }
+
+      /* Zero the remainder of the new last page */
+
+      offset = newsize & TMPFS_PAGEMASK;
+      if (offset != 0 && tfo->tfo_pages[npages - 1] != NULL)
+        {
+          memset(tfo->tfo_pages[npages - 1] + offset, 0,
+                 TMPFS_PAGESIZE - offset);
+        }
+
+      tfo->tfo_size = newsize;
+
+      if (npages == 0)
+        {
+          fs_heap_free(tfo->tfo_pages);
+          tfo->tfo_pages  = NULL;
+          tfo->tfo_npages = 0;
+        }
+      else if (npages <= tfo->tfo_npages / 4)
+        {
+          /* The page table has shrunk by a lot.  Halve it, keeping room
+           * to grow again.  This is only an optimization so a failure is
+           * not an error.
+           */
+
+          newpages = fs_heap_realloc(tfo->tfo_pages,
+                                     tfo->tfo_npages / 2 *
+                                     sizeof(FAR uint8_t *));
+          if (newpages != NULL)
+            {
+              tfo->tfo_pages   = newpages;
+              tfo->tfo_npages /= 2;
+            }
+        }
+
+      return OK;
+    }
+
+  if (npages > tfo->tfo_npages)
+    {
+      /* Grow the page table geometrically so that appending to the file
+       * costs O(1) amortized.
+       */
+
+      i = MAX(npages, tfo->tfo_npages * 2);
+      if (i > SIZE_MAX / sizeof(FAR uint8_t *))
+        {
+          return -ENOMEM;
+        }
+
+      newpages = fs_heap_realloc(tfo->tfo_pages,
+                                 i * sizeof(FAR uint8_t *));
+      if (newpages == NULL)
+        {
+          return -ENOMEM;
+        }
+
+      memset(&newpages[tfo->tfo_npages], 0,
+             (i - tfo->tfo_npages) * sizeof(FAR uint8_t *));
+
+      tfo->tfo_pages  = newpages;
+      tfo->tfo_npages = i;
+    }
+
+  tfo->tfo_size = newsize;
+  return OK;
+}
+#else
 static int tmpfs_realloc_file(FAR struct tmpfs_file_s *tfo,
                               size_t newsize)
 {
@@ -340,6 +506,136 @@ static int tmpfs_realloc_file(FAR struct tmpfs_file_s *tfo,
   tfo->tfo_data  = newdata;
   return OK;
 }
+#endif
+
+/****************************************************************************
+ * Name: tmpfs_free_filedata
+ ****************************************************************************/
+
+static void tmpfs_free_filedata(FAR struct tmpfs_file_s *tfo)
+{
+#ifdef CONFIG_FS_TMPFS_PAGED
+  size_t i;
+
+  for (i = 0; i < tfo->tfo_npages; i++)
+    {
+      fs_heap_free(tfo->tfo_pages[i]);
+    }
+
+  fs_heap_free(tfo->tfo_pages);
+#else
+  fs_heap_free(tfo->tfo_data);
+#endif
+}
+
+#ifdef CONFIG_FS_TMPFS_PAGED
+/****************************************************************************
+ * Name: tmpfs_alloc_pages
+ *
+ * Description:
+ *   Allocate the zeroed pages backing the holes in the range of 'len' bytes
+ *   at 'pos'.  The range must be within the size of the file.
+ *
+ ****************************************************************************/
+
+static int tmpfs_alloc_pages(FAR struct tmpfs_file_s *tfo, off_t pos,
+                             size_t len)
+{
+  FAR uint8_t *page;
+  size_t i;
+
+  if (len == 0)
+    {
+      return OK;
+    }
+
+  DEBUGASSERT(pos + len <= tfo->tfo_size);
+
+  for (i = TMPFS_PAGE(pos); i <= TMPFS_PAGE(pos + len - 1); i++)
+    {
+      if (tfo->tfo_pages[i] == NULL)
+        {
+          page = fs_heap_zalloc(TMPFS_PAGESIZE);
+          if (page == NULL)
+            {
+              return -ENOMEM;
+            }
+
+          tfo->tfo_pages[i] = page;
+          tfo->tfo_alloc   += TMPFS_PAGESIZE;
+        }
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: tmpfs_read_pages
+ *
+ * Description:
+ *   Copy 'len' bytes at 'pos' out of the file pages.  Holes read as zeros.
+ *
+ ****************************************************************************/
+
+static void tmpfs_read_pages(FAR struct tmpfs_file_s *tfo,
+                             FAR char *buffer, off_t pos, size_t len)
+{
+  FAR uint8_t *page;
+  size_t offset;
+  size_t n;
+
+  while (len > 0)
+    {
+      page   = tfo->tfo_pages[TMPFS_PAGE(pos)];
+      offset = pos & TMPFS_PAGEMASK;
+      n      = MIN(len, TMPFS_PAGESIZE - offset);
+
+      if (page != NULL)
+        {
+          memcpy(buffer, page + offset, n);
+        }
+      else
+        {
+          memset(buffer, 0, n);
+        }
+
+      buffer += n;
+      pos    += n;
+      len    -= n;
+    }
+}
+
+/****************************************************************************
+ * Name: tmpfs_write_pages
+ *
+ * Description:
+ *   Copy 'len' bytes into the file pages at 'pos'.  The pages must have
+ *   been allocated by tmpfs_alloc_pages().
+ *
+ ****************************************************************************/
+
+static void tmpfs_write_pages(FAR struct tmpfs_file_s *tfo,
+                              FAR const char *buffer, off_t pos, size_t len)
+{
+  FAR uint8_t *page;
+  size_t offset;
+  size_t n;
+
+  while (len > 0)
+    {
+      page   = tfo->tfo_pages[TMPFS_PAGE(pos)];
+      offset = pos & TMPFS_PAGEMASK;
+      n      = MIN(len, TMPFS_PAGESIZE - offset);
+
+      DEBUGASSERT(page != NULL);
+      memcpy(page + offset, buffer, n);
+
+      buffer += n;
+      pos    += n;
+      len    -= n;
+    }
+}
+#endif
 
 /****************************************************************************
  * Name: tmpfs_release_lockedobject
@@ -378,7 +674,7 @@ static void tmpfs_release_lockedfile(FAR struct tmpfs_file_s *tfo)
     {
       tmpfs_unlock_file(tfo);
       nxrmutex_destroy(&tfo->tfo_lock);
-      fs_heap_free(tfo->tfo_data);
+      tmpfs_free_filedata(tfo);
       fs_heap_free(tfo);
     }
 
@@ -577,7 +873,13 @@ tmpfs_alloc_file(FAR struct tmpfs_directory_s *parent)
   tfo->tfo_parent = parent;
   tfo->tfo_flags  = 0;
   tfo->tfo_size   = 0;
+#ifdef CONFIG_FS_TMPFS_PAGED
+  tfo->tfo_npages = 0;
+  tfo->tfo_pages  = NULL;
+  tfo->tfo_splices = NULL;
+#else
   tfo->tfo_data   = NULL;
+#endif
 
   nxrmutex_init(&tfo->tfo_lock);
   tmpfs_lock_file(tfo);
@@ -1176,7 +1478,17 @@ static int tmpfs_statfs_callout(FAR struct tmpfs_directory_s *tdo,
 
       tmptfo             = (FAR struct tmpfs_file_s *)to;
       tmpbuf->tsf_alloc += sizeof(struct tmpfs_file_s);
+#ifdef CONFIG_FS_TMPFS_PAGED
+      /* The pages of a sparse file may hold less than its size */
+
+      tmpbuf->tsf_alloc += tmptfo->tfo_npages * sizeof(FAR uint8_t *);
+      if (to->to_alloc > tmptfo->tfo_size)
+        {
+          tmpbuf->tsf_avail += to->to_alloc - tmptfo->tfo_size;
+        }
+#else
       tmpbuf->tsf_avail += to->to_alloc - tmptfo->tfo_size;
+#endif
       tmpbuf->tsf_files++;
     }
   else /* if (to->to_type == TMPFS_DIRECTORY) */
@@ -1252,7 +1564,7 @@ static int tmpfs_free_callout(FAR struct tmpfs_directory_s *tdo,
           return TMPFS_UNLINKED;
         }
 
-      fs_heap_free(tfo->tfo_data);
+      tmpfs_free_filedata(tfo);
     }
   else /* if (to->to_type == TMPFS_DIRECTORY) */
     {
@@ -1573,6 +1885,10 @@ static ssize_t tmpfs_read(FAR struct file *filep, FAR char *buffer,
 
   /* Copy data from the memory object to the user buffer */
 
+#ifdef CONFIG_FS_TMPFS_PAGED
+  tmpfs_read_pages(tfo, buffer, startpos, nread);
+  filep->f_pos += nread;
+#else
   if (tfo->tfo_data != NULL)
     {
       memcpy(buffer, &tfo->tfo_data[startpos], nread);
@@ -1582,6 +1898,7 @@ static ssize_t tmpfs_read(FAR struct file *filep, FAR char *buffer,
     {
       DEBUGASSERT(tfo->tfo_size == 0 && nread == 0);
     }
+#endif
 
   /* Release the lock on the file */
 
@@ -1598,6 +1915,9 @@ static ssize_t tmpfs_write(FAR struct file *filep, FAR const char *buffer,
 {
   FAR struct tmpfs_file_s *tfo;
   ssize_t nwritten;
+#ifdef CONFIG_FS_TMPFS_PAGED
+  size_t oldsize;
+#endif
   off_t startpos;
   off_t endpos;
   int ret;
@@ -1631,6 +1951,9 @@ static ssize_t tmpfs_write(FAR struct file *filep, FAR const char *buffer,
 
   nwritten = buflen;
   endpos   = startpos + buflen;
+#ifdef CONFIG_FS_TMPFS_PAGED
+  oldsize  = tfo->tfo_size;
+#endif
 
   if (endpos > tfo->tfo_size)
     {
@@ -1645,6 +1968,24 @@ static ssize_t tmpfs_write(FAR struct file *filep, FAR const char *buffer,
 
   /* Copy data from the memory object to the user buffer */
 
+#ifdef CONFIG_FS_TMPFS_PAGED
+  /* Back the written range with pages first so that the write is either
+   * complete or has no effect.
+   */
+
+  ret = tmpfs_alloc_pages(tfo, startpos, nwritten);
+  if (ret < 0)
+    {
+      if (endpos > oldsize)
+        {
+          tmpfs_realloc_file(tfo, oldsize);
+        }
+
+      goto errout_with_lock;
+    }
+
+  tmpfs_write_pages(tfo, buffer, startpos, nwritten);
+#else
   if (tfo->tfo_data != NULL)
     {
       memcpy(&tfo->tfo_data[startpos], buffer, nwritten);
@@ -1653,6 +1994,7 @@ static ssize_t tmpfs_write(FAR struct file *filep, FAR const char *buffer,
     {
       DEBUGASSERT(tfo->tfo_size == 0 && nwritten == 0);
     }
+#endif
 
   filep->f_pos = endpos;
 
@@ -1759,6 +2101,48 @@ static int tmpfs_unmap(FAR struct task_group_s *group,
   return ret;
 }
 
+#ifdef CONFIG_FS_TMPFS_PAGED
+/****************************************************************************
+ * Name: tmpfs_map_page
+ *
+ * Description:
+ *   Map a region of the file in place.  Only a region within a single page
+ *   is contiguous in memory; larger regions return -ENOTTY so that mmap()
+ *   falls back to a copy of the file.
+ *
+ ****************************************************************************/
+
+static int tmpfs_map_page(FAR struct tmpfs_file_s *tfo,
+                          FAR struct mm_map_entry_s *map)
+{
+  int ret;
+
+  if (TMPFS_PAGE(map->offset) !=
+      TMPFS_PAGE(map->offset + map->length - 1))
+    {
+      return -ENOTTY;
+    }
+
+  ret = tmpfs_lock_file(tfo);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  /* A hole needs a page before it can be mapped */
+
+  ret = tmpfs_alloc_pages(tfo, map->offset, map->length);
+  if (ret >= 0)
+    {
+      map->vaddr = tfo->tfo_pages[TMPFS_PAGE(map->offset)] +
+                   (map->offset & TMPFS_PAGEMASK);
+    }
+
+  tmpfs_unlock_file(tfo);
+  return ret;
+}
+#endif
+
 static int tmpfs_mmap(FAR struct file *filep, FAR struct mm_map_entry_s *map)
 {
   FAR struct tmpfs_file_s *tfo;
@@ -1775,7 +2159,15 @@ static int tmpfs_mmap(FAR struct file *filep, FAR struct mm_map_entry_s *map)
   if (map->offset >= 0 && map->offset < tfo->tfo_size &&
       map->length && map->offset + map->length <= tfo->tfo_size)
     {
+#ifdef CONFIG_FS_TMPFS_PAGED
+      ret = tmpfs_map_page(tfo, map);
+      if (ret < 0)
+        {
+          return ret;
+        }
+#else
       map->vaddr = tfo->tfo_data + map->offset;
+#endif
       map->priv.p = tfo;
       map->munmap = tmpfs_unmap;
       ret = mm_map_add(get_current_mm(), map);
@@ -1825,6 +2217,7 @@ static int tmpfs_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
           return ret;
         }
     }
+#ifndef CONFIG_FS_TMPFS_PAGED
   else if (cmd == FIOC_XIPBASE)
     {
       FAR uintptr_t *ptr = (FAR uintptr_t *)arg;
@@ -1832,10 +2225,97 @@ static int tmpfs_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
       *ptr = (uintptr_t)tfo->tfo_data;
       return OK;
     }
+#endif
 
   return ret;
 }
 
+#ifdef CONFIG_FS_TMPFS_PAGED
+/****************************************************************************
+ * Name: tmpfs_splice
+ *
+ * Description:
+ *   Lend the page at the read position.  The file is not kept locked: the
+ *   page is pinned on tfo_splices instead, so that a truncation cannot free
+ *   it before tmpfs_unsplice().  The contiguous storage cannot be lent this
+ *   way because a write may move it.
+ *
+ ****************************************************************************/
+
+static int tmpfs_splice(FAR struct file *filep,
+                        FAR struct splice_ref_s *ref)
+{
+  FAR struct tmpfs_file_s *tfo = filep->f_priv;
+  off_t pos = filep->f_pos;
+  FAR uint8_t *page;
+  int ret;
+
+  ret = tmpfs_lock_file(tfo);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  ref->pos = pos;
+  if (pos >= tfo->tfo_size)
+    {
+      ref->len  = 0;
+      ref->priv = NULL;
+    }
+  else
+    {
+      page = tfo->tfo_pages[TMPFS_PAGE(pos)];
+      if (page == NULL)
+        {
+          /* A hole reads as zeros, let the caller copy it */
+
+          tmpfs_unlock_file(tfo);
+          return -EAGAIN;
+        }
+
+      ref->data = page + (pos & TMPFS_PAGEMASK);
+      ref->len  = MIN(ref->len, tfo->tfo_size - pos);
+      ref->len  = MIN(ref->len, TMPFS_PAGESIZE - (pos & TMPFS_PAGEMASK));
+      ref->priv = page;
+    }
+
+  ref->flink       = tfo->tfo_splices;
+  tfo->tfo_splices = ref;
+
+  tmpfs_unlock_file(tfo);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: tmpfs_unsplice
+ ****************************************************************************/
+
+static void tmpfs_unsplice(FAR struct file *filep,
+                           FAR struct splice_ref_s *ref, size_t nused)
+{
+  FAR struct tmpfs_file_s *tfo = filep->f_priv;
+  FAR struct splice_ref_s **prev;
+  FAR uint8_t *page = ref->priv;
+
+  tmpfs_lock_file(tfo);
+
+  for (prev = &tfo->tfo_splices; *prev != ref; prev = &(*prev)->flink);
+  *prev = ref->flink;
+
+  /* Free the page if it was truncated away while it was lent */
+
+  if (page != NULL && !tmpfs_spliced(tfo, page) &&
+      (TMPFS_PAGE(ref->pos) >= tfo->tfo_npages ||
+       tfo->tfo_pages[TMPFS_PAGE(ref->pos)] != page))
+    {
+      fs_heap_free(page);
+    }
+
+  filep->f_pos += nused;
+  tmpfs_unlock_file(tfo);
+}
+#endif
+
 /****************************************************************************
  * Name: tmpfs_sync
  ****************************************************************************/
@@ -1963,14 +2443,16 @@ static int tmpfs_truncate(FAR struct file *filep, off_t length)
           goto errout_with_lock;
         }
 
+#ifndef CONFIG_FS_TMPFS_PAGED
       /* If the size has increased, then we need to zero the newly added
-       * memory.
+       * memory.  The paged storage leaves a hole instead.
        */
 
       if (length > oldsize)
         {
           memset(&tfo->tfo_data[oldsize], 0, length - oldsize);
         }
+#endif
 
       ret = OK;
     }
@@ -2413,7 +2895,7 @@ static int tmpfs_unlink(FAR struct inode *mountpt, FAR const char *relpath)
   else
     {
       nxrmutex_destroy(&tfo->tfo_lock);
-      fs_heap_free(tfo->tfo_data);
+      tmpfs_free_filedata(tfo);
       fs_heap_free(tfo);
     }
 
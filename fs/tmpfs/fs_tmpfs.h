@@ -126,7 +126,13 @@ struct tmpfs_file_s
 
   uint8_t       tfo_flags; /* See TFO_FLAG_* definitions */
   size_t        tfo_size;  /* Valid file size */
+#ifdef CONFIG_FS_TMPFS_PAGED
+  size_t        tfo_npages; /* Number of entries in the page table */
+  FAR uint8_t **tfo_pages;  /* Page table, NULL entries are holes */
+  FAR struct splice_ref_s *tfo_splices; /* Pages lent by splice */
+#else
   FAR uint8_t  *tfo_data;  /* File data starts here */
+#endif
 };
 
 /* This structure represents one instance of a TMPFS file system */
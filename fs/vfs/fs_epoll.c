@@ -40,6 +40,7 @@
 #include <nuttx/list.h>
 #include <nuttx/mutex.h>
 #include <nuttx/signal.h>
+#include <nuttx/spinlock.h>
 
 #include "inode/inode.h"
 #include "fs_heap.h"
@@ -50,9 +51,11 @@
 
 struct epoll_node_s
 {
-  struct list_node         node;
+  struct list_node         node;     /* Link in one of the epoll head lists */
+  struct list_node         rdnode;   /* Link in the ready list */
   epoll_data_t             data;
-  bool                     notified;
+  bool                     notified; /* Queued in the ready list */
+  bool                     disarmed; /* EPOLLONESHOT event already reported */
   struct pollfd            pfd;
   FAR struct epoll_head_s *eph;
 };
@@ -65,19 +68,28 @@ struct epoll_head_s
   int                   crefs;
   mutex_t               lock;
   sem_t                 sem;
+  spinlock_t            rdlock;   /* Protects the ready list, which is
+                                   * updated from the poll callbacks.
+                                   */
+  struct list_node      rdlist;   /* The ready list, store all the epoll
+                                   * node notified by their driver and not
+                                   * yet reported by epoll_wait.
+                                   */
   struct list_node      setup;    /* The setup list, store all the setuped
                                    * epoll node.
                                    */
-  struct list_node      teardown; /* The teardown list, store all the epoll
-                                   * node notified after epoll_wait finish,
-                                   * these epoll node should be setup again
-                                   * to check the pending poll notification.
+  struct list_node      teardown; /* The teardown list, store all the level
+                                   * triggered epoll node reported by the
+                                   * last epoll_wait, these epoll node should
+                                   * be setup again to check whether the
+                                   * event is still pending.
                                    */
   struct list_node      oneshot;  /* The oneshot list, store all the epoll
-                                   * node notified after epoll_wait and with
+                                   * node reported by epoll_wait with
                                    * EPOLLONESHOT events, these oneshot epoll
-                                   * nodes can be reset by epoll_ctl (move
-                                   * from oneshot list to the setup list).
+                                   * nodes are disarmed until reset by
+                                   * epoll_ctl (move from oneshot list to the
+                                   * setup list).
                                    */
   struct list_node      free;     /* The free list, store all the freed epoll
                                    * node.
@@ -199,6 +211,16 @@ static int epoll_do_close(FAR struct file *filep)
           poll_fdsetup(epn->pfd.fd, &epn->pfd, false);
         }
 
+      list_for_every_entry(&eph->teardown, epn, epoll_node_t, node)
+        {
+          poll_fdsetup(epn->pfd.fd, &epn->pfd, false);
+        }
+
+      list_for_every_entry(&eph->oneshot, epn, epoll_node_t, node)
+        {
+          poll_fdsetup(epn->pfd.fd, &epn->pfd, false);
+        }
+
       list_for_every_entry_safe(&eph->extend, epn, tmp, epoll_node_t, node)
         {
           list_delete(&epn->node);
@@ -235,11 +257,13 @@ static int epoll_do_create(int size, int flags)
   eph->size = size;
   nxmutex_init(&eph->lock);
   nxsem_init(&eph->sem, 0, 0);
+  spin_lock_init(&eph->rdlock);
 
   /* List initialize */
 
   epn = (FAR epoll_node_t *)(eph + 1);
 
+  list_initialize(&eph->rdlist);
   list_initialize(&eph->setup);
   list_initialize(&eph->teardown);
   list_initialize(&eph->oneshot);
@@ -266,11 +290,116 @@ static int epoll_do_create(int size, int flags)
   return fd;
 }
 
+/****************************************************************************
+ * Name: epoll_find
+ *
+ * Description:
+ *   Find the epoll node of a file descriptor.  The caller must hold the
+ *   epoll head lock.
+ *
+ ****************************************************************************/
+
+static FAR epoll_node_t *epoll_find(FAR epoll_head_t *eph, int fd)
+{
+  FAR epoll_node_t *epn;
+
+  list_for_every_entry(&eph->setup, epn, epoll_node_t, node)
+    {
+      if (epn->pfd.fd == fd)
+        {
+          return epn;
+        }
+    }
+
+  list_for_every_entry(&eph->teardown, epn, epoll_node_t, node)
+    {
+      if (epn->pfd.fd == fd)
+        {
+          return epn;
+        }
+    }
+
+  list_for_every_entry(&eph->oneshot, epn, epoll_node_t, node)
+    {
+      if (epn->pfd.fd == fd)
+        {
+          return epn;
+        }
+    }
+
+  return NULL;
+}
+
+/****************************************************************************
+ * Name: epoll_unqueue
+ *
+ * Description:
+ *   Remove the epoll node from the ready list, if it is queued there, and
+ *   discard the events collected so far.
+ *
+ ****************************************************************************/
+
+static void epoll_unqueue(FAR epoll_node_t *epn)
+{
+  FAR epoll_head_t *eph = epn->eph;
+  irqstate_t flags;
+
+  flags = spin_lock_irqsave(&eph->rdlock);
+  if (epn->notified)
+    {
+      list_delete(&epn->rdnode);
+      epn->notified = false;
+    }
+
+  epn->pfd.revents = 0;
+  spin_unlock_irqrestore(&eph->rdlock, flags);
+}
+
+/****************************************************************************
+ * Name: epoll_drop
+ *
+ * Description:
+ *   Return an epoll node that is no longer attached to its driver to the
+ *   free list.
+ *
+ ****************************************************************************/
+
+static void epoll_drop(FAR epoll_node_t *epn)
+{
+  epoll_unqueue(epn);
+  list_delete(&epn->node);
+  list_add_tail(&epn->eph->free, &epn->node);
+}
+
+/****************************************************************************
+ * Name: epoll_rearm
+ *
+ * Description:
+ *   Detach the epoll node from its driver and attach it again.  The driver
+ *   reports the events that are pending right now during setup, so this is
+ *   how a level triggered or a reset oneshot node picks up the current
+ *   state of the fd.  If the setup fails, the node is left detached and
+ *   the caller must drop it.
+ *
+ ****************************************************************************/
+
+static int epoll_rearm(FAR epoll_node_t *epn)
+{
+  poll_fdsetup(epn->pfd.fd, &epn->pfd, false);
+  epoll_unqueue(epn);
+  epn->disarmed = false;
+
+  return poll_fdsetup(epn->pfd.fd, &epn->pfd, true);
+}
+
 /****************************************************************************
  * Name: epoll_setup
  *
  * Description:
- *   Setup all the fd.
+ *   Setup again all the level triggered fd reported by the last
+ *   epoll_wait(), the event may still be pending.  A fd that cannot be
+ *   setup again, for example because it was closed, is removed from the
+ *   epoll instance.
  *
  * Input Parameters:
  *   eph       - The epoll head pointer
@@ -294,18 +423,13 @@ static int epoll_setup(FAR epoll_head_t *eph)
 
   list_for_every_entry_safe(&eph->teardown, epn, tepn, epoll_node_t, node)
     {
-      /* Setup again to check the notified pollfd last epoll_wait() to
-       * cover the situation several poll event pending on one fd.
-       */
-
-      epn->notified    = false;
-      epn->pfd.revents = 0;
-      ret = poll_fdsetup(epn->pfd.fd, &epn->pfd, true);
+      ret = epoll_rearm(epn);
       if (ret < 0)
         {
           ferr("epoll setup failed, fd=%d, events=%08" PRIx32 ", ret=%d\n",
                epn->pfd.fd, epn->pfd.events, ret);
-          break;
+          epoll_drop(epn);
+          continue;
         }
 
       list_delete(&epn->node);
@@ -313,15 +437,17 @@ static int epoll_setup(FAR epoll_head_t *eph)
     }
 
   nxmutex_unlock(&eph->lock);
-  return ret;
+  return OK;
 }
 
 /****************************************************************************
  * Name: epoll_teardown
  *
  * Description:
- *   Teardown all the notifed fd and check the notified fd's event with user
- *   expected event.
+ *   Drain the ready list and report the notified fd whose events are also
+ *   user expected.  Only the fd queued by their poll callback are visited,
+ *   the other registered fd are not touched.  The nodes are taken one at a
+ *   time under the ready list lock, evs[] is written without it.
  *
  * Input Parameters:
  *   eph       - The epoll head pointer
@@ -337,41 +463,60 @@ static int epoll_setup(FAR epoll_head_t *eph)
 static int epoll_teardown(FAR epoll_head_t *eph, FAR struct epoll_event *evs,
                           int maxevents)
 {
-  FAR epoll_node_t *tepn;
   FAR epoll_node_t *epn;
+  irqstate_t flags;
+  pollevent_t revents;
   int i = 0;
 
   nxmutex_lock(&eph->lock);
 
-  list_for_every_entry_safe(&eph->setup, epn, tepn, epoll_node_t, node)
+  while (i < maxevents)
     {
-      /* Only check the notifed fd */
+      flags = spin_lock_irqsave(&eph->rdlock);
+      if (list_is_empty(&eph->rdlist))
+        {
+          spin_unlock_irqrestore(&eph->rdlock, flags);
+          break;
+        }
 
-      if (!epn->notified)
+      epn = container_of(list_remove_head(&eph->rdlist), epoll_node_t,
+                         rdnode);
+      epn->notified    = false;
+      revents          = epn->pfd.revents;
+      epn->pfd.revents = 0;
+
+      /* A oneshot node stays attached to its driver but is ignored until
+       * epoll_ctl(EPOLL_CTL_MOD) resets it.
+       */
+
+      if (revents != 0 && (epn->pfd.events & EPOLLONESHOT) != 0)
+        {
+          epn->disarmed = true;
+        }
+
+      spin_unlock_irqrestore(&eph->rdlock, flags);
+
+      if (revents == 0)
         {
           continue;
         }
 
-      /* Teradown all the notified fd */
+      evs[i].data     = epn->data;
+      evs[i++].events = revents;
 
-      poll_fdsetup(epn->pfd.fd, &epn->pfd, false);
-      list_delete(&epn->node);
+      /* A level triggered node is checked again by the next epoll_wait().
+       * An edge triggered node waits for the next notification of its
+       * driver.
+       */
 
-      if (epn->pfd.revents != 0 && i < maxevents)
+      if (epn->disarmed)
         {
-          evs[i].data     = epn->data;
-          evs[i++].events = epn->pfd.revents;
-          if ((epn->pfd.events & EPOLLONESHOT) != 0)
-            {
-              list_add_tail(&eph->oneshot, &epn->node);
-            }
-          else
-            {
-              list_add_tail(&eph->teardown, &epn->node);
-            }
+          list_delete(&epn->node);
+          list_add_tail(&eph->oneshot, &epn->node);
         }
-      else
+      else if ((epn->pfd.events & EPOLLET) == 0)
         {
+          list_delete(&epn->node);
           list_add_tail(&eph->teardown, &epn->node);
         }
     }
@@ -385,7 +530,8 @@ static int epoll_teardown(FAR epoll_head_t *eph, FAR struct epoll_event *evs,
  *
  * Description:
  *   The default epoll callback function, this function do the final step of
- *   poll notification.
+ *   poll notification: queue the epoll node to the ready list and wake up
+ *   the waiter.  It may be called from the interrupt context.
  *
  * Input Parameters:
  *   fds - The fds
@@ -398,15 +544,104 @@ static int epoll_teardown(FAR epoll_head_t *eph, FAR struct epoll_event *evs,
 static void epoll_default_cb(FAR struct pollfd *fds)
 {
   FAR epoll_node_t *epn = fds->arg;
+  FAR epoll_head_t *eph = epn->eph;
+  irqstate_t flags;
   int semcount = 0;
 
-  epn->notified = true;
-  if (fds->revents != 0)
+  if (fds->revents == 0)
     {
-      nxsem_get_value(&epn->eph->sem, &semcount);
-      if (semcount < 1)
+      return;
+    }
+
+  flags = spin_lock_irqsave(&eph->rdlock);
+  if (epn->disarmed)
+    {
+      fds->revents = 0;
+      spin_unlock_irqrestore(&eph->rdlock, flags);
+      return;
+    }
+
+  if (!epn->notified)
+    {
+      epn->notified = true;
+      list_add_tail(&eph->rdlist, &epn->rdnode);
+    }
+
+  spin_unlock_irqrestore(&eph->rdlock, flags);
+
+  nxsem_get_value(&eph->sem, &semcount);
+  if (semcount < 1)
+    {
+      nxsem_post(&eph->sem);
+    }
+}
+
+/****************************************************************************
+ * Name: epoll_do_wait
+ *
+ * Description:
+ *   Wait until one of the registered fd is ready or the timeout expires,
+ *   then report the ready fd.
+ *
+ * Input Parameters:
+ *   eph       - The epoll head pointer
+ *   evs       - The epoll events array
+ *   maxevents - The epoll events array size
+ *   timeout   - The timeout in milliseconds, -1 to wait forever
+ *   sigmask   - The signal mask to apply while waiting, or NULL
+ *
+ * Returned Value:
+ *   The number of reported fd on success, negative on fail
+ *
+ ****************************************************************************/
+
+static int epoll_do_wait(FAR epoll_head_t *eph, FAR struct epoll_event *evs,
+                         int maxevents, int timeout,
+                         FAR const sigset_t *sigmask)
+{
+  sigset_t oldsigmask;
+  int num;
+  int ret;
+
+  for (; ; )
+    {
+      ret = epoll_setup(eph);
+      if (ret < 0)
         {
-          nxsem_post(&epn->eph->sem);
+          return ret;
+        }
+
+      /* Report what is already queued without waiting */
+
+      num = epoll_teardown(eph, evs, maxevents);
+      if (num > 0 || timeout == 0)
+        {
+          return num;
+        }
+
+      /* Wait the poll ready */
+
+      nxsig_procmask(SIG_SETMASK, sigmask, &oldsigmask);
+
+      if (timeout > 0)
+        {
+          ret = nxsem_tickwait(&eph->sem, MSEC2TICK(timeout));
+        }
+      else
+        {
+          ret = nxsem_wait(&eph->sem);
+        }
+
+      nxsig_procmask(SIG_SETMASK, &oldsigmask, NULL);
+      if (ret < 0 && ret != -ETIMEDOUT)
+        {
+          return ret;
+        }
+
+      num = epoll_teardown(eph, evs, maxevents);
+      if (num > 0 || ret == -ETIMEDOUT)
+        {
+          return num;
         }
     }
 }
@@ -502,31 +737,10 @@ int epoll_ctl(int epfd, int op, int fd, FAR struct epoll_event *ev)
 
         /* Check repetition */
 
-        list_for_every_entry(&eph->setup, epn, epoll_node_t, node)
-          {
-            if (epn->pfd.fd == fd)
-              {
-                ret = -EEXIST;
-                goto err;
-              }
-          }
-
-        list_for_every_entry(&eph->teardown, epn, epoll_node_t, node)
-          {
-            if (epn->pfd.fd == fd)
-              {
-                ret = -EEXIST;
-                goto err;
-              }
-          }
-
-        list_for_every_entry(&eph->oneshot, epn, epoll_node_t, node)
+        if (epoll_find(eph, fd) != NULL)
           {
-            if (epn->pfd.fd == fd)
-              {
-                ret = -EEXIST;
-                goto err;
-              }
+            ret = -EEXIST;
+            goto err;
           }
 
         if (list_is_empty(&eph->free))
@@ -557,129 +771,64 @@ int epoll_ctl(int epfd, int op, int fd, FAR struct epoll_event *ev)
         epn->eph         = eph;
         epn->data        = ev->data;
         epn->notified    = false;
-        epn->pfd.events  = ev->events | POLLALWAYS;
+        epn->disarmed    = false;
+        epn->pfd.events  = ev->events;
         epn->pfd.fd      = fd;
         epn->pfd.arg     = epn;
         epn->pfd.cb      = epoll_default_cb;
         epn->pfd.revents = 0;
 
+        /* The node stays attached to the driver until EPOLL_CTL_DEL, the
+         * driver queues it to the ready list whenever the fd gets ready.
+         */
+
+        list_add_tail(&eph->setup, &epn->node);
         ret = poll_fdsetup(fd, &epn->pfd, true);
         if (ret < 0)
           {
-            list_add_tail(&eph->free, &epn->node);
+            epoll_drop(epn);
             goto err;
           }
 
-        list_add_tail(&eph->setup, &epn->node);
         break;
 
       case EPOLL_CTL_DEL:
         finfo("%p CTL DEL: fd=%d\n", eph, fd);
-        list_for_every_entry(&eph->setup, epn, epoll_node_t, node)
-          {
-            if (epn->pfd.fd == fd)
-              {
-                poll_fdsetup(fd, &epn->pfd, false);
-                list_delete(&epn->node);
-                list_add_tail(&eph->free, &epn->node);
-                goto out;
-              }
-          }
-
-        list_for_every_entry(&eph->teardown, epn, epoll_node_t, node)
+        epn = epoll_find(eph, fd);
+        if (epn != NULL)
           {
-            if (epn->pfd.fd == fd)
-              {
-                list_delete(&epn->node);
-                list_add_tail(&eph->free, &epn->node);
-                goto out;
-              }
-          }
-
-        list_for_every_entry(&eph->oneshot, epn, epoll_node_t, node)
-          {
-            if (epn->pfd.fd == fd)
-              {
-                list_delete(&epn->node);
-                list_add_tail(&eph->free, &epn->node);
-                goto out;
-              }
+            poll_fdsetup(fd, &epn->pfd, false);
+            epoll_drop(epn);
           }
 
         break;
 
       case EPOLL_CTL_MOD:
         finfo("%p CTL MOD: fd=%d ev=%08" PRIx32 "\n", eph, fd, ev->events);
-        list_for_every_entry(&eph->setup, epn, epoll_node_t, node)
+        epn = epoll_find(eph, fd);
+        if (epn != NULL)
           {
-            if (epn->pfd.fd == fd)
-              {
-                if (epn->pfd.events != (ev->events | POLLALWAYS))
-                  {
-                    poll_fdsetup(fd, &epn->pfd, false);
-
-                    epn->notified    = false;
-                    epn->data        = ev->data;
-                    epn->pfd.events  = ev->events | POLLALWAYS;
-                    epn->pfd.fd      = fd;
-                    epn->pfd.revents = 0;
-
-                    ret = poll_fdsetup(fd, &epn->pfd, true);
-                    if (ret < 0)
-                      {
-                        goto err;
-                      }
-                  }
+            epn->data = ev->data;
 
-                goto out;
-              }
-          }
+            /* Nothing to do if the events are unchanged and the node is
+             * still armed.
+             */
 
-        list_for_every_entry(&eph->teardown, epn, epoll_node_t, node)
-          {
-            if (epn->pfd.fd == fd)
+            if (epn->pfd.events != ev->events || epn->disarmed)
               {
-                if (epn->pfd.events != (ev->events | POLLALWAYS))
-                  {
-                    epn->notified    = false;
-                    epn->data        = ev->data;
-                    epn->pfd.events  = ev->events | POLLALWAYS;
-                    epn->pfd.fd      = fd;
-                    epn->pfd.revents = 0;
-
-                    ret = poll_fdsetup(fd, &epn->pfd, true);
-                    if (ret < 0)
-                      {
-                        goto err;
-                      }
-
-                    list_delete(&epn->node);
-                    list_add_tail(&eph->setup, &epn->node);
-                  }
-
-                goto out;
-              }
-          }
+                epn->pfd.events = ev->events;
 
-        list_for_every_entry(&eph->oneshot, epn, epoll_node_t, node)
-          {
-            if (epn->pfd.fd == fd)
-              {
-                epn->notified    = false;
-                epn->data        = ev->data;
-                epn->pfd.events  = ev->events | POLLALWAYS;
-                epn->pfd.fd      = fd;
-                epn->pfd.revents = 0;
+                /* A node that cannot be attached again is removed */
 
-                ret = poll_fdsetup(fd, &epn->pfd, true);
+                ret = epoll_rearm(epn);
                 if (ret < 0)
                   {
+                    epoll_drop(epn);
                     goto err;
                   }
 
                 list_delete(&epn->node);
                 list_add_tail(&eph->setup, &epn->node);
-                break;
               }
           }
 
@@ -690,7 +839,6 @@ int epoll_ctl(int epfd, int op, int fd, FAR struct epoll_event *ev)
         goto err;
     }
 
-out:
   nxmutex_unlock(&eph->lock);
   fs_putfilep(filep);
   return OK;
@@ -711,7 +859,6 @@ int epoll_pwait(int epfd, FAR struct epoll_event *evs,
 {
   FAR struct file *filep;
   FAR epoll_head_t *eph;
-  sigset_t oldsigmask;
   int ret;
 
   eph = epoll_head_from_fd(epfd, &filep);
@@ -720,46 +867,12 @@ int epoll_pwait(int epfd, FAR struct epoll_event *evs,
       goto out;
     }
 
-retry:
-  ret = epoll_setup(eph);
+  ret = epoll_do_wait(eph, evs, maxevents, timeout, sigmask);
   if (ret < 0)
     {
       goto err;
     }
 
-  /* Wait the poll ready */
-
-  nxsig_procmask(SIG_SETMASK, sigmask, &oldsigmask);
-
-  if (timeout == 0)
-    {
-      ret = -ETIMEDOUT;
-    }
-  else if (timeout > 0)
-    {
-      ret = nxsem_tickwait(&eph->sem, MSEC2TICK(timeout));
-    }
-  else
-    {
-      ret = nxsem_wait(&eph->sem);
-    }
-
-  nxsig_procmask(SIG_SETMASK, &oldsigmask, NULL);
-  if (ret < 0 && ret != -ETIMEDOUT)
-    {
-      goto err;
-    }
-  else /* ret >= 0 or ret == -ETIMEDOUT */
-    {
-      int num = epoll_teardown(eph, evs, maxevents);
-      if (num == 0 && ret >= 0)
-        {
-          goto retry;
-        }
-
-      ret = num;
-    }
-
   fs_putfilep(filep);
   return ret;
 
@@ -785,60 +898,5 @@ out:
 int epoll_wait(int epfd, FAR struct epoll_event *evs,
                int maxevents, int timeout)
 {
-  FAR struct file *filep;
-  FAR epoll_head_t *eph;
-  int ret;
-
-  eph = epoll_head_from_fd(epfd, &filep);
-  if (eph == NULL)
-    {
-      goto out;
-    }
-
-retry:
-  ret = epoll_setup(eph);
-  if (ret < 0)
-    {
-      goto err;
-    }
-
-  /* Wait the poll ready */
-
-  if (timeout == 0)
-    {
-      ret = -ETIMEDOUT;
-    }
-  else if (timeout > 0)
-    {
-      ret = nxsem_tickwait(&eph->sem, MSEC2TICK(timeout));
-    }
-  else
-    {
-      ret = nxsem_wait(&eph->sem);
-    }
-
-  if (ret < 0 && ret != -ETIMEDOUT)
-    {
-      goto err;
-    }
-  else /* ret >= 0 or ret == -ETIMEDOUT */
-    {
-      int num = epoll_teardown(eph, evs, maxevents);
-      if (num == 0 && ret >= 0)
-        {
-          goto retry;
-        }
-
-      ret = num;
-    }
-
-  fs_putfilep(filep);
-  return ret;
-
-err:
-  fs_putfilep(filep);
-  set_errno(-ret);
-out:
-  ferr("epoll wait failed:%d, timeout:%d\n", errno, timeout);
-  return ERROR;
+  return epoll_pwait(epfd, evs, maxevents, timeout, NULL);
 }
@@ -194,6 +194,9 @@ next_subdir:
   /* Copy the inode state from the old inode to the newly allocated inode */
 
   newinode->i_child   = oldinode->i_child;   /* Link to lower level inode */
+#if CONFIG_PSEUDOFS_HASHSIZE > 0
+  inode_hashmove(newinode);
+#endif
   newinode->i_flags   = oldinode->i_flags;   /* Flags for inode */
   newinode->u.i_ops   = oldinode->u.i_ops;   /* Inode operations */
 #ifdef CONFIG_PSEUDOFS_ATTRIBUTES
@@ -37,16 +37,79 @@
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: copyfile_splice
+ *
+ * Description:
+ *   Borrow the data at the read position of the infile with the splice
+ *   method of its mount point and write it to the outfile straight from
+ *   the memory of the infile, without copying it through the I/O buffer.
+ *   The unsplice method then consumes the bytes actually written.  No lock
+ *   of the infile is held while writing.
+ *
+ * Returned Value:
+ *   If *spliced is set, the number of bytes written, zero at the end of
+ *   the infile or a negated errno value returned by the write.  Otherwise
+ *   the infile lent nothing and a negated errno value is returned: -EAGAIN
+ *   if nothing can be lent at the moment, anything else if the infile does
+ *   not support splicing.
+ *
+ ****************************************************************************/
+
+static ssize_t copyfile_splice(FAR struct file *outfile,
+                               FAR struct file *infile, size_t count,
+                               FAR bool *spliced)
+{
+#ifndef CONFIG_DISABLE_MOUNTPOINT
+  FAR struct inode *inode = infile->f_inode;
+  struct splice_ref_s ref;
+  ssize_t nbyteswritten = 0;
+  int ret;
+
+  if (INODE_IS_MOUNTPT(inode) && inode->u.i_mops->splice != NULL)
+    {
+      ref.data = NULL;
+      ref.len  = count;
+
+      ret = inode->u.i_mops->splice(infile, &ref);
+      if (ret < 0)
+        {
+          *spliced = false;
+          return ret;
+        }
+
+      *spliced = true;
+      if (ref.len > 0)
+        {
+          nbyteswritten = file_write(outfile, ref.data, ref.len);
+        }
+
+      inode->u.i_mops->unsplice(infile, &ref,
+                                nbyteswritten > 0 ? nbyteswritten : 0);
+      return nbyteswritten;
+    }
+#endif
+
+  *spliced = false;
+  return -ENOSYS;
+}
+
+/****************************************************************************
+ * Name: copyfile
+ ****************************************************************************/
+
 static ssize_t copyfile(FAR struct file *outfile, FAR struct file *infile,
                         FAR off_t *offset, size_t count)
 {
-  FAR uint8_t *iobuffer;
+  FAR uint8_t *iobuffer = NULL;
   FAR uint8_t *wrbuffer;
   off_t startpos = 0;
   ssize_t nbytesread;
   ssize_t nbyteswritten;
   size_t  ntransferred;
   bool endxfr;
+  bool spliced;
+  bool splice;
 
   /* Get the current file position. */
 
@@ -71,18 +134,74 @@ static ssize_t copyfile(FAR struct file *outfile, FAR struct file *infile,
         }
     }
 
-  /* Allocate an I/O buffer */
+  /* Data lent by the infile is not written back to the same file, the
+   * write would modify the data while it is referenced.
+   */
 
-  iobuffer = fs_heap_malloc(CONFIG_SENDFILE_BUFSIZE);
-  if (!iobuffer)
-    {
-      return -ENOMEM;
-    }
+  splice = infile->f_inode != outfile->f_inode ||
+           infile->f_priv != outfile->f_priv;
 
   /* Now transfer 'count' bytes from the infile to the outfile */
 
   for (ntransferred = 0, endxfr = false; ntransferred < count && !endxfr; )
     {
+      /* Write the data of the infile in place if it can be referenced */
+
+      if (splice)
+        {
+          nbyteswritten = copyfile_splice(outfile, infile,
+                                          count - ntransferred, &spliced);
+          if (spliced)
+            {
+              if (nbyteswritten > 0)
+                {
+                  ntransferred += nbyteswritten;
+                }
+              else if (nbyteswritten == 0)
+                {
+                  /* End of file */
+
+                  endxfr = true;
+                }
+              else if (nbyteswritten != -EINTR || ntransferred == 0)
+                {
+                  /* Write error.  Break out and return the error
+                   * condition.
+                   */
+
+                  ntransferred = nbyteswritten;
+                  endxfr       = true;
+                }
+
+              continue;
+            }
+
+          /* Copy this buffer if the infile has nothing to lend right now,
+           * and everything else if it does not support splicing at all.
+           */
+
+          if (nbyteswritten != -EAGAIN)
+            {
+              splice = false;
+            }
+        }
+
+      /* Allocate an I/O buffer */
+
+      if (iobuffer == NULL)
+        {
+          iobuffer = fs_heap_malloc(CONFIG_SENDFILE_BUFSIZE);
+          if (iobuffer == NULL)
+            {
+              if (ntransferred == 0)
+                {
+                  ntransferred = -ENOMEM;
+                }
+
+              break;
+            }
+        }
+
       /* Loop until the read side of the transfer comes to some conclusion */
 
       do
@@ -196,7 +315,10 @@ static ssize_t copyfile(FAR struct file *outfile, FAR struct file *infile,
 
   /* Release the I/O buffer */
 
-  fs_heap_free(iobuffer);
+  if (iobuffer != NULL)
+    {
+      fs_heap_free(iobuffer);
+    }
 
   /* Return the current file position */
 
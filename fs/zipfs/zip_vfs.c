@@ -26,6 +26,7 @@
 #include <errno.h>
 #include <fcntl.h>
 #include <string.h>
+#include <sys/param.h>
 #include <sys/stat.h>
 #include <sys/statfs.h>
 #include <nuttx/mutex.h>
@@ -37,6 +38,14 @@
 
 #include "fs_heap.h"
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifdef CONFIG_ZIPFS_SEEK_INDEX
+#  define ZIPFS_INDEX_SPAN  ((off_t)CONFIG_ZIPFS_SEEK_INDEX_SPAN * 1024)
+#endif
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -54,11 +63,48 @@ struct zipfs_mountpt_s
   char abspath[1];
 };
 
+#ifdef CONFIG_ZIPFS_SEEK_INDEX
+/* A point of the seek index: the state needed to resume inflating a
+ * deflated entry at an uncompressed offset, as in zlib's examples/zran.c.
+ */
+
+struct zipfs_point_s
+{
+  off_t out;                    /* Uncompressed offset */
+  off_t in;                     /* Offset of the first full input byte */
+  int bits;                     /* Bits of the previous input byte, or 0 */
+  uInt have;                    /* Size of the window */
+  FAR Bytef *window;            /* Uncompressed data preceding 'out' */
+};
+
+/* An indexed entry is inflated here rather than by minizip, reading the
+ * compressed data straight from the archive.
+ */
+
+struct zipfs_index_s
+{
+  struct file file;             /* The archive */
+  z_stream strm;                /* Raw inflate state */
+  off_t datapos;                /* Offset of the compressed data */
+  off_t compsize;               /* Size of the compressed data */
+  off_t inread;                 /* Compressed bytes read so far */
+  off_t out;                    /* Current uncompressed offset */
+  bool eof;                     /* The end of the stream was reached */
+  unsigned int npoints;         /* Number of points */
+  unsigned int nalloc;          /* Allocated number of points */
+  FAR struct zipfs_point_s *points;
+  Bytef inbuf[CONFIG_ZIPFS_SEEK_BUFSIZE];
+};
+#endif
+
 struct zipfs_file_s
 {
   unzFile uf;
   mutex_t lock;
   FAR char *seekbuf;
+#ifdef CONFIG_ZIPFS_SEEK_INDEX
+  FAR struct zipfs_index_s *index;
+#endif
   char relpath[1];
 };
 
@@ -220,6 +266,20 @@ static int zipfs_real_error(voidpf opaque, voidpf stream)
   return OK;
 }
 
+static int zipfs_alloc_seekbuf(FAR struct zipfs_file_s *fp)
+{
+  if (fp->seekbuf == NULL)
+    {
+      fp->seekbuf = fs_heap_malloc(CONFIG_ZIPFS_SEEK_BUFSIZE);
+      if (fp->seekbuf == NULL)
+        {
+          return -ENOMEM;
+        }
+    }
+
+  return OK;
+}
+
 static int zipfs_convert_result(int ziperr)
 {
   switch (ziperr)
@@ -239,6 +299,326 @@ static int zipfs_convert_result(int ziperr)
     }
 }
 
+#ifdef CONFIG_ZIPFS_SEEK_INDEX
+static int zipfs_index_open(FAR struct zipfs_mountpt_s *fs,
+                            FAR struct zipfs_file_s *fp)
+{
+  FAR struct zipfs_index_s *index;
+  unz_file_info64 file_info;
+  int ret;
+
+  ret = unzGetCurrentFileInfo64(fp->uf, &file_info,
+                                NULL, 0, NULL, 0, NULL, 0);
+  ret = zipfs_convert_result(ret);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  /* Stored entries are cheap to skip and encrypted ones must go through
+   * minizip, only plain deflated entries are indexed.
+   */
+
+  if (file_info.compression_method != Z_DEFLATED ||
+      (file_info.flag & 1) != 0)
+    {
+      return OK;
+    }
+
+  index = fs_heap_zalloc(sizeof(*index));
+  if (index == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  ret = file_open(&index->file, fs->abspath, O_RDONLY);
+  if (ret < 0)
+    {
+      goto err_with_index;
+    }
+
+  if (inflateInit2(&index->strm, -MAX_WBITS) != Z_OK)
+    {
+      ret = -ENOMEM;
+      goto err_with_file;
+    }
+
+  index->datapos  = unzGetCurrentFileZStreamPos64(fp->uf);
+  index->compsize = file_info.compressed_size;
+
+  ret = file_seek(&index->file, index->datapos, SEEK_SET);
+  if (ret < 0)
+    {
+      inflateEnd(&index->strm);
+      goto err_with_file;
+    }
+
+  fp->index = index;
+  return OK;
+
+err_with_file:
+  file_close(&index->file);
+err_with_index:
+  fs_heap_free(index);
+  return ret;
+}
+
+static void zipfs_index_close(FAR struct zipfs_index_s *index)
+{
+  unsigned int i;
+
+  for (i = 0; i < index->npoints; i++)
+    {
+      fs_heap_free(index->points[i].window);
+    }
+
+  inflateEnd(&index->strm);
+  file_close(&index->file);
+  fs_heap_free(index->points);
+  fs_heap_free(index);
+}
+
+static int zipfs_index_fill(FAR struct zipfs_index_s *index)
+{
+  ssize_t nread;
+
+  nread = MIN(index->compsize - index->inread,
+              (off_t)sizeof(index->inbuf));
+  if (nread <= 0)
+    {
+      return -EIO;
+    }
+
+  nread = file_read(&index->file, index->inbuf, nread);
+  if (nread <= 0)
+    {
+      return nread < 0 ? nread : -EIO;
+    }
+
+  index->strm.next_in  = index->inbuf;
+  index->strm.avail_in = nread;
+  index->inread       += nread;
+  return OK;
+}
+
+/* Record a point at the current block boundary.  The index only speeds up
+ * seeking, so running out of memory here is not an error.
+ */
+
+static void zipfs_index_addpoint(FAR struct zipfs_index_s *index)
+{
+  FAR struct zipfs_point_s *point;
+  FAR Bytef *window;
+  uInt have = 0;
+
+  if (index->npoints == index->nalloc)
+    {
+      unsigned int nalloc = index->nalloc ? index->nalloc * 2 : 8;
+
+      point = fs_heap_realloc(index->points, nalloc * sizeof(*point));
+      if (point == NULL)
+        {
+          return;
+        }
+
+      index->points = point;
+      index->nalloc = nalloc;
+    }
+
+  inflateGetDictionary(&index->strm, NULL, &have);
+  window = fs_heap_malloc(have);
+  if (window == NULL)
+    {
+      return;
+    }
+
+  inflateGetDictionary(&index->strm, window, &have);
+
+  point         = &index->points[index->npoints++];
+  point->out    = index->out;
+  point->in     = index->inread - index->strm.avail_in;
+  point->bits   = index->strm.data_type & 7;
+  point->have   = have;
+  point->window = window;
+}
+
+static ssize_t zipfs_index_read(FAR struct zipfs_index_s *index,
+                                FAR char *buffer, size_t buflen)
+{
+  FAR z_stream *strm = &index->strm;
+  off_t last;
+  uInt avail;
+  int ret;
+
+  strm->next_out  = (FAR Bytef *)buffer;
+  strm->avail_out = buflen;
+
+  while (strm->avail_out > 0 && !index->eof)
+    {
+      if (strm->avail_in == 0)
+        {
+          ret = zipfs_index_fill(index);
+          if (ret < 0)
+            {
+              return ret;
+            }
+        }
+
+      /* Stop at the block boundaries, where a point can be recorded */
+
+      avail = strm->avail_out;
+      ret = inflate(strm, Z_BLOCK);
+      index->out += avail - strm->avail_out;
+
+      if (ret == Z_STREAM_END)
+        {
+          index->eof = true;
+          break;
+        }
+      else if (ret != Z_OK)
+        {
+          return ret == Z_MEM_ERROR ? -ENOMEM : -EIO;
+        }
+
+      last = index->npoints ? index->points[index->npoints - 1].out : 0;
+      if ((strm->data_type & 128) != 0 && (strm->data_type & 64) == 0 &&
+          index->out - last >= ZIPFS_INDEX_SPAN)
+        {
+          zipfs_index_addpoint(index);
+        }
+    }
+
+  return buflen - strm->avail_out;
+}
+
+/* Restart inflating from a point, or from the start of the entry if the
+ * point is NULL.
+ */
+
+static int zipfs_index_restore(FAR struct zipfs_index_s *index,
+                               FAR struct zipfs_point_s *point)
+{
+  off_t in = 0;
+  int bits = 0;
+  int ret;
+
+  if (point != NULL)
+    {
+      in   = point->in;
+      bits = point->bits;
+    }
+
+  /* The bits left of a partially used byte are primed from that byte */
+
+  if (bits != 0)
+    {
+      in--;
+    }
+
+  ret = file_seek(&index->file, index->datapos + in, SEEK_SET);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  inflateReset(&index->strm);
+  index->strm.avail_in = 0;
+  index->inread        = in;
+  index->out           = 0;
+  index->eof           = false;
+
+  if (point == NULL)
+    {
+      return OK;
+    }
+
+  if (bits != 0)
+    {
+      ret = zipfs_index_fill(index);
+      if (ret < 0)
+        {
+          return ret;
+        }
+
+      inflatePrime(&index->strm, bits,
+                   index->strm.next_in[0] >> (8 - bits));
+      index->strm.next_in++;
+      index->strm.avail_in--;
+    }
+
+  inflateSetDictionary(&index->strm, point->window, point->have);
+  index->out = point->out;
+  return OK;
+}
+
+static off_t zipfs_index_seek(FAR struct zipfs_file_s *fp, off_t offset)
+{
+  FAR struct zipfs_index_s *index = fp->index;
+  FAR struct zipfs_point_s *point = NULL;
+  unsigned int lo = 0;
+  unsigned int hi = index->npoints;
+  ssize_t ret;
+
+  if (offset < 0)
+    {
+      return -EINVAL;
+    }
+
+  ret = zipfs_alloc_seekbuf(fp);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  /* Find the last point at or before the offset */
+
+  while (lo < hi)
+    {
+      unsigned int mid = (lo + hi) / 2;
+
+      if (index->points[mid].out <= offset)
+        {
+          lo = mid + 1;
+        }
+      else
+        {
+          hi = mid;
+        }
+    }
+
+  if (lo > 0)
+    {
+      point = &index->points[lo - 1];
+    }
+
+  /* Restart from the point unless the current position is closer */
+
+  if (offset < index->out || (point != NULL && point->out > index->out))
+    {
+      ret = zipfs_index_restore(index, point);
+      if (ret < 0)
+        {
+          return ret;
+        }
+    }
+
+  /* Inflate up to the offset, extending the index on the way */
+
+  while (index->out < offset)
+    {
+      ret = zipfs_index_read(index, fp->seekbuf,
+                             MIN(offset - index->out,
+                                 CONFIG_ZIPFS_SEEK_BUFSIZE));
+      if (ret <= 0)
+        {
+          break;
+        }
+    }
+
+  return ret < 0 ? ret : index->out;
+}
+#endif
+
 static int zipfs_open(FAR struct file *filep, FAR const char *relpath,
                       int oflags, mode_t mode)
 {
@@ -279,6 +659,15 @@ static int zipfs_open(FAR struct file *filep, FAR const char *relpath,
       goto err_with_zip;
     }
 
+#ifdef CONFIG_ZIPFS_SEEK_INDEX
+  fp->index = NULL;
+  ret = zipfs_index_open(fs, fp);
+  if (ret < 0)
+    {
+      goto err_with_zip;
+    }
+#endif
+
   if (ret == OK)
     {
       fp->seekbuf = NULL;
@@ -304,6 +693,13 @@ static int zipfs_close(FAR struct file *filep)
   int ret;
 
   ret = zipfs_convert_result(unzClose(fp->uf));
+#ifdef CONFIG_ZIPFS_SEEK_INDEX
+  if (fp->index != NULL)
+    {
+      zipfs_index_close(fp->index);
+    }
+#endif
+
   nxmutex_destroy(&fp->lock);
   fs_heap_free(fp->seekbuf);
   fs_heap_free(fp);
@@ -317,7 +713,18 @@ static ssize_t zipfs_read(FAR struct file *filep, FAR char *buffer,
   ssize_t ret;
 
   nxmutex_lock(&fp->lock);
-  ret = zipfs_convert_result(unzReadCurrentFile(fp->uf, buffer, buflen));
+#ifdef CONFIG_ZIPFS_SEEK_INDEX
+  if (fp->index != NULL)
+    {
+      ret = zipfs_index_read(fp->index, buffer, buflen);
+    }
+  else
+#endif
+    {
+      ret = zipfs_convert_result(unzReadCurrentFile(fp->uf, buffer,
+                                                    buflen));
+    }
+
   if (ret > 0)
     {
       filep->f_pos += ret;
@@ -330,14 +737,12 @@ static ssize_t zipfs_read(FAR struct file *filep, FAR char *buffer,
 static off_t zipfs_skip(FAR struct zipfs_file_s *fp, off_t amount)
 {
   off_t next = 0;
+  int ret;
 
-  if (fp->seekbuf == NULL)
+  ret = zipfs_alloc_seekbuf(fp);
+  if (ret < 0)
     {
-      fp->seekbuf = fs_heap_malloc(CONFIG_ZIPFS_SEEK_BUFSIZE);
-      if (fp->seekbuf == NULL)
-        {
-          return -ENOMEM;
-        }
+      return ret;
     }
 
   while (next < amount)
@@ -398,7 +803,21 @@ static off_t zipfs_seek(FAR struct file *filep, off_t offset,
     {
       goto err_with_lock;
     }
-  else if (filep->f_pos > offset)
+
+#ifdef CONFIG_ZIPFS_SEEK_INDEX
+  if (fp->index != NULL)
+    {
+      ret = zipfs_index_seek(fp, offset);
+      if (ret >= 0)
+        {
+          filep->f_pos = ret;
+        }
+
+      goto err_with_lock;
+    }
+#endif
+
+  if (filep->f_pos > offset)
     {
       ret = zipfs_convert_result(unzClose(fp->uf));
       if (ret < 0)
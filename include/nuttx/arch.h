@@ -769,6 +769,29 @@ uintptr_t pgalloc(uintptr_t brkaddr, unsigned int npages);
 void up_extraheaps_init(void);
 #endif
 
+/****************************************************************************
+ * Name: up_mprotect
+ *
+ * Description:
+ *   Set the access permissions of a page aligned region of memory.  An
+ *   access that the permissions do not allow raises a fault that the
+ *   architecture passes to mm_map_fault() before treating it as fatal.
+ *
+ * Input Parameters:
+ *   addr - The page aligned start of the region
+ *   len  - The length of the region, a multiple of the page size
+ *   prot - PROT_NONE or a combination of PROT_READ, PROT_WRITE and
+ *          PROT_EXEC
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_ARCH_HAVE_MPROTECT
+int up_mprotect(FAR void *addr, size_t len, int prot);
+#endif
+
 /****************************************************************************
  * Name: up_textheap_memalign
  *
@@ -292,6 +292,20 @@ struct block_operations
 #endif
 };
 
+/* A reference to the data of an open file, lent by the splice method of
+ * a mount point until the matching unsplice.  A length of zero means end
+ * of file.
+ */
+
+struct splice_ref_s
+{
+  FAR const void *data;             /* OUT: The data at the read position */
+  size_t len;                       /* IN: Bytes wanted, OUT: Bytes lent */
+  off_t pos;                        /* OUT: File position of the data */
+  FAR struct splice_ref_s *flink;   /* Private to the file system */
+  FAR void *priv;                   /* Private to the file system */
+};
+
 /* This structure is provided by a filesystem to describe a mount point.
  * Note that this structure differs from file_operations ONLY in the form of
  * the open method.  Once the file is opened, it can be accessed either as a
@@ -373,6 +387,18 @@ struct mountpt_operations
   CODE int     (*chstat)(FAR struct inode *mountpt, FAR const char *relpath,
                          FAR const struct stat *buf, int flags);
   CODE int     (*syncfs)(FAR struct inode *mountpt);
+
+  /* Zero-copy read used by sendfile().  splice lends the data at the read
+   * position without consuming it and returns -EAGAIN if nothing can be
+   * lent right now.  The data stays valid, even if the file is truncated,
+   * until unsplice ends the loan and consumes the 'nused' bytes that were
+   * used.  No lock is held in between.
+   */
+
+  CODE int     (*splice)(FAR struct file *filep,
+                         FAR struct splice_ref_s *ref);
+  CODE void    (*unsplice)(FAR struct file *filep,
+                           FAR struct splice_ref_s *ref, size_t nused);
 };
 #endif /* CONFIG_DISABLE_MOUNTPOINT */
 
@@ -413,6 +439,9 @@ struct inode
   FAR struct inode *i_parent;   /* Link to parent level inode */
   FAR struct inode *i_peer;     /* Link to same level inode */
   FAR struct inode *i_child;    /* Link to lower level inode */
+#if CONFIG_PSEUDOFS_HASHSIZE > 0
+  FAR struct inode *i_hash;     /* Link to next inode in the hash bucket */
+#endif
   atomic_short      i_crefs;    /* References to inode */
   uint16_t          i_flags;    /* Flags for inode */
   union inode_ops_u u;          /* Inode operations */
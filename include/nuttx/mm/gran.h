@@ -200,6 +200,30 @@ FAR void *gran_reserve(GRAN_HANDLE handle, uintptr_t start, size_t size);
 
 FAR void *gran_alloc(GRAN_HANDLE handle, size_t size);
 
+/****************************************************************************
+ * Name: gran_alloc_batch
+ *
+ * Description:
+ *   Allocate up to 'count' regions of the same size from the granule heap
+ *   with a single acquisition of the heap.  This is intended for drivers
+ *   that set up many equal-sized buffers at initialization.
+ *
+ * Input Parameters:
+ *   handle - The handle previously returned by gran_initialize
+ *   size   - The size of each memory region to allocate.
+ *   mem    - The array receiving the allocated regions.
+ *   count  - The number of regions to allocate.
+ *
+ * Returned Value:
+ *   The number of regions allocated and stored at the beginning of 'mem'.
+ *   This is less than 'count' if the heap is exhausted; the caller must
+ *   then free the regions it does not use with gran_free().
+ *
+ ****************************************************************************/
+
+size_t gran_alloc_batch(GRAN_HANDLE handle, size_t size,
+                        FAR void **mem, size_t count);
+
 /****************************************************************************
  * Name: gran_free
  *
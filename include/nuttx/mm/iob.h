@@ -96,6 +96,13 @@
 #  define IOB_BUFSIZE(p) CONFIG_IOB_BUFSIZE
 #endif
 
+#ifdef CONFIG_NETDEV_OFFLOAD
+/* Offload state of a network packet (io_flags) */
+
+#  define IOB_F_CSUM_PARTIAL (1 << 0) /* L4 checksum left to the device */
+#  define IOB_F_CSUM_VALID   (1 << 1) /* L4 checksum verified by device */
+#endif
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -103,8 +110,8 @@
 typedef CODE void (*iob_free_cb_t)(FAR void *data);
 
 /* Represents one I/O buffer.  A packet is contained by one or more I/O
- * buffers in a chain.  The io_pktlen is only valid for the I/O buffer at
- * the head of the chain.
+ * buffers in a chain.  The io_pktlen and the offload state are only valid
+ * for the I/O buffer at the head of the chain.
  */
 
 struct iob_s
@@ -127,6 +134,11 @@ struct iob_s
 #endif
   unsigned int io_pktlen; /* Total length of the packet */
 
+#ifdef CONFIG_NETDEV_OFFLOAD
+  uint16_t io_gsosize;  /* Segment size if the device splits the packet */
+  uint8_t  io_flags;    /* Offload state of the packet, see IOB_F_* */
+#endif
+
 #ifdef CONFIG_IOB_ALLOC
   iob_free_cb_t io_free;  /* Custom free callback */
   FAR uint8_t  *io_data;
@@ -168,6 +180,14 @@ struct iob_stats_s
   int nfree;
   int nwait;
   int nthrottle;
+#if defined(CONFIG_IOB_PERCPU_CACHE) && \
+    CONFIG_IOB_PERCPU_CACHE > 0
+  int ncached;                  /* Free buffers held by the per-CPU caches */
+  unsigned long nhits;          /* Allocations served by a per-CPU cache */
+  unsigned long nmisses;        /* Allocations that refilled a cache */
+  unsigned long ndrains;        /* Frees that drained a cache */
+  unsigned long ncontended;     /* Contended refills of the global list */
+#endif
 };
 
 /****************************************************************************
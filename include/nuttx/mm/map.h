@@ -72,6 +72,13 @@ struct mm_map_entry_s
                 FAR struct mm_map_entry_s *entry,
                 FAR void *start,
                 size_t length);
+
+  /* Mappings that are filled on demand implement the fault function to
+   * resolve an access to 'vaddr' that the current page permissions do not
+   * allow.  It returns OK if the access can be retried.
+   */
+
+  int (*fault)(FAR struct mm_map_entry_s *entry, FAR void *vaddr);
 };
 
 /* memory mapping structure for the task group */
@@ -327,4 +334,29 @@ FAR struct mm_map_entry_s *mm_map_find(FAR struct mm_map_s *mm,
 int mm_map_remove(FAR struct mm_map_s *mm,
                   FAR struct mm_map_entry_s *entry);
 
+/****************************************************************************
+ * Name: mm_map_fault
+ *
+ * Description:
+ *   Resolve an access fault through the mapping of the current task group
+ *   containing the faulting address.  This is called by the architecture
+ *   specific fault handler, in the context of the faulting task, and may
+ *   block.  It must not be called from an interrupt handler or with the
+ *   interrupts disabled.
+ *
+ *   Only the mappings of the current task group are searched, even in the
+ *   flat build where the other groups share the address space.  A fault
+ *   from a thread of another group is not resolved.
+ *
+ * Input Parameters:
+ *   vaddr - The faulting address
+ *
+ * Returned Value:
+ *   OK if the access can be retried.  -EFAULT if no mapping handles the
+ *   fault, or another negated errno value if the mapping failed to.
+ *
+ ****************************************************************************/
+
+int mm_map_fault(FAR void *vaddr);
+
 #endif /* __INCLUDE_NUTTX_MM_MAP_H */
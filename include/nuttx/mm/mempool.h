@@ -144,6 +144,17 @@ struct mempoolinfo_s
   unsigned long nwaiter;  /* This is the number of waiter for mempool */
 };
 
+#if defined(CONFIG_MM_HEAP_MEMPOOL_PERCPU_CACHE) && \
+    CONFIG_MM_HEAP_MEMPOOL_PERCPU_CACHE > 0
+struct mempool_cacheinfo_s
+{
+  unsigned long hits;     /* Allocations served by the per-CPU caches */
+  unsigned long misses;   /* Allocations that had to refill a cache */
+  unsigned long drains;   /* Frees that had to drain a full cache */
+  unsigned long cached;   /* Number of blocks held in the caches now */
+};
+#endif
+
 /****************************************************************************
  * Public Function Prototypes
  ****************************************************************************/
@@ -526,6 +537,22 @@ struct mallinfo_task
 mempool_multiple_info_task(FAR struct mempool_multiple_s *mpool,
                            FAR const struct malltask *task);
 
+/****************************************************************************
+ * Name: mempool_multiple_cacheinfo
+ * Description:
+ *   Get the statistics of the per-CPU caches of the multiple memory pool.
+ *
+ * Input Parameters:
+ *   mpool - The handle of multiple memory pool to be used.
+ *   info  - The location to return the statistics.
+ ****************************************************************************/
+
+#if defined(CONFIG_MM_HEAP_MEMPOOL_PERCPU_CACHE) && \
+    CONFIG_MM_HEAP_MEMPOOL_PERCPU_CACHE > 0
+void mempool_multiple_cacheinfo(FAR struct mempool_multiple_s *mpool,
+                                FAR struct mempool_cacheinfo_s *info);
+#endif
+
 #undef EXTERN
 #if defined(__cplusplus)
 }
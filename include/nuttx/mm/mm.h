@@ -394,6 +394,13 @@ struct mallinfo_task mm_mallinfo_task(FAR struct mm_heap_s *heap,
 size_t mm_heapfree(FAR struct mm_heap_s *heap);
 size_t mm_heapfree_largest(FAR struct mm_heap_s *heap);
 
+#if defined(CONFIG_MM_HEAP_MEMPOOL_PERCPU_CACHE) && \
+    CONFIG_MM_HEAP_MEMPOOL_PERCPU_CACHE > 0
+struct mempool_cacheinfo_s;
+void mm_mempool_cacheinfo(FAR struct mm_heap_s *heap,
+                          FAR struct mempool_cacheinfo_s *info);
+#endif
+
 /* Functions contained in kmm_mallinfo.c ************************************/
 
 #ifdef CONFIG_MM_KERNEL_HEAP
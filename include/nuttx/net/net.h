@@ -181,6 +181,19 @@ struct sock_intf_s
                     FAR struct file *infile, FAR off_t *offset,
                     size_t count);
 #endif
+
+  /* Optional batched operations of sendmmsg() and recvmmsg().  They return
+   * the number of messages transferred under a single acquisition of the
+   * network lock.  si_recvmmsg() never blocks: it returns zero if nothing
+   * is queued, and the caller then falls back to si_recvmsg().
+   */
+
+  CODE int        (*si_sendmmsg)(FAR struct socket *psock,
+                    FAR struct mmsghdr *msgvec, unsigned int vlen,
+                    int flags);
+  CODE int        (*si_recvmmsg)(FAR struct socket *psock,
+                    FAR struct mmsghdr *msgvec, unsigned int vlen,
+                    int flags);
 };
 
 /* Each socket refers to a connection structure of type FAR void *.  Each
@@ -928,6 +941,60 @@ ssize_t psock_sendmsg(FAR struct socket *psock, FAR struct msghdr *msg,
 ssize_t psock_recvmsg(FAR struct socket *psock, FAR struct msghdr *msg,
                       int flags);
 
+/****************************************************************************
+ * Name: psock_sendmmsg
+ *
+ * Description:
+ *   psock_sendmmsg() sends several messages to a socket.  This is an
+ *   internal OS interface.  It is functionally equivalent to sendmmsg()
+ *   except that it is not a cancellation point, it does not modify the
+ *   errno variable and it accepts the internal socket structure as input.
+ *
+ * Input Parameters:
+ *   psock     A pointer to a NuttX-specific, internal socket structure
+ *   msgvec    The messages to send
+ *   vlen      The number of messages
+ *   flags     Send flags
+ *
+ * Returned Value:
+ *   On success, returns the number of messages sent; the msg_len field of
+ *   each of them holds the number of bytes sent.  If the first message
+ *   cannot be sent, a negated errno value is returned (see comments with
+ *   sendmsg() for a list of appropriate errno values).
+ *
+ ****************************************************************************/
+
+int psock_sendmmsg(FAR struct socket *psock, FAR struct mmsghdr *msgvec,
+                   unsigned int vlen, int flags);
+
+/****************************************************************************
+ * Name: psock_recvmmsg
+ *
+ * Description:
+ *   psock_recvmmsg() receives several messages from a socket.  This is an
+ *   internal OS interface.  It is functionally equivalent to recvmmsg()
+ *   except that it is not a cancellation point, it does not modify the
+ *   errno variable and it accepts the internal socket structure as input.
+ *
+ * Input Parameters:
+ *   psock     A pointer to a NuttX-specific, internal socket structure
+ *   msgvec    Buffers to receive the messages
+ *   vlen      The number of buffers
+ *   flags     Receive flags
+ *   timeout   Time after which no more message is waited for, may be NULL
+ *
+ * Returned Value:
+ *   On success, returns the number of messages received; the msg_len field
+ *   of each of them holds the number of bytes received.  If no message
+ *   could be received, a negated errno value is returned (see comments
+ *   with recvmsg() for a list of appropriate errno values).
+ *
+ ****************************************************************************/
+
+int psock_recvmmsg(FAR struct socket *psock, FAR struct mmsghdr *msgvec,
+                   unsigned int vlen, int flags,
+                   FAR const struct timespec *timeout);
+
 /****************************************************************************
  * Name: psock_send
  *
@@ -203,6 +203,25 @@
 #define IPv4BUF ((FAR struct ipv4_hdr_s *)IPBUF(0))
 #define IPv6BUF ((FAR struct ipv6_hdr_s *)IPBUF(0))
 
+/* Offloads a network device may support, see d_features */
+
+#ifdef CONFIG_NETDEV_OFFLOAD
+#  define NETDEV_F_TXCSUM      (1 << 0) /* Completes TCP/UDP checksums */
+#  define NETDEV_F_RXCSUM      (1 << 1) /* Verifies TCP/UDP checksums */
+#  define NETDEV_F_TSO4        (1 << 2) /* Splits large TCP/IPv4 packets */
+#  define NETDEV_F_TSO6        (1 << 3) /* Splits large TCP/IPv6 packets */
+#  define NETDEV_F_TSO         (NETDEV_F_TSO4 | NETDEV_F_TSO6)
+
+/* Offload state of the packet in d_iob */
+
+#  define NETDEV_GSOSIZE(dev)    ((dev)->d_iob->io_gsosize)
+#  define NETDEV_CSUM_VALID(dev) \
+     (((dev)->d_iob->io_flags & IOB_F_CSUM_VALID) != 0)
+#else
+#  define NETDEV_GSOSIZE(dev)    0
+#  define NETDEV_CSUM_VALID(dev) false
+#endif
+
 #ifdef CONFIG_NET_IPv6
 #  ifndef CONFIG_NETDEV_MAX_IPv6_ADDR
 #    define CONFIG_NETDEV_MAX_IPv6_ADDR 1
@@ -339,6 +358,16 @@ struct net_driver_s
 
   uint16_t d_pktsize;           /* Maximum packet size */
 
+#ifdef CONFIG_NETDEV_OFFLOAD
+  /* Offloads supported by the device (NETDEV_F_*) and the largest TCP
+   * packet it accepts for segmentation, set by the driver before the
+   * device is registered.
+   */
+
+  uint8_t  d_features;
+  uint16_t d_tsomax;
+#endif
+
   /* Link layer address */
 
 #if defined(CONFIG_NET_ETHERNET) || defined(CONFIG_NET_6LOWPAN) || \
@@ -561,4 +561,32 @@ int netpkt_to_iov(FAR struct netdev_lowerhalf_s *dev, FAR netpkt_t *pkt,
 
 #define netpkt_free_queue(queue) iob_free_queue(queue)
 
+/****************************************************************************
+ * Name: netpkt_gsosize, netpkt_csum_partial, netpkt_set_csum_valid
+ *
+ * Description:
+ *   Access the offload state of a packet.  A lower half that sets
+ *   NETDEV_F_TXCSUM in netdev.d_features before registering must complete
+ *   the L4 checksum of the transmitted packets for which
+ *   netpkt_csum_partial() is true: the checksum field then holds the
+ *   pseudo header sum.  One that sets NETDEV_F_TSO4/6 must split the
+ *   packets with a non-zero netpkt_gsosize() into segments of that payload
+ *   size, the packet being at most netdev.d_tsomax bytes long.  A lower
+ *   half that verified the L4 checksum of a received packet may call
+ *   netpkt_set_csum_valid() to spare the stack from doing it again.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NETDEV_OFFLOAD
+#  define netpkt_gsosize(pkt)      ((pkt)->io_gsosize)
+#  define netpkt_csum_partial(pkt) \
+     (((pkt)->io_flags & IOB_F_CSUM_PARTIAL) != 0)
+#  define netpkt_set_csum_valid(pkt) \
+     ((pkt)->io_flags |= IOB_F_CSUM_VALID)
+#else
+#  define netpkt_gsosize(pkt)      0
+#  define netpkt_csum_partial(pkt) false
+#  define netpkt_set_csum_valid(pkt)
+#endif
+
 #endif /* __INCLUDE_NUTTX_NET_NETDEV_LOWERHALF_H */
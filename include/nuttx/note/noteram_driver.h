@@ -48,12 +48,20 @@
  * NOTERAM_SETMODE
  *              - Set overwrite mode
  *                Argument: A read-only pointer to unsigned int
+ * NOTERAM_GETREADMODE
+ *              - Get read mode
+ *                Argument: A writable pointer to unsigned int
+ * NOTERAM_SETREADMODE
+ *              - Set read mode
+ *                Argument: A read-only pointer to unsigned int
  */
 
 #ifdef CONFIG_DRIVERS_NOTERAM
 #define NOTERAM_CLEAR           _NOTERAMIOC(0x01)
 #define NOTERAM_GETMODE         _NOTERAMIOC(0x02)
 #define NOTERAM_SETMODE         _NOTERAMIOC(0x03)
+#define NOTERAM_GETREADMODE     _NOTERAMIOC(0x04)
+#define NOTERAM_SETREADMODE     _NOTERAMIOC(0x05)
 #endif
 
 /* Overwrite mode definitions */
@@ -64,6 +72,16 @@
 #define NOTERAM_MODE_OVERWRITE_OVERFLOW     2
 #endif
 
+/* Read mode definitions.  In binary mode, read() returns the raw notes as
+ * they were recorded (see struct note_common_s), as many whole notes as
+ * fit in the user buffer.
+ */
+
+#ifdef CONFIG_DRIVERS_NOTERAM
+#define NOTERAM_MODE_READ_ASCII             0
+#define NOTERAM_MODE_READ_BINARY            1
+#endif
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
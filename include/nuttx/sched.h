@@ -629,6 +629,9 @@ struct tcb_s
 #ifdef CONFIG_SMP
   uint8_t  cpu;                          /* CPU index if running/assigned   */
   cpu_set_t affinity;                    /* Bit set of permitted CPUs       */
+#ifdef CONFIG_SCHED_CPUSELECT_AFFINITY
+  uint32_t nmigrations;                  /* Number of changes of CPU        */
+#endif
 #endif
   uint32_t flags;                        /* Misc. general status flags      */
   int16_t  lockcount;                    /* 0=preemptible (not-locked)      */
@@ -819,6 +822,22 @@ begin_packed_struct struct tcbinfo_s
   end_packed_struct reg_off; /* Refer to https://sourceware.org/gdb/current/onlinedocs/gdb.html/Standard-Target-Features.html */
 } end_packed_struct;
 
+/* struct critmon_contention_s *********************************************/
+
+/* The time spent waiting for a contended lock at one call site */
+
+#if defined(CONFIG_SCHED_CRITMONITOR_CONTENTION) && \
+    CONFIG_SCHED_CRITMONITOR_CONTENTION > 0
+struct critmon_contention_s
+{
+  FAR void *caller;                      /* Call site acquiring the lock    */
+  FAR volatile void *lock;               /* The lock that was contended     */
+  uint32_t count;                        /* Number of contended waits       */
+  clock_t  total;                        /* Total time spent waiting        */
+  clock_t  max;                          /* Longest wait                    */
+};
+#endif
+
 /* This is the callback type used by nxsched_foreach() */
 
 typedef CODE void (*nxsched_foreach_t)(FAR struct tcb_s *tcb, FAR void *arg);
@@ -855,6 +874,14 @@ EXTERN clock_t g_premp_max[CONFIG_SMP_NCPUS];
 EXTERN clock_t g_crit_max[CONFIG_SMP_NCPUS];
 #endif /* CONFIG_SCHED_CRITMONITOR_MAXTIME_CSECTION >= 0 */
 
+/* Time spent waiting for contended locks, per call site */
+
+#if defined(CONFIG_SCHED_CRITMONITOR_CONTENTION) && \
+    CONFIG_SCHED_CRITMONITOR_CONTENTION > 0
+EXTERN struct critmon_contention_s
+g_crit_contention[CONFIG_SCHED_CRITMONITOR_CONTENTION];
+#endif
+
 EXTERN const struct tcbinfo_s g_tcbinfo;
 
 /****************************************************************************
@@ -30,9 +30,14 @@
 #include <nuttx/config.h>
 
 #include <errno.h>
+#include <limits.h>
 #include <semaphore.h>
+#include <stdbool.h>
+#include <stdint.h>
 
+#include <nuttx/atomic.h>
 #include <nuttx/clock.h>
+#include <nuttx/compiler.h>
 
 /****************************************************************************
  * Pre-processor Definitions
@@ -59,6 +64,12 @@
      {(c), (f), SEM_WAITLIST_INITIALIZER}
 #endif /* CONFIG_PRIORITY_INHERITANCE */
 
+/* The semaphore count may be changed without the critical section, so
+ * code that adjusts it directly must use the count helpers below.
+ */
+
+#define NXSEM_COUNT(s) ((FAR atomic_short *)&(s)->semcount)
+
 /****************************************************************************
  * Public Type Definitions
  ****************************************************************************/
@@ -723,6 +734,92 @@ int nxsem_getprioceiling(FAR const sem_t *sem, FAR int *prioceiling);
 int nxsem_setprioceiling(FAR sem_t *sem, int prioceiling,
                          FAR int *old_ceiling);
 
+/****************************************************************************
+ * Inline Functions
+ ****************************************************************************/
+
+#if defined(CONFIG_BUILD_FLAT) || defined(__KERNEL__)
+
+/****************************************************************************
+ * Name: nxsem_trydec_count
+ *
+ * Description:
+ *   Atomically take a count of the semaphore if one is available.
+ *
+ ****************************************************************************/
+
+static inline_function bool nxsem_trydec_count(FAR sem_t *sem)
+{
+  int16_t count = sem->semcount;
+
+  while (count > 0)
+    {
+      if (atomic_compare_exchange_strong(NXSEM_COUNT(sem), &count,
+                                         count - 1))
+        {
+          return true;
+        }
+    }
+
+  return false;
+}
+
+/****************************************************************************
+ * Name: nxsem_inc_count
+ *
+ * Description:
+ *   Atomically give back a count of the semaphore, unless its count is
+ *   below 'min' or the semaphore would overflow.  The previous count is
+ *   returned in 'old' in any case.
+ *
+ ****************************************************************************/
+
+static inline_function bool nxsem_inc_count(FAR sem_t *sem, int16_t min,
+                                            FAR int16_t *old)
+{
+  int16_t count = sem->semcount;
+
+  while (count >= min && count < SEM_VALUE_MAX)
+    {
+      if (atomic_compare_exchange_strong(NXSEM_COUNT(sem), &count,
+                                         count + 1))
+        {
+          *old = count;
+          return true;
+        }
+    }
+
+  *old = count;
+  return false;
+}
+
+/****************************************************************************
+ * Name: nxsem_set_count
+ *
+ * Description:
+ *   Atomically set the count of the semaphore to 'value', unless threads
+ *   are waiting for it.  Returns false if the count was negative and was
+ *   left unchanged.
+ *
+ ****************************************************************************/
+
+static inline_function bool nxsem_set_count(FAR sem_t *sem, int16_t value)
+{
+  int16_t count = sem->semcount;
+
+  while (count >= 0)
+    {
+      if (atomic_compare_exchange_strong(NXSEM_COUNT(sem), &count, value))
+        {
+          return true;
+        }
+    }
+
+  return false;
+}
+
+#endif /* CONFIG_BUILD_FLAT || __KERNEL__ */
+
 #undef EXTERN
 #ifdef __cplusplus
 }
@@ -255,6 +255,9 @@ struct work_s
     {
       struct dq_entry_s dq;      /* Implements a double linked list */
       clock_t qtime;             /* Time work queued */
+#ifdef CONFIG_SCHED_WORKQUEUE_PERCPU
+      uint8_t cpu;               /* The CPU queue holding the work */
+#endif
     } s;
     struct wdog_s timer;         /* Delay expiry timer */
   } u;
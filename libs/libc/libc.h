@@ -155,6 +155,20 @@
 #  define LIBC_BUILD_STRRCHR
 #endif
 
+/* Helpers for the string functions working a machine word at a time.
+ * LIBC_WORD_HASZERO() is non-zero if any byte of the word is zero.
+ */
+
+#ifdef CONFIG_LIBC_STRING_OPTSPEED
+#  define LIBC_WORD_SIZE         sizeof(uintptr_t)
+#  define LIBC_WORD_MASK         (LIBC_WORD_SIZE - 1)
+#  define LIBC_WORD_ONES         ((uintptr_t)-1 / 0xff)
+#  define LIBC_WORD_HIGHS        (LIBC_WORD_ONES << 7)
+#  define LIBC_WORD_HASZERO(x)   (((x) - LIBC_WORD_ONES) & ~(x) & \
+                                  LIBC_WORD_HIGHS)
+#  define LIBC_WORD_UNALIGNED(p) (((uintptr_t)(p) & LIBC_WORD_MASK) != 0)
+#endif
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
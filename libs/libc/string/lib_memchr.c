@@ -54,6 +54,32 @@ FAR void *memchr(FAR const void *s, int c, size_t n)
 {
   FAR const unsigned char *p = (FAR const unsigned char *)s;
 
+#ifdef CONFIG_LIBC_STRING_OPTSPEED
+  FAR const uintptr_t *w;
+  uintptr_t mask;
+
+  /* Check byte by byte up to a word boundary */
+
+  for (; n > 0 && LIBC_WORD_UNALIGNED(p); n--, p++)
+    {
+      if (*p == (unsigned char)c)
+        {
+          return (FAR void *)p;
+        }
+    }
+
+  /* Then skip whole words without the byte.  The byte loop below finds
+   * the match within the word that stopped the loop.
+   */
+
+  mask = LIBC_WORD_ONES * (unsigned char)c;
+  for (w = (FAR const uintptr_t *)p;
+       n >= LIBC_WORD_SIZE && !LIBC_WORD_HASZERO(*w ^ mask);
+       n -= LIBC_WORD_SIZE, w++);
+
+  p = (FAR const unsigned char *)w;
+#endif
+
   while (n--)
     {
       if (*p == (unsigned char)c)
@@ -41,10 +41,83 @@
 #if !defined(CONFIG_LIBC_ARCH_MEMCPY) && defined(LIBC_BUILD_MEMCPY)
 #undef memcpy /* See mm/README.txt */
 no_builtin("memcpy")
+#ifdef CONFIG_LIBC_STRING_OPTSPEED
+nosanitize_address
+#endif
 FAR void *memcpy(FAR void *dest, FAR const void *src, size_t n)
 {
   FAR unsigned char *pout = (FAR unsigned char *)dest;
   FAR unsigned char *pin  = (FAR unsigned char *)src;
+
+#ifdef CONFIG_LIBC_STRING_OPTSPEED
+  if (n >= 2 * LIBC_WORD_SIZE)
+    {
+      FAR uintptr_t *wout;
+      FAR const uintptr_t *win;
+      size_t off;
+
+      /* Align the destination to a word boundary */
+
+      for (; LIBC_WORD_UNALIGNED(pout); n--)
+        {
+          *pout++ = *pin++;
+        }
+
+      wout = (FAR uintptr_t *)pout;
+      off  = (uintptr_t)pin & LIBC_WORD_MASK;
+      if (off == 0)
+        {
+          /* Both are aligned, copy four words per iteration */
+
+          win = (FAR const uintptr_t *)pin;
+          for (; n >= 4 * LIBC_WORD_SIZE; n -= 4 * LIBC_WORD_SIZE)
+            {
+              wout[0] = win[0];
+              wout[1] = win[1];
+              wout[2] = win[2];
+              wout[3] = win[3];
+              wout   += 4;
+              win    += 4;
+            }
+
+          for (; n >= LIBC_WORD_SIZE; n -= LIBC_WORD_SIZE)
+            {
+              *wout++ = *win++;
+            }
+
+          pin = (FAR unsigned char *)win;
+        }
+      else
+        {
+          /* The source is misaligned: read aligned words and merge each
+           * pair into one destination word.
+           */
+
+          unsigned int shr = off * 8;
+          unsigned int shl = LIBC_WORD_SIZE * 8 - shr;
+          uintptr_t prev;
+          uintptr_t next;
+
+          win  = (FAR const uintptr_t *)(pin - off);
+          prev = *win++;
+          for (; n >= LIBC_WORD_SIZE; n -= LIBC_WORD_SIZE)
+            {
+              next = *win++;
+#ifdef CONFIG_ENDIAN_BIG
+              *wout++ = (prev << shr) | (next >> shl);
+#else
+              *wout++ = (prev >> shr) | (next << shl);
+#endif
+              prev = next;
+            }
+
+          pin = (FAR unsigned char *)win - LIBC_WORD_SIZE + off;
+        }
+
+      pout = (FAR unsigned char *)wout;
+    }
+#endif
+
   while (n-- > 0)
     {
       *pout++ = *pin++;
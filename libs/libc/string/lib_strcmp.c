@@ -36,9 +36,42 @@
 
 #if !defined(CONFIG_LIBC_ARCH_STRCMP) && defined(LIBC_BUILD_STRCMP)
 #undef strcmp /* See mm/README.txt */
+#ifdef CONFIG_LIBC_STRING_OPTSPEED
+nosanitize_address
+#endif
 int strcmp(FAR const char *cs, FAR const char *ct)
 {
   register int result;
+
+#ifdef CONFIG_LIBC_STRING_OPTSPEED
+  /* Compare whole words if both strings can be aligned together */
+
+  if ((((uintptr_t)cs ^ (uintptr_t)ct) & LIBC_WORD_MASK) == 0)
+    {
+      FAR const uintptr_t *w1;
+      FAR const uintptr_t *w2;
+
+      for (; LIBC_WORD_UNALIGNED(cs); cs++, ct++)
+        {
+          if ((result = (unsigned char)*cs - (unsigned char)*ct) != 0 ||
+              *cs == '\0')
+            {
+              return result;
+            }
+        }
+
+      /* Stop at the first word that differs or holds the terminator, the
+       * byte loop below finishes the comparison within it.
+       */
+
+      for (w1 = (FAR const uintptr_t *)cs, w2 = (FAR const uintptr_t *)ct;
+           *w1 == *w2 && !LIBC_WORD_HASZERO(*w1); w1++, w2++);
+
+      cs = (FAR const char *)w1;
+      ct = (FAR const char *)w2;
+    }
+#endif
+
   for (; ; )
     {
       if ((result = (unsigned char)*cs - (unsigned char)*ct++) != 0 ||
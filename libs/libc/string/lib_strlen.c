@@ -36,6 +36,33 @@
 
 #if !defined(CONFIG_LIBC_ARCH_STRLEN) && defined(LIBC_BUILD_STRLEN)
 #undef strlen /* See mm/README.txt */
+#ifdef CONFIG_LIBC_STRING_OPTSPEED
+nosanitize_address
+size_t strlen(FAR const char *s)
+{
+  FAR const uintptr_t *w;
+  FAR const char *sc;
+
+  /* Check byte by byte up to a word boundary */
+
+  for (sc = s; LIBC_WORD_UNALIGNED(sc); ++sc)
+    {
+      if (*sc == '\0')
+        {
+          return sc - s;
+        }
+    }
+
+  /* Then skip whole words without a zero byte.  An aligned word never
+   * crosses a page, so reading past the terminator is harmless.
+   */
+
+  for (w = (FAR const uintptr_t *)sc; !LIBC_WORD_HASZERO(*w); ++w);
+
+  for (sc = (FAR const char *)w; *sc != '\0'; ++sc);
+  return sc - s;
+}
+#else
 size_t strlen(FAR const char *s)
 {
   FAR const char *sc;
@@ -43,3 +70,4 @@ size_t strlen(FAR const char *s)
   return sc - s;
 }
 #endif
+#endif
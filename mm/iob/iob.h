@@ -43,6 +43,15 @@
 
 #define ROUNDUP(x, y)            (((x) + (y) - 1) / (y) * (y))
 
+/* Clear the offload state of a newly allocated I/O buffer */
+
+#ifdef CONFIG_NETDEV_OFFLOAD
+#  define iob_reset_offload(iob) \
+     do { (iob)->io_gsosize = 0; (iob)->io_flags = 0; } while (0)
+#else
+#  define iob_reset_offload(iob)
+#endif
+
 #if defined(CONFIG_DEBUG_FEATURES) && defined(CONFIG_IOB_DEBUG)
 #  define ioberr                 _err
 #  define iobwarn                _warn
@@ -126,6 +135,85 @@ FAR struct iob_qentry_s *iob_tryalloc_qentry(void);
 
 FAR struct iob_qentry_s *iob_free_qentry(FAR struct iob_qentry_s *iobq);
 
+/****************************************************************************
+ * Name: iob_release
+ *
+ * Description:
+ *   Return a single I/O buffer to the global free list, or commit it to a
+ *   task waiting for an I/O buffer, and post the counting semaphores.
+ *
+ ****************************************************************************/
+
+void iob_release(FAR struct iob_s *iob);
+
+#if defined(CONFIG_IOB_PERCPU_CACHE) && \
+    CONFIG_IOB_PERCPU_CACHE > 0
+/****************************************************************************
+ * Name: iob_cache_alloc
+ *
+ * Description:
+ *   Allocate an I/O buffer from the cache of the current CPU, refilling the
+ *   cache with a batch of buffers from the global free list if it is empty.
+ *
+ ****************************************************************************/
+
+FAR struct iob_s *iob_cache_alloc(bool throttled);
+
+/****************************************************************************
+ * Name: iob_cache_free
+ *
+ * Description:
+ *   Free an I/O buffer to the cache of the current CPU.  Returns false if
+ *   the buffer must be released to the global free list instead.
+ *
+ ****************************************************************************/
+
+bool iob_cache_free(FAR struct iob_s *iob);
+
+/****************************************************************************
+ * Name: iob_cache_flush
+ *
+ * Description:
+ *   Return the I/O buffers cached by all CPUs to the global free list and
+ *   return the number of buffers returned.
+ *
+ ****************************************************************************/
+
+int iob_cache_flush(void);
+
+/****************************************************************************
+ * Name: iob_cache_addwaiter and iob_cache_rmwaiter
+ *
+ * Description:
+ *   Count the tasks that may wait for an I/O buffer.  Freed buffers bypass
+ *   the per-CPU caches while there are any.
+ *
+ ****************************************************************************/
+
+void iob_cache_addwaiter(void);
+void iob_cache_rmwaiter(void);
+
+/****************************************************************************
+ * Name: iob_cache_navail
+ *
+ * Description:
+ *   Return the number of I/O buffers cached by all CPUs.
+ *
+ ****************************************************************************/
+
+int iob_cache_navail(void);
+
+/****************************************************************************
+ * Name: iob_cache_stats
+ *
+ * Description:
+ *   Accumulate the statistics of all per-CPU caches.
+ *
+ ****************************************************************************/
+
+void iob_cache_stats(FAR struct iob_stats_s *stats);
+#endif
+
 /****************************************************************************
  * Name: iob_notifier_signal
  *
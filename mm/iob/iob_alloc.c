@@ -60,6 +60,90 @@ static clock_t iob_allocwait_gettimeout(clock_t start, unsigned int timeout)
   return tick;
 }
 
+/****************************************************************************
+ * Name: iob_tryalloc_global
+ *
+ * Description:
+ *   Try to allocate an I/O buffer by taking the buffer at the head of the
+ *   global free list.
+ *
+ ****************************************************************************/
+
+static FAR struct iob_s *iob_tryalloc_global(bool throttled)
+{
+  FAR struct iob_s *iob;
+  irqstate_t flags;
+#if CONFIG_IOB_THROTTLE > 0
+  FAR sem_t *sem;
+#endif
+
+#if CONFIG_IOB_THROTTLE > 0
+  /* Select the semaphore count to check. */
+
+  sem = (throttled ? &g_throttle_sem : &g_iob_sem);
+#endif
+
+  /* We don't know what context we are called from so we use extreme measures
+   * to protect the free list:  We disable interrupts very briefly.
+   */
+
+  flags = spin_lock_irqsave(&g_iob_lock);
+
+#if CONFIG_IOB_THROTTLE > 0
+  /* If there are free I/O buffers for this allocation */
+
+  if (sem->semcount > 0)
+#endif
+    {
+      /* Take the I/O buffer from the head of the free list */
+
+      iob = g_iob_freelist;
+      if (iob != NULL)
+        {
+          /* Remove the I/O buffer from the free list and decrement the
+           * counting semaphore(s) that tracks the number of available
+           * IOBs.
+           */
+
+          g_iob_freelist = iob->io_flink;
+
+          /* Take a semaphore count.  Note that we cannot do this in
+           * in the orthodox way by calling nxsem_wait() or nxsem_trywait()
+           * because this function may be called from an interrupt
+           * handler. Fortunately we know at at least one free buffer
+           * so a simple decrement is all that is needed.
+           */
+
+          DEBUGVERIFY(atomic_fetch_sub(NXSEM_COUNT(&g_iob_sem), 1) > 0);
+
+#if CONFIG_IOB_THROTTLE > 0
+          /* The throttle semaphore is used to throttle the number of
+           * free buffers that are available.  It is used to prevent
+           * the overrunning of the free buffer list. Please note that
+           * it can only be decremented to zero, which indicates no
+           * throttled buffers are available.
+           */
+
+          nxsem_trydec_count(&g_throttle_sem);
+#endif
+
+          spin_unlock_irqrestore(&g_iob_lock, flags);
+
+          /* Put the I/O buffer in a known state */
+
+          iob->io_flink  = NULL; /* Not in a chain */
+          iob->io_len    = 0;    /* Length of the data in the entry */
+          iob->io_offset = 0;    /* Offset to the beginning of data */
+          iob->io_pktlen = 0;    /* Total length of the packet */
+          iob_reset_offload(iob);
+          return iob;
+        }
+    }
+
+  spin_unlock_irqrestore(&g_iob_lock, flags);
+  return NULL;
+}
+
 /****************************************************************************
  * Name: iob_alloc_committed
  *
@@ -95,6 +179,7 @@ static FAR struct iob_s *iob_alloc_committed(void)
       iob->io_len    = 0;    /* Length of the data in the entry */
       iob->io_offset = 0;    /* Offset to the beginning of data */
       iob->io_pktlen = 0;    /* Total length of the packet */
+      iob_reset_offload(iob);
     }
 
   spin_unlock_irqrestore(&g_iob_lock, flags);
@@ -126,6 +211,16 @@ static FAR struct iob_s *iob_allocwait(bool throttled, unsigned int timeout)
   sem = &g_iob_sem;
 #endif
 
+  /* Try to get an I/O buffer first.  The free list has its own lock, so
+   * the critical section is only needed when we may have to wait.
+   */
+
+  iob = iob_tryalloc(throttled);
+  if (iob != NULL)
+    {
+      return iob;
+    }
+
   /* The following must be atomic; interrupt must be disabled so that there
    * is no conflict with interrupt level I/O buffer allocations.  This is
    * not as bad as it sounds because interrupts will be re-enabled while
@@ -134,6 +229,15 @@ static FAR struct iob_s *iob_allocwait(bool throttled, unsigned int timeout)
 
   flags = enter_critical_section();
 
+#if defined(CONFIG_IOB_PERCPU_CACHE) && \
+    CONFIG_IOB_PERCPU_CACHE > 0
+  /* Stop the other CPUs from caching the buffers they free before the
+   * caches are flushed for the last time.
+   */
+
+  iob_cache_addwaiter();
+#endif
+
   /* Try to get an I/O buffer.  If successful, the semaphore count will be
    * decremented atomically.
    */
@@ -165,9 +269,24 @@ static FAR struct iob_s *iob_allocwait(bool throttled, unsigned int timeout)
            */
 
           iob = iob_alloc_committed();
+          if (iob == NULL)
+            {
+              /* The count was taken while the I/O buffer was released to
+               * the free list by another CPU rather than committed to us.
+               * Give the count back and take the buffer from the free list.
+               */
+
+              nxsem_post(sem);
+              iob = iob_tryalloc(throttled);
+            }
         }
     }
 
+#if defined(CONFIG_IOB_PERCPU_CACHE) && \
+    CONFIG_IOB_PERCPU_CACHE > 0
+  iob_cache_rmwaiter();
+#endif
+
   leave_critical_section(flags);
   return iob;
 }
@@ -248,80 +367,25 @@ FAR struct iob_s *iob_alloc(bool throttled)
 
 FAR struct iob_s *iob_tryalloc(bool throttled)
 {
+#if defined(CONFIG_IOB_PERCPU_CACHE) && \
+    CONFIG_IOB_PERCPU_CACHE > 0
   FAR struct iob_s *iob;
-  irqstate_t flags;
-#if CONFIG_IOB_THROTTLE > 0
-  FAR sem_t *sem;
-#endif
-
-#if CONFIG_IOB_THROTTLE > 0
-  /* Select the semaphore count to check. */
 
-  sem = (throttled ? &g_throttle_sem : &g_iob_sem);
-#endif
-
-  /* We don't know what context we are called from so we use extreme measures
-   * to protect the free list:  We disable interrupts very briefly.
+  /* Try the cache of this CPU first, it falls back to the global free list
+   * by itself.  If both are exhausted, the buffers may still be sitting in
+   * the caches of the other CPUs, so return them and try once more.
    */
 
-  flags = spin_lock_irqsave(&g_iob_lock);
-
-#if CONFIG_IOB_THROTTLE > 0
-  /* If there are free I/O buffers for this allocation */
-
-  if (sem->semcount > 0)
-#endif
+  iob = iob_cache_alloc(throttled);
+  if (iob == NULL && iob_cache_flush() > 0)
     {
-      /* Take the I/O buffer from the head of the free list */
-
-      iob = g_iob_freelist;
-      if (iob != NULL)
-        {
-          /* Remove the I/O buffer from the free list and decrement the
-           * counting semaphore(s) that tracks the number of available
-           * IOBs.
-           */
-
-          g_iob_freelist = iob->io_flink;
-
-          /* Take a semaphore count.  Note that we cannot do this in
-           * in the orthodox way by calling nxsem_wait() or nxsem_trywait()
-           * because this function may be called from an interrupt
-           * handler. Fortunately we know at at least one free buffer
-           * so a simple decrement is all that is needed.
-           */
-
-          g_iob_sem.semcount--;
-          DEBUGASSERT(g_iob_sem.semcount >= 0);
-
-#if CONFIG_IOB_THROTTLE > 0
-          /* The throttle semaphore is used to throttle the number of
-           * free buffers that are available.  It is used to prevent
-           * the overrunning of the free buffer list. Please note that
-           * it can only be decremented to zero, which indicates no
-           * throttled buffers are available.
-           */
-
-          if (g_throttle_sem.semcount > 0)
-            {
-              g_throttle_sem.semcount--;
-            }
-#endif
-
-          spin_unlock_irqrestore(&g_iob_lock, flags);
-
-          /* Put the I/O buffer in a known state */
-
-          iob->io_flink  = NULL; /* Not in a chain */
-          iob->io_len    = 0;    /* Length of the data in the entry */
-          iob->io_offset = 0;    /* Offset to the beginning of data */
-          iob->io_pktlen = 0;    /* Total length of the packet */
-          return iob;
-        }
+      iob = iob_tryalloc_global(throttled);
     }
 
-  spin_unlock_irqrestore(&g_iob_lock, flags);
-  return NULL;
+  return iob;
+#else
+  return iob_tryalloc_global(throttled);
+#endif
 }
 
 #ifdef CONFIG_IOB_ALLOC
@@ -361,6 +425,7 @@ FAR struct iob_s *iob_alloc_dynamic(uint16_t size)
       iob->io_free    = iob_free_dynamic; /* Customer free callback */
       iob->io_data    = (FAR uint8_t *)ROUNDUP((uintptr_t)(iob + 1),
                                                CONFIG_IOB_ALIGNMENT);
+      iob_reset_offload(iob);
     }
 
   return iob;
@@ -406,6 +471,7 @@ FAR struct iob_s *iob_alloc_with_data(FAR void *data, uint16_t size,
       iob->io_pktlen  = 0;       /* Total length of the packet */
       iob->io_free    = free_cb; /* Customer free callback */
       iob->io_data    = data;
+      iob_reset_offload(iob);
     }
 
   return iob;
@@ -95,6 +95,16 @@ static FAR struct iob_qentry_s *iob_allocwait_qentry(void)
   irqstate_t flags;
   int ret = OK;
 
+  /* Try to get an I/O buffer chain container first, the critical section
+   * is only needed when we may have to wait.
+   */
+
+  qentry = iob_tryalloc_qentry();
+  if (qentry != NULL)
+    {
+      return qentry;
+    }
+
   /* The following must be atomic; interrupt must be disabled so that there
    * is no conflict with interrupt level I/O buffer chain container
    * allocations.  This is not as bad as it sounds because interrupts will be
@@ -126,13 +136,11 @@ static FAR struct iob_qentry_s *iob_allocwait_qentry(void)
            */
 
           qentry = iob_alloc_qcommitted();
-          DEBUGASSERT(qentry != NULL);
-
           if (qentry == NULL)
             {
-              /* This should not fail, but we allow for that possibility to
-               * handle any potential, non-obvious race condition.  Perhaps
-               * the free IOB ended up in the g_iob_free list?
+              /* This happens when the count was taken without the critical
+               * section while the container was released to the free list
+               * by another CPU, rather than committed to us.
                *
                * We need release our count so that it is available to
                * iob_tryalloc(), perhaps allowing another thread to take our
@@ -219,8 +227,7 @@ FAR struct iob_qentry_s *iob_tryalloc_qentry(void)
        * so a simple decrement is all that is needed.
        */
 
-      g_qentry_sem.semcount--;
-      DEBUGASSERT(g_qentry_sem.semcount >= 0);
+      DEBUGVERIFY(atomic_fetch_sub(NXSEM_COUNT(&g_qentry_sem), 1) > 0);
 
       /* Put the I/O buffer in a known state */
 
@@ -0,0 +1,432 @@
+/****************************************************************************
+ * mm/iob/iob_cache.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdbool.h>
+#include <assert.h>
+
+#include <nuttx/atomic.h>
+#include <nuttx/irq.h>
+#include <nuttx/sched.h>
+#include <nuttx/spinlock.h>
+#include <nuttx/mm/iob.h>
+
+#include "iob.h"
+
+#if defined(CONFIG_IOB_PERCPU_CACHE) && \
+    CONFIG_IOB_PERCPU_CACHE > 0
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Number of I/O buffers moved between a per-CPU cache and the global free
+ * list at once.
+ */
+
+#define IOB_CACHE_BATCH ((CONFIG_IOB_PERCPU_CACHE + 1) / 2)
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* The I/O buffers cached by one CPU.  The lock is only taken by other CPUs
+ * when they flush the caches, so it is normally uncontended and its cache
+ * line stays local to the owning CPU.
+ */
+
+struct iob_cache_s
+{
+  spinlock_t        lock;
+  FAR struct iob_s *head;         /* Cached I/O buffers, linked by io_flink */
+  int               count;        /* Number of cached I/O buffers */
+  unsigned long     hits;         /* Allocations served by the cache */
+  unsigned long     misses;       /* Allocations that refilled the cache */
+  unsigned long     drains;       /* Frees that drained the cache */
+  unsigned long     contended;    /* Contended acquisitions of g_iob_lock */
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static struct iob_cache_s g_iob_cache[CONFIG_SMP_NCPUS];
+
+/* Number of tasks that may be waiting for an I/O buffer.  Freed buffers
+ * bypass the caches while it is not zero so that they reach the waiters.
+ */
+
+static atomic_int g_iob_cache_waiters;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: iob_cache_lock
+ *
+ * Description:
+ *   Disable the local interrupts and lock the cache of the current CPU.
+ *
+ ****************************************************************************/
+
+static FAR struct iob_cache_s *iob_cache_lock(FAR irqstate_t *flags)
+{
+  FAR struct iob_cache_s *cache;
+
+  *flags = up_irq_save();
+  cache  = &g_iob_cache[this_cpu()];
+  spin_lock(&cache->lock);
+  return cache;
+}
+
+/****************************************************************************
+ * Name: iob_cache_unlock
+ ****************************************************************************/
+
+static void iob_cache_unlock(FAR struct iob_cache_s *cache,
+                             irqstate_t flags)
+{
+  spin_unlock(&cache->lock);
+  up_irq_restore(flags);
+}
+
+/****************************************************************************
+ * Name: iob_cache_refill
+ *
+ * Description:
+ *   Take a batch of I/O buffers from the global free list with a single
+ *   acquisition of g_iob_lock.  The first buffer obeys the throttle of the
+ *   caller, the rest are only taken while buffers beyond the throttle
+ *   reserve are available so that the cache never hoards the reserve.
+ *
+ *   The counting semaphores are decremented for every buffer taken: a
+ *   cached buffer is owned by the cache until it is drained.
+ *
+ ****************************************************************************/
+
+static FAR struct iob_s *iob_cache_refill(FAR struct iob_cache_s *cache,
+                                          bool throttled, FAR int *ntaken)
+{
+  FAR struct iob_s *head = NULL;
+  FAR struct iob_s *iob;
+  int n = 0;
+
+  if (!spin_trylock(&g_iob_lock))
+    {
+      cache->contended++;
+      spin_lock(&g_iob_lock);
+    }
+
+  while (n < IOB_CACHE_BATCH && g_iob_freelist != NULL)
+    {
+#if CONFIG_IOB_THROTTLE > 0
+      if ((n > 0 || throttled) && g_throttle_sem.semcount <= 0)
+        {
+          break;
+        }
+
+      nxsem_trydec_count(&g_throttle_sem);
+#else
+      if (n > 0 && g_iob_sem.semcount <= 0)
+        {
+          break;
+        }
+#endif
+
+      iob            = g_iob_freelist;
+      g_iob_freelist = iob->io_flink;
+      iob->io_flink  = head;
+      head           = iob;
+
+      DEBUGVERIFY(atomic_fetch_sub(NXSEM_COUNT(&g_iob_sem), 1) > 0);
+      n++;
+    }
+
+  spin_unlock(&g_iob_lock);
+
+  *ntaken = n;
+  return head;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: iob_cache_alloc
+ *
+ * Description:
+ *   Allocate an I/O buffer from the cache of the current CPU, refilling the
+ *   cache from the global free list when it is empty.  Throttled requests
+ *   are only served while the global throttle allows them.
+ *
+ ****************************************************************************/
+
+FAR struct iob_s *iob_cache_alloc(bool throttled)
+{
+  FAR struct iob_cache_s *cache;
+  FAR struct iob_s *iob;
+  irqstate_t flags;
+  int n;
+
+#if CONFIG_IOB_THROTTLE > 0
+  if (throttled && g_throttle_sem.semcount <= 0)
+    {
+      return NULL;
+    }
+#endif
+
+  cache = iob_cache_lock(&flags);
+
+  iob = cache->head;
+  if (iob != NULL)
+    {
+      cache->head = iob->io_flink;
+      cache->count--;
+      cache->hits++;
+    }
+  else
+    {
+      cache->misses++;
+      iob = iob_cache_refill(cache, throttled, &n);
+      if (iob != NULL)
+        {
+          cache->head  = iob->io_flink;
+          cache->count = n - 1;
+        }
+    }
+
+  iob_cache_unlock(cache, flags);
+
+  if (iob != NULL)
+    {
+      /* Put the I/O buffer in a known state */
+
+      iob->io_flink  = NULL; /* Not in a chain */
+      iob->io_len    = 0;    /* Length of the data in the entry */
+      iob->io_offset = 0;    /* Offset to the beginning of data */
+      iob->io_pktlen = 0;    /* Total length of the packet */
+      iob_reset_offload(iob);
+    }
+
+  return iob;
+}
+
+/****************************************************************************
+ * Name: iob_cache_free
+ *
+ * Description:
+ *   Free an I/O buffer to the cache of the current CPU.  When the cache is
+ *   full, a batch of buffers is returned to the global free list.
+ *
+ * Returned Value:
+ *   True if the buffer was cached.  False if a task may be waiting for an
+ *   I/O buffer, in which case the caller must release it to the global
+ *   free list so that the waiter is woken up.
+ *
+ ****************************************************************************/
+
+bool iob_cache_free(FAR struct iob_s *iob)
+{
+  FAR struct iob_cache_s *cache;
+  FAR struct iob_s *drain = NULL;
+  irqstate_t flags;
+
+  cache = iob_cache_lock(&flags);
+
+  /* Bypass the cache while a task may wait for an I/O buffer, a buffer
+   * cached now would stay here while it sleeps.  The waiter is counted
+   * before it flushes the caches and the buffer is cached with the cache
+   * lock held, so the flush either returns the buffer or is seen here.
+   */
+
+  if (atomic_load(&g_iob_cache_waiters) > 0)
+    {
+      iob_cache_unlock(cache, flags);
+      return false;
+    }
+
+  iob->io_flink = cache->head;
+  cache->head   = iob;
+  if (++cache->count > CONFIG_IOB_PERCPU_CACHE)
+    {
+      /* Detach the most recently freed buffers, which are the least likely
+       * to be cold in this CPU's data cache, and keep the older ones.
+       */
+
+      int n;
+
+      cache->drains++;
+      drain = cache->head;
+      for (n = 1; n < IOB_CACHE_BATCH; n++)
+        {
+          iob = iob->io_flink;
+        }
+
+      cache->head   = iob->io_flink;
+      iob->io_flink = NULL;
+      cache->count -= IOB_CACHE_BATCH;
+    }
+
+  iob_cache_unlock(cache, flags);
+
+  /* Return the drained buffers with the interrupts enabled */
+
+  while (drain != NULL)
+    {
+      iob   = drain;
+      drain = iob->io_flink;
+      iob_release(iob);
+    }
+
+  return true;
+}
+
+/****************************************************************************
+ * Name: iob_cache_flush
+ *
+ * Description:
+ *   Return the I/O buffers cached by all CPUs to the global free list.
+ *   This is called before an allocation fails or blocks so that no buffer
+ *   is stranded in the cache of an idle CPU.
+ *
+ * Returned Value:
+ *   The number of I/O buffers returned.
+ *
+ ****************************************************************************/
+
+int iob_cache_flush(void)
+{
+  FAR struct iob_cache_s *cache;
+  FAR struct iob_s *iob;
+  irqstate_t flags;
+  int ret = 0;
+  int cpu;
+
+  for (cpu = 0; cpu < CONFIG_SMP_NCPUS; cpu++)
+    {
+      cache = &g_iob_cache[cpu];
+      flags = spin_lock_irqsave(&cache->lock);
+      iob   = cache->head;
+      ret  += cache->count;
+      cache->head  = NULL;
+      cache->count = 0;
+      spin_unlock_irqrestore(&cache->lock, flags);
+
+      while (iob != NULL)
+        {
+          FAR struct iob_s *next = iob->io_flink;
+
+          iob_release(iob);
+          iob = next;
+        }
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: iob_cache_addwaiter
+ *
+ * Description:
+ *   Announce a task that may wait for an I/O buffer.  This must be called
+ *   before the caches are flushed for the last time before waiting, and
+ *   matched by iob_cache_rmwaiter() once the task is done waiting.
+ *
+ ****************************************************************************/
+
+void iob_cache_addwaiter(void)
+{
+  atomic_fetch_add(&g_iob_cache_waiters, 1);
+}
+
+/****************************************************************************
+ * Name: iob_cache_rmwaiter
+ *
+ * Description:
+ *   Forget a task announced by iob_cache_addwaiter().
+ *
+ ****************************************************************************/
+
+void iob_cache_rmwaiter(void)
+{
+  atomic_fetch_sub(&g_iob_cache_waiters, 1);
+}
+
+/****************************************************************************
+ * Name: iob_cache_stats
+ *
+ * Description:
+ *   Accumulate the statistics of all per-CPU caches.
+ *
+ ****************************************************************************/
+
+void iob_cache_stats(FAR struct iob_stats_s *stats)
+{
+  int cpu;
+
+  stats->ncached    = 0;
+  stats->nhits      = 0;
+  stats->nmisses    = 0;
+  stats->ndrains    = 0;
+  stats->ncontended = 0;
+
+  for (cpu = 0; cpu < CONFIG_SMP_NCPUS; cpu++)
+    {
+      FAR struct iob_cache_s *cache = &g_iob_cache[cpu];
+
+      stats->ncached    += cache->count;
+      stats->nhits      += cache->hits;
+      stats->nmisses    += cache->misses;
+      stats->ndrains    += cache->drains;
+      stats->ncontended += cache->contended;
+    }
+}
+
+/****************************************************************************
+ * Name: iob_cache_navail
+ *
+ * Description:
+ *   Return the number of I/O buffers cached by all CPUs.
+ *
+ ****************************************************************************/
+
+int iob_cache_navail(void)
+{
+  int navail = 0;
+  int cpu;
+
+  for (cpu = 0; cpu < CONFIG_SMP_NCPUS; cpu++)
+    {
+      navail += g_iob_cache[cpu].count;
+    }
+
+  return navail;
+}
+
+#endif /* CONFIG_IOB_PERCPU_CACHE > 0 */
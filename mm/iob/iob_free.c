@@ -64,69 +64,57 @@
 #define IOB_MASK      (IOB_DIVIDER - 1)
 
 /****************************************************************************
- * Public Functions
+ * Private Functions
  ****************************************************************************/
 
 /****************************************************************************
- * Name: iob_free
+ * Name: iob_free_notify
  *
  * Description:
- *   Free the I/O buffer at the head of a buffer chain returning it to the
- *   free list.  The link to  the next I/O buffer in the chain is return.
+ *   Signal the threads that requested a notification when an IOB becomes
+ *   available.
  *
  ****************************************************************************/
 
-FAR struct iob_s *iob_free(FAR struct iob_s *iob)
-{
-  FAR struct iob_s *next = iob->io_flink;
-  irqstate_t flags;
 #ifdef CONFIG_IOB_NOTIFIER
+static void iob_free_notify(void)
+{
   int16_t navail;
-#endif
-#if CONFIG_IOB_THROTTLE > 0
-  bool committed_thottled = false;
-#endif
 
-  iobinfo("iob=%p io_pktlen=%u io_len=%u next=%p\n",
-          iob, iob->io_pktlen, iob->io_len, next);
-
-  /* Copy the data that only exists in the head of a I/O buffer chain into
-   * the next entry.
+  /* Check if the IOB was claimed by a thread that is blocked waiting
+   * for an IOB.
    */
 
-  if (next != NULL)
+  navail = iob_navail(false);
+  if (navail > 0 && (navail & IOB_MASK) == 0)
     {
-      /* Copy and decrement the total packet length, being careful to
-       * do nothing too crazy.
+      /* Signal any threads that have requested a signal notification
+       * when an IOB becomes available.
        */
 
-      if (iob->io_pktlen > iob->io_len)
-        {
-          /* Adjust packet length and move it to the next entry */
-
-          next->io_pktlen = iob->io_pktlen - iob->io_len;
-          DEBUGASSERT(next->io_pktlen >= next->io_len);
-        }
-      else
-        {
-          /* This can only happen if the free entry isn't first entry in the
-           * chain...
-           */
+      iob_notifier_signal();
+    }
+}
+#endif
 
-          next->io_pktlen = 0;
-        }
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
 
-      iobinfo("next=%p io_pktlen=%u io_len=%u\n",
-              next, next->io_pktlen, next->io_len);
-    }
+/****************************************************************************
+ * Name: iob_release
+ *
+ * Description:
+ *   Return a single I/O buffer to the global free list, or commit it to a
+ *   task waiting for an I/O buffer, and post the counting semaphores.
+ *
+ ****************************************************************************/
 
-#ifdef CONFIG_IOB_ALLOC
-  if (iob->io_free != NULL)
-    {
-      iob->io_free(iob->io_data);
-      kmm_free(iob);
-      return next;
-    }
+void iob_release(FAR struct iob_s *iob)
+{
+  irqstate_t flags;
+#if CONFIG_IOB_THROTTLE > 0
+  bool committed_thottled = false;
 #endif
 
   /* Free the I/O buffer by adding it to the head of the free or the
@@ -202,7 +190,7 @@ FAR struct iob_s *iob_free(FAR struct iob_s *iob)
 
       if (committed_thottled)
         {
-          g_iob_sem.semcount--;
+          atomic_fetch_sub(NXSEM_COUNT(&g_iob_sem), 1);
         }
 
       spin_unlock_irqrestore(&g_iob_lock, flags);
@@ -220,21 +208,88 @@ FAR struct iob_s *iob_free(FAR struct iob_s *iob)
   sched_unlock();
 
 #ifdef CONFIG_IOB_NOTIFIER
-  /* Check if the IOB was claimed by a thread that is blocked waiting
-   * for an IOB.
+  iob_free_notify();
+#endif
+}
+
+/****************************************************************************
+ * Name: iob_free
+ *
+ * Description:
+ *   Free the I/O buffer at the head of a buffer chain returning it to the
+ *   free list.  The link to  the next I/O buffer in the chain is return.
+ *
+ ****************************************************************************/
+
+FAR struct iob_s *iob_free(FAR struct iob_s *iob)
+{
+  FAR struct iob_s *next = iob->io_flink;
+
+  iobinfo("iob=%p io_pktlen=%u io_len=%u next=%p\n",
+          iob, iob->io_pktlen, iob->io_len, next);
+
+  /* Copy the data that only exists in the head of a I/O buffer chain into
+   * the next entry.
    */
 
-  navail = iob_navail(false);
-  if (navail > 0 && (navail & IOB_MASK) == 0)
+  if (next != NULL)
     {
-      /* Signal any threads that have requested a signal notification
-       * when an IOB becomes available.
+      /* Copy and decrement the total packet length, being careful to
+       * do nothing too crazy.
        */
 
-      iob_notifier_signal();
+      if (iob->io_pktlen > iob->io_len)
+        {
+          /* Adjust packet length and move it to the next entry */
+
+          next->io_pktlen = iob->io_pktlen - iob->io_len;
+          DEBUGASSERT(next->io_pktlen >= next->io_len);
+
+#ifdef CONFIG_NETDEV_OFFLOAD
+          next->io_gsosize = iob->io_gsosize;
+          next->io_flags   = iob->io_flags;
+#endif
+        }
+      else
+        {
+          /* This can only happen if the free entry isn't first entry in the
+           * chain...
+           */
+
+          next->io_pktlen = 0;
+        }
+
+      iobinfo("next=%p io_pktlen=%u io_len=%u\n",
+              next, next->io_pktlen, next->io_len);
+    }
+
+#ifdef CONFIG_IOB_ALLOC
+  if (iob->io_free != NULL)
+    {
+      iob->io_free(iob->io_data);
+      kmm_free(iob);
+      return next;
     }
 #endif
 
+#if defined(CONFIG_IOB_PERCPU_CACHE) && \
+    CONFIG_IOB_PERCPU_CACHE > 0
+  /* Keep the I/O buffer in the cache of this CPU unless a task may be
+   * waiting for one.
+   */
+
+  if (iob_cache_free(iob))
+    {
+#ifdef CONFIG_IOB_NOTIFIER
+      iob_free_notify();
+#endif
+    }
+  else
+#endif
+    {
+      iob_release(iob);
+    }
+
   /* And return the I/O buffer after the one that was freed */
 
   return next;
@@ -57,6 +57,13 @@ int iob_navail(bool throttled)
     {
       ret = navail;
 
+#if defined(CONFIG_IOB_PERCPU_CACHE) && \
+    CONFIG_IOB_PERCPU_CACHE > 0
+      /* The buffers cached by the CPUs are free as well */
+
+      ret += iob_cache_navail();
+#endif
+
 #if CONFIG_IOB_THROTTLE > 0
       /* Subtract the throttle value is so requested */
 
@@ -78,6 +78,14 @@ void iob_getstats(FAR struct iob_stats_s *stats)
     {
       stats->nthrottle = 0;
     }
+
+#if defined(CONFIG_IOB_PERCPU_CACHE) && \
+    CONFIG_IOB_PERCPU_CACHE > 0
+  /* The buffers held by the per-CPU caches are free as well */
+
+  iob_cache_stats(stats);
+  stats->nfree += stats->ncached;
+#endif
 }
 
 #endif /* !CONFIG_DISABLE_MOUNTPOINT && CONFIG_FS_PROCFS &&
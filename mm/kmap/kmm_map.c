@@ -147,6 +147,7 @@ static FAR void *map_pages(FAR void **pages, size_t npages, int prot)
   entry.length = size;
   entry.offset = 0;
   entry.munmap = NULL;
+  entry.fault = NULL;
 
   ret = mm_map_add(&g_kmm_map, &entry);
   if (ret < 0)
@@ -378,4 +378,48 @@ int mm_map_remove(FAR struct mm_map_s *mm,
   return -ENOENT;
 }
 
+/****************************************************************************
+ * Name: mm_map_fault
+ *
+ * Description:
+ *   Resolve an access fault through the mapping of the current task group
+ *   containing the address.  Faults in interrupt handlers, or in a critical
+ *   section where that is tracked, are never resolved.
+ *
+ ****************************************************************************/
+
+int mm_map_fault(FAR void *vaddr)
+{
+  FAR struct mm_map_entry_s *entry;
+  FAR struct mm_map_s *mm;
+
+  /* The fault callbacks may block */
+
+  if (up_interrupt_context())
+    {
+      return -EFAULT;
+    }
+
+#ifdef CONFIG_IRQCOUNT
+  if (this_task()->irqcount > 0)
+    {
+      return -EFAULT;
+    }
+#endif
+
+  mm = get_current_mm();
+  if (mm == NULL)
+    {
+      return -EFAULT;
+    }
+
+  entry = mm_map_find(mm, vaddr, 1);
+  if (entry == NULL || entry->fault == NULL)
+    {
+      return -EFAULT;
+    }
+
+  return entry->fault(entry, vaddr);
+}
+
 #endif /* defined(CONFIG_BUILD_FLAT) || defined(__KERNEL__) */
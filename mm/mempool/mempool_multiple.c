@@ -28,9 +28,11 @@
 #include <syslog.h>
 #include <sys/param.h>
 
+#include <nuttx/irq.h>
 #include <nuttx/mutex.h>
 #include <nuttx/kmalloc.h>
 #include <nuttx/mm/mempool.h>
+#include <nuttx/sched.h>
 
 #include <assert.h>
 
@@ -43,6 +45,13 @@
 #undef  ALIGN_DOWN
 #define ALIGN_DOWN(x, a)      ((size_t)(x) & (~((a) - 1)))
 
+/* Number of blocks moved between a per-CPU cache and its pool at once */
+
+#if defined(CONFIG_MM_HEAP_MEMPOOL_PERCPU_CACHE) && \
+    CONFIG_MM_HEAP_MEMPOOL_PERCPU_CACHE > 0
+#  define MPOOL_CACHE_BATCH   ((CONFIG_MM_HEAP_MEMPOOL_PERCPU_CACHE + 1) / 2)
+#endif
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -63,6 +72,29 @@ struct mpool_chunk_s
   size_t used;
 };
 
+#if defined(CONFIG_MM_HEAP_MEMPOOL_PERCPU_CACHE) && \
+    CONFIG_MM_HEAP_MEMPOOL_PERCPU_CACHE > 0
+/* The free blocks of one pool kept by one CPU, used as a stack */
+
+struct mpool_cache_s
+{
+  size_t    count;
+  FAR void *blks[CONFIG_MM_HEAP_MEMPOOL_PERCPU_CACHE];
+};
+
+/* The caches and the statistics of one CPU, only accessed by that CPU with
+ * the local interrupts disabled.
+ */
+
+struct mpool_percpu_s
+{
+  FAR struct mpool_cache_s *caches;  /* One cache per pool */
+  unsigned long             hits;
+  unsigned long             misses;
+  unsigned long             drains;
+};
+#endif
+
 struct mempool_multiple_s
 {
   FAR struct mempool_s         *pools;       /* The memory pool array */
@@ -101,6 +133,11 @@ struct mempool_multiple_s
   size_t                        dict_col_num_log2;
   size_t                        dict_row_num;
   FAR struct mpool_dict_s     **dict;
+
+#if defined(CONFIG_MM_HEAP_MEMPOOL_PERCPU_CACHE) && \
+    CONFIG_MM_HEAP_MEMPOOL_PERCPU_CACHE > 0
+  struct mpool_percpu_s         percpu[CONFIG_SMP_NCPUS];
+#endif
 };
 
 /****************************************************************************
@@ -363,6 +400,167 @@ static void mempool_multiple_check(FAR struct mempool_s *pool,
   assert(mempool_multiple_get_dict(pool->priv, blk));
 }
 
+#if defined(CONFIG_MM_HEAP_MEMPOOL_PERCPU_CACHE) && \
+    CONFIG_MM_HEAP_MEMPOOL_PERCPU_CACHE > 0
+
+/****************************************************************************
+ * Name: mempool_multiple_cache_put
+ *
+ * Description:
+ *   Put blocks into the cache of the current CPU and release the blocks
+ *   that do not fit back to the pool.
+ *
+ ****************************************************************************/
+
+static void mempool_multiple_cache_put(FAR struct mempool_multiple_s *mpool,
+                                       FAR struct mempool_s *pool,
+                                       FAR void **blks, size_t nblks)
+{
+  FAR struct mpool_cache_s *cache;
+  irqstate_t flags;
+
+  flags = up_irq_save();
+  cache = &mpool->percpu[this_cpu()].caches[pool - mpool->pools];
+  while (nblks > 0 && cache->count < CONFIG_MM_HEAP_MEMPOOL_PERCPU_CACHE)
+    {
+      cache->blks[cache->count++] = blks[--nblks];
+    }
+
+  up_irq_restore(flags);
+
+  while (nblks > 0)
+    {
+      mempool_release(pool, blks[--nblks]);
+    }
+}
+
+/****************************************************************************
+ * Name: mempool_multiple_cache_alloc
+ *
+ * Description:
+ *   Allocate a block from the cache of the current CPU.  If the cache is
+ *   empty, refill it with a batch of blocks from the pool first.
+ *
+ ****************************************************************************/
+
+static FAR void *
+mempool_multiple_cache_alloc(FAR struct mempool_multiple_s *mpool,
+                             FAR struct mempool_s *pool)
+{
+  FAR struct mpool_percpu_s *percpu;
+  FAR struct mpool_cache_s *cache;
+  FAR void *blks[MPOOL_CACHE_BATCH];
+  FAR void *blk;
+  irqstate_t flags;
+  size_t nblks;
+
+  flags  = up_irq_save();
+  percpu = &mpool->percpu[this_cpu()];
+  cache  = &percpu->caches[pool - mpool->pools];
+  if (cache->count > 0)
+    {
+      blk = cache->blks[--cache->count];
+      percpu->hits++;
+      up_irq_restore(flags);
+      return blk;
+    }
+
+  percpu->misses++;
+  up_irq_restore(flags);
+
+  /* The pool may expand, which can block, so refill with the interrupts
+   * enabled.  We may run on another CPU afterwards, which only means that
+   * the batch is cached there.
+   */
+
+  blk = mempool_allocate(pool);
+  if (blk == NULL)
+    {
+      return NULL;
+    }
+
+  for (nblks = 0; nblks < MPOOL_CACHE_BATCH - 1; nblks++)
+    {
+      blks[nblks] = mempool_allocate(pool);
+      if (blks[nblks] == NULL)
+        {
+          break;
+        }
+    }
+
+  mempool_multiple_cache_put(mpool, pool, blks, nblks);
+  return blk;
+}
+
+/****************************************************************************
+ * Name: mempool_multiple_cache_free
+ *
+ * Description:
+ *   Free a block to the cache of the current CPU.  If the cache is full,
+ *   drain a batch of blocks back to the pool.
+ *
+ ****************************************************************************/
+
+static void mempool_multiple_cache_free(FAR struct mempool_multiple_s *mpool,
+                                        FAR struct mempool_s *pool,
+                                        FAR void *blk)
+{
+  FAR struct mpool_percpu_s *percpu;
+  FAR struct mpool_cache_s *cache;
+  FAR void *blks[MPOOL_CACHE_BATCH];
+  irqstate_t flags;
+  size_t nblks = 0;
+
+  flags  = up_irq_save();
+  percpu = &mpool->percpu[this_cpu()];
+  cache  = &percpu->caches[pool - mpool->pools];
+  if (cache->count >= CONFIG_MM_HEAP_MEMPOOL_PERCPU_CACHE)
+    {
+      percpu->drains++;
+      while (nblks < MPOOL_CACHE_BATCH)
+        {
+          blks[nblks++] = cache->blks[--cache->count];
+        }
+    }
+
+  cache->blks[cache->count++] = blk;
+  up_irq_restore(flags);
+
+  while (nblks > 0)
+    {
+      mempool_release(pool, blks[--nblks]);
+    }
+}
+
+/****************************************************************************
+ * Name: mempool_multiple_cache_drain
+ *
+ * Description:
+ *   Release all the blocks held by the per-CPU caches back to the pools.
+ *
+ ****************************************************************************/
+
+static void mempool_multiple_cache_drain(FAR struct mempool_multiple_s *mpool)
+{
+  FAR struct mpool_cache_s *cache;
+  size_t i;
+  int cpu;
+
+  for (cpu = 0; cpu < CONFIG_SMP_NCPUS; cpu++)
+    {
+      for (i = 0; i < mpool->npools; i++)
+        {
+          cache = &mpool->percpu[cpu].caches[i];
+          while (cache->count > 0)
+            {
+              mempool_release(mpool->pools + i,
+                              cache->blks[--cache->count]);
+            }
+        }
+    }
+}
+#endif /* CONFIG_MM_HEAP_MEMPOOL_PERCPU_CACHE > 0 */
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -506,6 +704,35 @@ mempool_multiple_init(FAR const char *name,
 
   memset(mpool->dict, 0,
          mpool->dict_row_num * sizeof(FAR struct mpool_dict_s *));
+
+#if defined(CONFIG_MM_HEAP_MEMPOOL_PERCPU_CACHE) && \
+    CONFIG_MM_HEAP_MEMPOOL_PERCPU_CACHE > 0
+  for (i = 0; i < CONFIG_SMP_NCPUS; i++)
+    {
+      FAR struct mpool_percpu_s *percpu = &mpool->percpu[i];
+
+      percpu->caches = mempool_multiple_alloc_chunk(
+                         mpool, sizeof(uintptr_t),
+                         npools * sizeof(struct mpool_cache_s));
+      if (percpu->caches == NULL)
+        {
+          while (--i >= 0)
+            {
+              mempool_multiple_free_chunk(mpool, mpool->percpu[i].caches);
+            }
+
+          mempool_multiple_free_chunk(mpool, mpool->dict);
+          i = npools;
+          goto err_with_pools;
+        }
+
+      memset(percpu->caches, 0, npools * sizeof(struct mpool_cache_s));
+      percpu->hits   = 0;
+      percpu->misses = 0;
+      percpu->drains = 0;
+    }
+#endif
+
   nxrmutex_init(&mpool->lock);
 
   return mpool;
@@ -545,6 +772,7 @@ FAR void *mempool_multiple_alloc(FAR struct mempool_multiple_s *mpool,
 {
   FAR struct mempool_s *end;
   FAR struct mempool_s *pool;
+  FAR void *blk;
 
   pool = mempool_multiple_find(mpool, size);
   if (pool == NULL)
@@ -552,17 +780,30 @@ FAR void *mempool_multiple_alloc(FAR struct mempool_multiple_s *mpool,
       return NULL;
     }
 
-  end = mpool->pools + mpool->npools;
-  do
+#if defined(CONFIG_MM_HEAP_MEMPOOL_PERCPU_CACHE) && \
+    CONFIG_MM_HEAP_MEMPOOL_PERCPU_CACHE > 0
+  /* Try the cache of the current CPU first, the pool of this size is
+   * exhausted if it fails.
+   */
+
+  blk = mempool_multiple_cache_alloc(mpool, pool);
+  if (blk != NULL)
     {
-      FAR void *blk = mempool_allocate(pool);
+      return blk;
+    }
+
+  pool++;
+#endif
 
+  end = mpool->pools + mpool->npools;
+  while (pool < end)
+    {
+      blk = mempool_allocate(pool++);
       if (blk)
         {
           return blk;
         }
     }
-  while (++pool < end);
 
   return NULL;
 }
@@ -641,7 +882,12 @@ int mempool_multiple_free(FAR struct mempool_multiple_s *mpool,
   blk = (FAR char *)blk - (((FAR char *)blk -
                            ((FAR char *)dict->addr + mpool->minpoolsize)) %
                            MEMPOOL_REALBLOCKSIZE(dict->pool));
+#if defined(CONFIG_MM_HEAP_MEMPOOL_PERCPU_CACHE) && \
+    CONFIG_MM_HEAP_MEMPOOL_PERCPU_CACHE > 0
+  mempool_multiple_cache_free(mpool, dict->pool, blk);
+#else
   mempool_release(dict->pool, blk);
+#endif
   return 0;
 }
 
@@ -755,6 +1001,10 @@ mempool_multiple_mallinfo(FAR struct mempool_multiple_s *mpool)
 {
   struct mallinfo info;
   size_t i;
+#if defined(CONFIG_MM_HEAP_MEMPOOL_PERCPU_CACHE) && \
+    CONFIG_MM_HEAP_MEMPOOL_PERCPU_CACHE > 0
+  int cpu;
+#endif
 
   if (mpool == NULL)
     {
@@ -782,6 +1032,20 @@ mempool_multiple_mallinfo(FAR struct mempool_multiple_s *mpool)
       struct mempoolinfo_s poolinfo;
 
       mempool_info(mpool->pools + i, &poolinfo);
+
+#if defined(CONFIG_MM_HEAP_MEMPOOL_PERCPU_CACHE) && \
+    CONFIG_MM_HEAP_MEMPOOL_PERCPU_CACHE > 0
+      /* The blocks held by the per-CPU caches are free */
+
+      for (cpu = 0; cpu < CONFIG_SMP_NCPUS; cpu++)
+        {
+          size_t count = mpool->percpu[cpu].caches[i].count;
+
+          poolinfo.ordblks  += count;
+          poolinfo.aordblks -= count;
+        }
+#endif
+
       info.fordblks += (poolinfo.ordblks + poolinfo.iordblks)
                        * poolinfo.sizeblks;
       info.ordblks += poolinfo.ordblks + poolinfo.iordblks;
@@ -824,6 +1088,39 @@ mempool_multiple_info_task(FAR struct mempool_multiple_s *mpool,
   return ret;
 }
 
+/****************************************************************************
+ * Name: mempool_multiple_cacheinfo
+ ****************************************************************************/
+
+#if defined(CONFIG_MM_HEAP_MEMPOOL_PERCPU_CACHE) && \
+    CONFIG_MM_HEAP_MEMPOOL_PERCPU_CACHE > 0
+void mempool_multiple_cacheinfo(FAR struct mempool_multiple_s *mpool,
+                                FAR struct mempool_cacheinfo_s *info)
+{
+  size_t i;
+  int cpu;
+
+  memset(info, 0, sizeof(*info));
+  if (mpool == NULL)
+    {
+      return;
+    }
+
+  for (cpu = 0; cpu < CONFIG_SMP_NCPUS; cpu++)
+    {
+      FAR struct mpool_percpu_s *percpu = &mpool->percpu[cpu];
+
+      info->hits   += percpu->hits;
+      info->misses += percpu->misses;
+      info->drains += percpu->drains;
+      for (i = 0; i < mpool->npools; i++)
+        {
+          info->cached += percpu->caches[i].count;
+        }
+    }
+}
+#endif
+
 /****************************************************************************
  * Name: mempool_multiple_memdump
  *
@@ -877,6 +1174,11 @@ void mempool_multiple_deinit(FAR struct mempool_multiple_s *mpool)
       return;
     }
 
+#if defined(CONFIG_MM_HEAP_MEMPOOL_PERCPU_CACHE) && \
+    CONFIG_MM_HEAP_MEMPOOL_PERCPU_CACHE > 0
+  mempool_multiple_cache_drain(mpool);
+#endif
+
   for (i = 0; i < mpool->npools; i++)
     {
       DEBUGVERIFY(mempool_deinit(mpool->pools + i));
@@ -894,6 +1196,14 @@ void mempool_multiple_deinit(FAR struct mempool_multiple_s *mpool)
         }
     }
 
+#if defined(CONFIG_MM_HEAP_MEMPOOL_PERCPU_CACHE) && \
+    CONFIG_MM_HEAP_MEMPOOL_PERCPU_CACHE > 0
+  for (i = 0; i < CONFIG_SMP_NCPUS; i++)
+    {
+      mempool_multiple_free_chunk(mpool, mpool->percpu[i].caches);
+    }
+#endif
+
   mempool_multiple_free_chunk(mpool, mpool->dict);
   mempool_multiple_free_chunk(mpool, mpool->pools);
   nxrmutex_destroy(&mpool->lock);
@@ -47,6 +47,12 @@
 #define SIZEOF_GRAN_S(n) \
   (sizeof(struct gran_s) + sizeof(uint32_t) * (SIZEOF_GAT(n) - 1))
 
+/* Number of search hints: one per power of two up to the largest possible
+ * number of granules.
+ */
+
+#define GRAN_NHINTS 16
+
 /* Debug */
 
 #ifdef CONFIG_DEBUG_GRAN
@@ -77,6 +83,7 @@ struct gran_s
   mutex_t    lock;       /* For exclusive access to the GAT */
 #endif
   uintptr_t  heapstart; /* The aligned start of the granule heap */
+  uint16_t   hint[GRAN_NHINTS]; /* No free range of 2^n granules below */
   uint32_t   gat[1];    /* Start of the granule allocation table */
 };
 
@@ -81,4 +81,47 @@ FAR void *gran_alloc(GRAN_HANDLE handle, size_t size)
   return (FAR void *)retp;
 }
 
+size_t gran_alloc_batch(GRAN_HANDLE handle, size_t size,
+                        FAR void **mem, size_t count)
+{
+  FAR gran_t *gran = (FAR gran_t *)handle;
+  size_t ngran;
+  size_t i;
+  int posi;
+
+  DEBUGASSERT(gran && (mem || !count));
+  ngran = NGRANULE(gran, size);
+  if (!ngran || ngran > gran->ngranules)
+    {
+      return 0;
+    }
+
+  if (gran_enter_critical(gran) < 0)
+    {
+      return 0;
+    }
+
+  /* Each search resumes where the previous one stopped thanks to the hint
+   * of the size class.
+   */
+
+  for (i = 0; i < count; i++)
+    {
+      posi = gran_search(gran, ngran);
+      if (posi < 0)
+        {
+          break;
+        }
+
+      gran_set(gran, posi, ngran);
+      mem[i] = (FAR void *)(gran->heapstart + (posi << gran->log2gran));
+    }
+
+  gran_leave_critical(gran);
+
+  graninfo("heap=%"PRIxPTR" size=%zu n=%zu count=%zu/%zu\n",
+           gran->heapstart, size, ngran, i, count);
+  return i;
+}
+
 #endif /* CONFIG_GRAN */
@@ -90,6 +90,30 @@ uint32_t lsb_mask(uint32_t n)
   return (-n & n) & GATCFULL;
 }
 
+/* return the number of trailing zeros of a non-zero n */
+
+static unsigned int gran_ctz(uint32_t n)
+{
+  DEBUGASSERT(n);
+#ifdef CONFIG_HAVE_BUILTIN_CTZ
+  return __builtin_ctz(n);
+#else
+  return DEBRUJIN_LUT[(uint32_t)(lsb_mask(n) * DEBRUJIN_NUM) >> 27];
+#endif
+}
+
+/* return the search hint class of a range size, that is log2(size) */
+
+static unsigned int gran_hintclass(size_t size)
+{
+  DEBUGASSERT(size > 0 && size < BIT(GRAN_NHINTS));
+#ifdef CONFIG_HAVE_BUILTIN_CLZ
+  return 31 - __builtin_clz(size);
+#else
+  return DEBRUJIN_LUT[(uint32_t)(msb_mask(size) * DEBRUJIN_NUM) >> 27];
+#endif
+}
+
 /* set or clear a GAT cell with given bit mask */
 
 static void cell_set(gran_t *gran, uint32_t cell, uint32_t mask, bool val)
@@ -236,27 +260,95 @@ failure:
   return false;
 }
 
-/* returns granule number of free range or negative error */
-
-int gran_search(const gran_t *gran, size_t size)
+/* returns granule number of free range or negative error.
+ *
+ * The GAT is scanned a cell at a time: runs of free or used granules are
+ * skipped with a single count of trailing zeros or ones.  The scan starts
+ * from the hint of the size class, below which there is no free range as
+ * large as the smallest size of the class, and the hint is moved to the
+ * first such range met on the way.
+ */
+
+int gran_search(gran_t *gran, size_t size)
 {
+  size_t   posi;   /* current granule */
+  size_t   start;  /* start of the current free range */
+  size_t   run;    /* length of the current free range */
+  size_t   first;  /* start of the first free range in the class */
+  size_t   least;  /* smallest size of the class */
+  uint32_t v;      /* remaining bits of the current cell */
+  unsigned int bit;
+  unsigned int n;
+  unsigned int k;
   int ret = -EINVAL;
 
-  if (gran == NULL || gran->ngranules < size)
+  if (gran == NULL || size == 0 || gran->ngranules < size)
     {
       return ret;
     }
 
-  ret = -ENOMEM;
-  for (size_t i = 0; i <= gran->ngranules - size; i++)
+  /* A free range crossing the hint has less than 'least' granules below
+   * it, so it starts at most least - 1 granules before the hint.
+   */
+
+  k     = gran_hintclass(size);
+  least = BIT(k);
+  posi  = gran->hint[k] + 1 > least ? gran->hint[k] + 1 - least : 0;
+  first = gran->ngranules;
+  start = 0;
+  run   = 0;
+
+  while (posi < gran->ngranules)
     {
-      if (gran_match(gran, i, size, 0, &i))
+      bit = posi % GATC_BITS(gran);
+      v   = gran->gat[posi / GATC_BITS(gran)] >> bit;
+
+      if (v & 1)
         {
-          ret = i;
+          /* Skip the used granules */
+
+          run   = 0;
+          posi += v == GATCFULL ? GATC_BITS(gran) : gran_ctz(~v);
+          continue;
+        }
+
+      /* Count the free granules up to the next used one or the end of the
+       * cell.
+       */
+
+      n = v == 0 ? GATC_BITS(gran) - bit : gran_ctz(v);
+      if (run == 0)
+        {
+          start = posi;
+        }
+
+      run  += n;
+      posi += n;
+
+      if (run >= least && start < first)
+        {
+          first = start;
+        }
+
+      if (run >= size)
+        {
+          /* The unused bits of the last cell read as free */
+
+          if (start + size <= gran->ngranules)
+            {
+              ret = start;
+            }
+
           break;
         }
     }
 
+  if (ret < 0)
+    {
+      ret = -ENOMEM;
+    }
+
+  gran->hint[k] = first;
   return ret;
 }
 
@@ -285,6 +377,20 @@ int gran_clear(gran_t *gran, size_t posi, size_t size)
   if (ret == OK)
     {
       gran_set_(gran, &rang, false);
+
+      /* A free range merged with the cleared one extends up to posi at
+       * least, so no hint above posi remains valid.
+       */
+
+      for (ret = 0; ret < GRAN_NHINTS; ret++)
+        {
+          if (gran->hint[ret] > posi)
+            {
+              gran->hint[ret] = posi;
+            }
+        }
+
+      ret = OK;
     }
 
   return ret;
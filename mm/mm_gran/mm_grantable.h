@@ -129,7 +129,8 @@ bool gran_match(const gran_t *gran, size_t posi, size_t size, bool used,
  * Name: gran_search
  *
  * Description:
- *   search for continuous range of free granules
+ *   search for the first continuous range of free granules, updating the
+ *   search hint of the size class of the range
  *
  * Input Parameters:
  *   gran - Pointer to the gran state
@@ -139,7 +140,7 @@ bool gran_match(const gran_t *gran, size_t posi, size_t size, bool used,
  *   position of negative error number.
  ****************************************************************************/
 
-int gran_search(const gran_t *gran, size_t size);
+int gran_search(gran_t *gran, size_t size);
 
 /****************************************************************************
  * Name: gran_set, gran_clear
@@ -190,6 +190,23 @@ struct mallinfo_task mm_mallinfo_task(FAR struct mm_heap_s *heap,
   return info;
 }
 
+/****************************************************************************
+ * Name: mm_mempool_cacheinfo
+ *
+ * Description:
+ *   Return the statistics of the per-CPU caches of the heap mempool
+ *
+ ****************************************************************************/
+
+#if defined(CONFIG_MM_HEAP_MEMPOOL_PERCPU_CACHE) && \
+    CONFIG_MM_HEAP_MEMPOOL_PERCPU_CACHE > 0
+void mm_mempool_cacheinfo(FAR struct mm_heap_s *heap,
+                          FAR struct mempool_cacheinfo_s *info)
+{
+  mempool_multiple_cacheinfo(heap->mm_mpool, info);
+}
+#endif
+
 /****************************************************************************
  * Name: mm_heapfree
  *
@@ -271,6 +271,7 @@ FAR void *shmat(int shmid, FAR const void *shmaddr, int shmflg)
   entry.offset = 0;
   entry.munmap = munmap_shm;
   entry.priv.i = shmid;
+  entry.fault = NULL;
 
   ret = mm_map_add(get_current_mm(), &entry);
   if (ret < 0)
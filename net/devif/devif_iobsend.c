@@ -74,7 +74,10 @@ int devif_iob_send(FAR struct net_driver_s *dev, FAR struct iob_s *iob,
     }
 
 #ifndef CONFIG_NET_IPFRAG
-  if (len > NETDEV_PKTSIZE(dev) - NET_LL_HDRLEN(dev) - target_offset)
+  /* Only packets marked for segmentation by the device may be larger */
+
+  if (len > NETDEV_PKTSIZE(dev) - NET_LL_HDRLEN(dev) - target_offset &&
+      NETDEV_GSOSIZE(dev) == 0)
     {
       ret = -EMSGSIZE;
       goto errout;
@@ -110,6 +113,17 @@ int devif_iob_send(FAR struct net_driver_s *dev, FAR struct iob_s *iob,
   return dev->d_sndlen;
 
 errout:
+#ifdef CONFIG_NETDEV_OFFLOAD
+  /* Do not leave the segmentation request of a packet that was not sent
+   * on the device buffer, it would apply to the next packet built there.
+   */
+
+  if (dev != NULL && dev->d_iob != NULL)
+    {
+      NETDEV_GSOSIZE(dev) = 0;
+    }
+#endif
+
   nerr("ERROR: devif_iob_send error: %d\n", ret);
   return ret;
 }
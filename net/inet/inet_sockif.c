@@ -96,6 +96,12 @@ static ssize_t    inet_sendmsg(FAR struct socket *psock,
                                FAR struct msghdr *msg, int flags);
 static ssize_t    inet_recvmsg(FAR struct socket *psock,
                                FAR struct msghdr *msg, int flags);
+static int        inet_sendmmsg(FAR struct socket *psock,
+                                FAR struct mmsghdr *msgvec,
+                                unsigned int vlen, int flags);
+static int        inet_recvmmsg(FAR struct socket *psock,
+                                FAR struct mmsghdr *msgvec,
+                                unsigned int vlen, int flags);
 static int        inet_ioctl(FAR struct socket *psock,
                              int cmd, unsigned long arg);
 static int        inet_socketpair(FAR struct socket *psocks[2]);
@@ -143,6 +149,8 @@ static const struct sock_intf_s g_inet_sockif =
 #ifdef CONFIG_NET_SENDFILE
   , inet_sendfile   /* si_sendfile */
 #endif
+  , inet_sendmmsg   /* si_sendmmsg */
+  , inet_recvmmsg   /* si_recvmmsg */
 };
 
 /****************************************************************************
@@ -2361,6 +2369,119 @@ static ssize_t inet_recvmsg(FAR struct socket *psock,
   return ret;
 }
 
+/****************************************************************************
+ * Name: inet_sendmmsg
+ *
+ * Description:
+ *   Implements the batched sendmmsg() for the AF_INET and AF_INET6 address
+ *   families.  Datagrams are sent with the network locked once for the
+ *   whole batch; the UDP send logic only releases the lock while it waits.
+ *   With write buffers, the whole batch is thus queued before the device
+ *   is polled.
+ *
+ * Input Parameters:
+ *   psock    An instance of the internal socket structure.
+ *   msgvec   The messages to send
+ *   vlen     The number of messages
+ *   flags    Send flags
+ *
+ * Returned Value:
+ *   On success, returns the number of messages sent.  If the first message
+ *   cannot be sent, a negated errno value is returned.
+ *
+ ****************************************************************************/
+
+static int inet_sendmmsg(FAR struct socket *psock,
+                         FAR struct mmsghdr *msgvec, unsigned int vlen,
+                         int flags)
+{
+  bool dgram = psock->s_type == SOCK_DGRAM;
+  ssize_t nbytes = 0;
+  unsigned int n;
+
+  if (dgram)
+    {
+      net_lock();
+    }
+
+  for (n = 0; n < vlen; n++)
+    {
+      nbytes = inet_sendmsg(psock, &msgvec[n].msg_hdr, flags);
+      if (nbytes < 0)
+        {
+          break;
+        }
+
+      msgvec[n].msg_len = nbytes;
+    }
+
+  if (dgram)
+    {
+      net_unlock();
+    }
+
+  return n > 0 ? n : nbytes;
+}
+
+/****************************************************************************
+ * Name: inet_recvmmsg
+ *
+ * Description:
+ *   Implements the batched recvmmsg() for the AF_INET and AF_INET6 address
+ *   families: the datagrams already buffered by a UDP socket are all taken
+ *   with the network locked once.  Other socket types are left to
+ *   inet_recvmsg().
+ *
+ * Input Parameters:
+ *   psock    A pointer to a NuttX-specific, internal socket structure
+ *   msgvec   Buffers to receive the messages
+ *   vlen     The number of buffers
+ *   flags    Receive flags
+ *
+ * Returned Value:
+ *   The number of messages received, zero if none was buffered.
+ *
+ ****************************************************************************/
+
+static int inet_recvmmsg(FAR struct socket *psock,
+                         FAR struct mmsghdr *msgvec, unsigned int vlen,
+                         int flags)
+{
+#if defined(CONFIG_NET_UDP) && defined(NET_UDP_HAVE_STACK)
+  socklen_t minlen;
+  unsigned int n;
+
+  if (psock->s_type != SOCK_DGRAM)
+    {
+      return 0;
+    }
+
+#if defined(CONFIG_NET_IPv4) && defined(CONFIG_NET_IPv6)
+  minlen = psock->s_domain == PF_INET ? sizeof(struct sockaddr_in) :
+                                        sizeof(struct sockaddr_in6);
+#elif defined(CONFIG_NET_IPv4)
+  minlen = sizeof(struct sockaddr_in);
+#else
+  minlen = sizeof(struct sockaddr_in6);
+#endif
+
+  /* Stop before the first message that inet_recvmsg() would reject */
+
+  for (n = 0; n < vlen; n++)
+    {
+      if (msgvec[n].msg_hdr.msg_name != NULL &&
+          msgvec[n].msg_hdr.msg_namelen < minlen)
+        {
+          break;
+        }
+    }
+
+  return n > 0 ? psock_udp_recvmmsg(psock, msgvec, n, flags) : 0;
+#else
+  return 0;
+#endif
+}
+
 #endif /* NET_UDP_HAVE_STACK || NET_TCP_HAVE_STACK */
 
 /****************************************************************************
@@ -1246,7 +1246,9 @@ int32_t ip_fragout(FAR struct net_driver_s *dev)
       return -EINVAL;
     }
 
-  if (dev->d_iob->io_pktlen <= mtu)
+  /* Segments built for TSO are split by the device itself */
+
+  if (dev->d_iob->io_pktlen <= mtu || NETDEV_GSOSIZE(dev) > 0)
     {
       return OK;
     }
@@ -233,6 +233,28 @@ uint16_t pkt_callback(FAR struct net_driver_s *dev,
 ssize_t pkt_recvmsg(FAR struct socket *psock, FAR struct msghdr *msg,
                     int flags);
 
+/****************************************************************************
+ * Name: pkt_recvmmsg
+ *
+ * Description:
+ *   Implements the batched recvmmsg() for packet sockets: the packets
+ *   already buffered in the read-ahead queue are taken, up to vlen of them,
+ *   with the network locked only once.  This never waits for new packets.
+ *
+ * Input Parameters:
+ *   psock    A pointer to a NuttX-specific, internal socket structure
+ *   msgvec   Buffers to receive the packets
+ *   vlen     The number of buffers
+ *   flags    Receive flags
+ *
+ * Returned Value:
+ *   The number of packets received, zero if none was buffered.
+ *
+ ****************************************************************************/
+
+int pkt_recvmmsg(FAR struct socket *psock, FAR struct mmsghdr *msgvec,
+                 unsigned int vlen, int flags);
+
 /****************************************************************************
  * Name: pkt_find_device
  *
@@ -500,4 +500,57 @@ errout_with_state:
   return ret;
 }
 
+/****************************************************************************
+ * Name: pkt_recvmmsg
+ *
+ * Description:
+ *   Implements the batched recvmmsg() for packet sockets: the packets
+ *   already buffered in the read-ahead queue are taken, up to vlen of them,
+ *   with the network locked only once.  This never waits for new packets.
+ *
+ * Input Parameters:
+ *   psock    A pointer to a NuttX-specific, internal socket structure
+ *   msgvec   Buffers to receive the packets
+ *   vlen     The number of buffers
+ *   flags    Receive flags
+ *
+ * Returned Value:
+ *   The number of packets received, zero if none was buffered.
+ *
+ ****************************************************************************/
+
+int pkt_recvmmsg(FAR struct socket *psock, FAR struct mmsghdr *msgvec,
+                 unsigned int vlen, int flags)
+{
+  FAR struct pkt_conn_s *conn = psock->s_conn;
+  FAR struct msghdr *msg;
+  unsigned int n;
+
+  if (psock->s_type != SOCK_RAW)
+    {
+      return 0;
+    }
+
+  net_lock();
+
+  for (n = 0; n < vlen && !IOB_QEMPTY(&conn->readahead); n++)
+    {
+      msg = &msgvec[n].msg_hdr;
+
+      /* Leave a message pkt_recvmsg() would reject to it */
+
+      if (msg->msg_name != NULL && msg->msg_namelen < sizeof(sa_family_t))
+        {
+          break;
+        }
+
+      msgvec[n].msg_len   = pkt_readahead(conn, msg->msg_iov->iov_base,
+                                          msg->msg_iov->iov_len);
+      msg->msg_controllen = 0;
+    }
+
+  net_unlock();
+  return n;
+}
+
 #endif /* CONFIG_NET */
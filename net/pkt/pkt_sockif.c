@@ -74,7 +74,19 @@ const struct sock_intf_s g_pkt_sockif =
   NULL,            /* si_poll */
   pkt_sendmsg,     /* si_sendmsg */
   pkt_recvmsg,     /* si_recvmsg */
-  pkt_close        /* si_close */
+  pkt_close,       /* si_close */
+  NULL,            /* si_ioctl */
+  NULL,            /* si_socketpair */
+  NULL             /* si_shutdown */
+#ifdef CONFIG_NET_SOCKOPTS
+  , NULL           /* si_getsockopt */
+  , NULL           /* si_setsockopt */
+#endif
+#ifdef CONFIG_NET_SENDFILE
+  , NULL           /* si_sendfile */
+#endif
+  , NULL           /* si_sendmmsg */
+  , pkt_recvmmsg   /* si_recvmmsg */
 };
 
 /****************************************************************************
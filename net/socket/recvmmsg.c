@@ -0,0 +1,283 @@
+/****************************************************************************
+ * net/socket/recvmmsg.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdbool.h>
+#include <assert.h>
+#include <errno.h>
+
+#include <nuttx/cancelpt.h>
+#include <nuttx/clock.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/net/net.h>
+
+#include "socket/socket.h"
+
+#ifdef CONFIG_NET
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: recvmmsg_verify
+ *
+ * Description:
+ *   Apply the checks of psock_recvmsg() to a message of the vector.
+ *
+ ****************************************************************************/
+
+static int recvmmsg_verify(FAR struct msghdr *msg)
+{
+  if (msg->msg_iov == NULL || msg->msg_iov->iov_base == NULL)
+    {
+      return -EINVAL;
+    }
+
+  if (msg->msg_name != NULL && msg->msg_namelen <= 0)
+    {
+      return -EINVAL;
+    }
+
+  if (msg->msg_iovlen != 1)
+    {
+      return -ENOTSUP;
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: psock_recvmmsg
+ *
+ * Description:
+ *   psock_recvmmsg() receives several messages from a socket.  This is an
+ *   internal OS interface.  It is functionally equivalent to recvmmsg()
+ *   except that:
+ *
+ *   - It is not a cancellation point,
+ *   - It does not modify the errno variable, and
+ *   - It accepts the internal socket structure as an input rather than an
+ *     task-specific socket descriptor.
+ *
+ *   The messages already queued on the socket are taken in batches by the
+ *   si_recvmmsg() method of the address family, if it provides one.  Only
+ *   when nothing is queued is a single message received with
+ *   si_recvmsg(), which may block.
+ *
+ * Input Parameters:
+ *   psock     A pointer to a NuttX-specific, internal socket structure
+ *   msgvec    Buffers to receive the messages
+ *   vlen      The number of buffers
+ *   flags     Receive flags
+ *   timeout   Time after which no more message is waited for, may be NULL
+ *
+ * Returned Value:
+ *   On success, returns the number of messages received.  Otherwise, on
+ *   any failure before the first message, a negated errno value is
+ *   returned (see comments with recvmsg() for a list of appropriate errno
+ *   values).
+ *
+ ****************************************************************************/
+
+int psock_recvmmsg(FAR struct socket *psock, FAR struct mmsghdr *msgvec,
+                   unsigned int vlen, int flags,
+                   FAR const struct timespec *timeout)
+{
+  FAR const struct sock_intf_s *sockif;
+  clock_t deadline = 0;
+  bool waitforone;
+  unsigned int n;
+  ssize_t nbytes;
+  int ret;
+
+  /* Verify that the sockfd corresponds to valid, allocated socket */
+
+  if (psock == NULL || psock->s_conn == NULL)
+    {
+      return -EBADF;
+    }
+
+  if (msgvec == NULL)
+    {
+      return -EINVAL;
+    }
+
+  /* Receive at most up to the first malformed message */
+
+  for (n = 0; n < vlen; n++)
+    {
+      ret = recvmmsg_verify(&msgvec[n].msg_hdr);
+      if (ret < 0)
+        {
+          if (n == 0)
+            {
+              return ret;
+            }
+
+          vlen = n;
+          break;
+        }
+    }
+
+  if (timeout != NULL)
+    {
+      deadline = clock_systime_ticks() + clock_time2ticks(timeout);
+    }
+
+  sockif = psock->s_sockif;
+  DEBUGASSERT(sockif != NULL && sockif->si_recvmsg != NULL);
+
+  waitforone = (flags & MSG_WAITFORONE) != 0;
+  flags &= ~MSG_WAITFORONE;
+
+  for (n = 0; n < vlen; n += ret)
+    {
+      /* Take the messages that are already queued in one go.  Peeked and
+       * zero-copy messages take the checks of the single message path.
+       */
+
+      ret = 0;
+      if (sockif->si_recvmmsg != NULL &&
+          (flags & (MSG_PEEK | MSG_ZEROCOPY)) == 0)
+        {
+          ret = sockif->si_recvmmsg(psock, &msgvec[n], vlen - n, flags);
+        }
+
+      /* Nothing queued, wait for the next message */
+
+      if (ret == 0)
+        {
+          nbytes = psock_recvmsg(psock, &msgvec[n].msg_hdr, flags);
+          if (nbytes >= 0)
+            {
+              msgvec[n].msg_len = nbytes;
+              ret = 1;
+            }
+          else
+            {
+              ret = nbytes;
+            }
+        }
+
+      /* An error is only reported if nothing was received */
+
+      if (ret < 0)
+        {
+          return n > 0 ? n : ret;
+        }
+
+      /* A peeked message stays queued, there is nothing more to get */
+
+      if ((flags & MSG_PEEK) != 0)
+        {
+          return 1;
+        }
+
+      /* Don't block again after the first message if so requested */
+
+      if (waitforone)
+        {
+          flags |= MSG_DONTWAIT;
+        }
+
+      if (timeout != NULL && clock_compare(deadline, clock_systime_ticks()))
+        {
+          return n + ret;
+        }
+    }
+
+  return n;
+}
+
+/****************************************************************************
+ * Function: recvmmsg
+ *
+ * Description:
+ *   recvmmsg() receives several messages from a socket with a single call.
+ *   Each message is received as by recvmsg() and the msg_len field of its
+ *   mmsghdr is set to the number of bytes received.
+ *
+ *   Unless MSG_DONTWAIT or MSG_WAITFORONE is given or the socket is
+ *   non-blocking, recvmmsg() waits until vlen messages were received.  With
+ *   MSG_WAITFORONE, it only waits for the first one.  If timeout is not
+ *   NULL, no further message is waited for once it has elapsed; as on
+ *   other systems, it is only checked after each message received.
+ *
+ * Parameters:
+ *   sockfd   Socket descriptor of socket
+ *   msgvec   Buffers to receive the messages
+ *   vlen     The number of buffers
+ *   flags    Receive flags
+ *   timeout  Time after which no more message is waited for, may be NULL
+ *
+ * Returned Value:
+ *   On success, returns the number of messages received.  On error, -1 is
+ *   returned, and errno is set appropriately (see recvmsg()).  An error
+ *   occurring after at least one message was received is not reported.
+ *
+ ****************************************************************************/
+
+int recvmmsg(int sockfd, FAR struct mmsghdr *msgvec, unsigned int vlen,
+             int flags, FAR struct timespec *timeout)
+{
+  FAR struct socket *psock;
+  FAR struct file *filep;
+  int ret;
+
+  /* recvmmsg() is a cancellation point */
+
+  enter_cancellation_point();
+
+  /* Get the underlying socket structure */
+
+  ret = sockfd_socket(sockfd, &filep, &psock);
+
+  /* Let psock_recvmmsg() do all of the work */
+
+  if (ret == OK)
+    {
+      ret = psock_recvmmsg(psock, msgvec, vlen, flags, timeout);
+      fs_putfilep(filep);
+    }
+
+  if (ret < 0)
+    {
+      set_errno(-ret);
+      ret = ERROR;
+    }
+
+  leave_cancellation_point();
+  return ret;
+}
+
+#endif /* CONFIG_NET */
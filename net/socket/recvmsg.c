@@ -32,6 +32,7 @@
 #include <nuttx/cancelpt.h>
 #include <nuttx/fs/fs.h>
 #include <nuttx/net/net.h>
+#include <nuttx/sched.h>
 
 #include "socket/socket.h"
 
@@ -100,6 +101,31 @@ ssize_t psock_recvmsg(FAR struct socket *psock, FAR struct msghdr *msg,
       return -EBADF;
     }
 
+  /* A zero-copy receive hands out I/O buffers in kernel memory.  It is
+   * only supported by UDP and, unless the build is flat, by kernel threads.
+   */
+
+  if ((flags & MSG_ZEROCOPY) != 0)
+    {
+#ifdef CONFIG_NET_UDP_ZEROCOPY
+      if (psock->s_type != SOCK_DGRAM ||
+          (psock->s_domain != PF_INET && psock->s_domain != PF_INET6))
+        {
+          return -EOPNOTSUPP;
+        }
+
+#  ifndef CONFIG_BUILD_FLAT
+      if ((nxsched_self()->flags & TCB_FLAG_TTYPE_MASK) !=
+          TCB_FLAG_TTYPE_KERNEL)
+        {
+          return -EOPNOTSUPP;
+        }
+#  endif
+#else
+      return -EOPNOTSUPP;
+#endif
+    }
+
   /* Let logic specific to this address family handle the recvmsg()
    * operation.
    */
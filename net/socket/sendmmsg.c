@@ -0,0 +1,191 @@
+/****************************************************************************
+ * net/socket/sendmmsg.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <assert.h>
+#include <errno.h>
+
+#include <nuttx/cancelpt.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/net/net.h>
+
+#include "socket/socket.h"
+
+#ifdef CONFIG_NET
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: psock_sendmmsg
+ *
+ * Description:
+ *   psock_sendmmsg() sends several messages to a socket.  This is an
+ *   internal OS interface.  It is functionally equivalent to sendmmsg()
+ *   except that:
+ *
+ *   - It is not a cancellation point,
+ *   - It does not modify the errno variable, and
+ *   - It accepts the internal socket structure as an input rather than an
+ *     task-specific socket descriptor.
+ *
+ *   The messages are passed in one go to the si_sendmmsg() method of the
+ *   address family if it provides one, and sent one by one with
+ *   si_sendmsg() otherwise.
+ *
+ * Input Parameters:
+ *   psock     A pointer to a NuttX-specific, internal socket structure
+ *   msgvec    The messages to send
+ *   vlen      The number of messages
+ *   flags     Send flags
+ *
+ * Returned Value:
+ *   On success, returns the number of messages sent.  Otherwise, if the
+ *   first message cannot be sent, a negated errno value is returned (see
+ *   comments with sendmsg() for a list of appropriate errno values).
+ *
+ ****************************************************************************/
+
+int psock_sendmmsg(FAR struct socket *psock, FAR struct mmsghdr *msgvec,
+                   unsigned int vlen, int flags)
+{
+  FAR const struct sock_intf_s *sockif;
+  FAR struct msghdr *msg;
+  unsigned int n;
+  ssize_t nbytes;
+
+  /* Verify that the sockfd corresponds to valid, allocated socket */
+
+  if (psock == NULL || psock->s_conn == NULL)
+    {
+      return -EBADF;
+    }
+
+  if (msgvec == NULL)
+    {
+      return -EINVAL;
+    }
+
+  /* Send at most up to the first malformed message */
+
+  for (n = 0; n < vlen; n++)
+    {
+      msg = &msgvec[n].msg_hdr;
+      if (msg->msg_iov == NULL || msg->msg_iov->iov_base == NULL)
+        {
+          if (n == 0)
+            {
+              return -EINVAL;
+            }
+
+          vlen = n;
+          break;
+        }
+    }
+
+  sockif = psock->s_sockif;
+  DEBUGASSERT(sockif != NULL && sockif->si_sendmsg != NULL);
+
+  if (sockif->si_sendmmsg != NULL)
+    {
+      return vlen > 0 ? sockif->si_sendmmsg(psock, msgvec, vlen, flags) : 0;
+    }
+
+  for (n = 0; n < vlen; n++)
+    {
+      nbytes = sockif->si_sendmsg(psock, &msgvec[n].msg_hdr, flags);
+      if (nbytes < 0)
+        {
+          /* An error is only reported if nothing was sent */
+
+          return n > 0 ? n : nbytes;
+        }
+
+      msgvec[n].msg_len = nbytes;
+    }
+
+  return n;
+}
+
+/****************************************************************************
+ * Function: sendmmsg
+ *
+ * Description:
+ *   sendmmsg() sends several messages to a socket with a single call.  Each
+ *   message is sent as by sendmsg() and the msg_len field of its mmsghdr
+ *   is set to the number of bytes sent.
+ *
+ * Parameters:
+ *   sockfd   Socket descriptor of socket
+ *   msgvec   The messages to send
+ *   vlen     The number of messages
+ *   flags    Send flags
+ *
+ * Returned Value:
+ *   On success, returns the number of messages sent, which may be less
+ *   than vlen.  On error, -1 is returned, and errno is set appropriately
+ *   (see sendmsg()).  An error occurring after at least one message was
+ *   sent is not reported.
+ *
+ ****************************************************************************/
+
+int sendmmsg(int sockfd, FAR struct mmsghdr *msgvec, unsigned int vlen,
+             int flags)
+{
+  FAR struct socket *psock;
+  FAR struct file *filep;
+  int ret;
+
+  /* sendmmsg() is a cancellation point */
+
+  enter_cancellation_point();
+
+  /* Get the underlying socket structure */
+
+  ret = sockfd_socket(sockfd, &filep, &psock);
+
+  /* Let psock_sendmmsg() do all of the work */
+
+  if (ret == OK)
+    {
+      ret = psock_sendmmsg(psock, msgvec, vlen, flags);
+      fs_putfilep(filep);
+    }
+
+  if (ret < 0)
+    {
+      set_errno(-ret);
+      ret = ERROR;
+    }
+
+  leave_cancellation_point();
+  return ret;
+}
+
+#endif /* CONFIG_NET */
@@ -109,6 +109,7 @@
 #define TCP_WSCALE            0x01U /* Window Scale option enabled */
 #define TCP_SACK              0x02U /* Selective ACKs enabled */
 #define TCP_CLOSE_ARRANGED    0x04U /* Connection is arranged to be freed */
+#define TCP_TSTAMP            0x20U /* Timestamps option enabled */
 
 #ifdef CONFIG_NET_TCP_CC_NEWRENO
 /* The TCP flags for congestion control */
@@ -118,6 +119,22 @@
 
 #endif
 
+/* Space taken by the Timestamps option in every segment, padded with two
+ * NOPs to keep the timestamps word-aligned (RFC 7323, Appendix A).
+ */
+
+#define TCP_TSOPT_SPACE       12
+
+/* The clock of the timestamps sent in the Timestamps option (units: ms) */
+
+#define TCP_TSCLOCK()         ((uint32_t)TICK2MSEC(clock_systime_ticks()))
+
+/* The time after which the last timestamp received is too old to reject
+ * segments with PAWS: 24 days (units: ms)
+ */
+
+#define TCP_PAWS_IDLE         (24U * 24 * 60 * 60 * MSEC_PER_SEC)
+
 /* The Max Range count of TCP Selective ACKs */
 
 #define TCP_SACK_RANGES_MAX   4
@@ -180,6 +197,45 @@ struct tcp_sack_s
   uint32_t right;   /* Right edge of the SACK */
 };
 
+#ifdef CONFIG_NET_TCP_CC_NEWRENO
+/* The operations of a congestion control algorithm.  Slow start, fast
+ * retransmit and fast recovery are common to all the algorithms, which
+ * only decide how the window grows in congestion avoidance and how much it
+ * shrinks on a loss.
+ *
+ *   name       - The name used with the TCP_CONGESTION socket option
+ *   init       - Optional, reset the private state of the algorithm.  This
+ *                is called when the algorithm is selected and when the
+ *                connection starts.
+ *   ssthresh   - Return the slow start threshold after a loss, detected
+ *                either by duplicate ACKs or by the retransmission timer
+ *   cong_avoid - Grow cwnd in congestion avoidance, 'acked' being the
+ *                number of bytes newly acknowledged
+ */
+
+struct tcp_cc_ops_s
+{
+  FAR const char *name;
+  CODE void (*init)(FAR struct tcp_conn_s *conn);
+  CODE uint32_t (*ssthresh)(FAR struct tcp_conn_s *conn);
+  CODE void (*cong_avoid)(FAR struct tcp_conn_s *conn, uint32_t acked);
+};
+#endif
+
+#ifdef CONFIG_NET_TCP_CC_CUBIC
+/* The state of the CUBIC congestion control algorithm */
+
+struct tcp_cubic_s
+{
+  uint32_t wmax;          /* Window before the last reduction (bytes) */
+  uint32_t origin;        /* Window at the plateau of the curve (bytes) */
+  uint32_t west;          /* Window of an equivalent Reno flow (bytes) */
+  uint32_t epoch;         /* Start of the congestion avoidance (units: ms) */
+  uint32_t k;             /* Time from the epoch to the plateau (units: ms) */
+  bool     inepoch;       /* The congestion avoidance epoch is started */
+};
+#endif
+
 struct tcp_conn_s
 {
   /* Common prologue of all connection structures. */
@@ -248,6 +304,12 @@ struct tcp_conn_s
                            * connection */
 #endif
   uint32_t rcv_adv;       /* The right edge of the recv window advertized */
+#ifdef CONFIG_NET_TCP_TIMESTAMPS
+  uint32_t ts_recent;     /* The last TSval received from the peer */
+  uint32_t ts_stamp;      /* Local time ts_recent was updated (units: ms) */
+  uint32_t srtt;          /* Smoothed RTT (units: ms, scaled by 8) */
+  uint32_t rttvar;        /* RTT variation (units: ms, scaled by 4) */
+#endif
 #ifdef CONFIG_NET_TCP_CC_NEWRENO
   uint32_t last_ackno;    /* The ack number at the last receive ack */
   uint32_t dupacks;       /* The number of duplicate ack */
@@ -256,6 +318,11 @@ struct tcp_conn_s
   uint32_t cwnd;          /* The Congestion window */
   uint32_t max_cwnd;      /* The Congestion window maximum value */
   uint32_t ssthresh;      /* The Slow start threshold */
+
+  FAR const struct tcp_cc_ops_s *cc_ops; /* Congestion control algorithm */
+#ifdef CONFIG_NET_TCP_CC_CUBIC
+  struct tcp_cubic_s cubic; /* The state of CUBIC */
+#endif
 #endif
 #ifdef CONFIG_NET_TCP_WINDOW_SCALE
   uint32_t snd_wnd;       /* Sequence and acknowledgement numbers of last
@@ -288,6 +355,11 @@ struct tcp_conn_s
 #ifdef CONFIG_NETDEV_RSS
   int      rcvcpu;        /* Currect cpu id */
 #endif
+#ifdef CONFIG_NET_TCP_CONN_HASH
+  dq_entry_t hashnode;    /* Link in the active connection hash table */
+  dq_entry_t lsnnode;     /* Link in the listening connection hash table */
+#endif
+
   /* If the TCP socket is bound to a local address, then this is
    * a reference to the device that routes traffic on the corresponding
    * network.
@@ -452,6 +524,12 @@ extern "C"
 {
 #endif
 
+#ifdef CONFIG_NET_TCP_CC_CUBIC
+/* The CUBIC congestion control algorithm */
+
+extern const struct tcp_cc_ops_s g_tcp_cc_cubic;
+#endif
+
 /****************************************************************************
  * Public Function Prototypes
  ****************************************************************************/
@@ -2307,6 +2385,46 @@ void tcp_cc_update(FAR struct tcp_conn_s *conn, FAR struct tcp_hdr_s *tcp);
  ****************************************************************************/
 
 void tcp_cc_recv_ack(FAR struct tcp_conn_s *conn, FAR struct tcp_hdr_s *tcp);
+
+/****************************************************************************
+ * Name: tcp_cc_timeout
+ *
+ * Description:
+ *   Update the congestion control variables when the retransmission timer
+ *   expires: the connection goes back to slow start.
+ *
+ * Input Parameters:
+ *   conn   - The TCP connection of interest
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+void tcp_cc_timeout(FAR struct tcp_conn_s *conn);
+
+/****************************************************************************
+ * Name: tcp_cc_select
+ *
+ * Description:
+ *   Select the congestion control algorithm of a connection.
+ *
+ * Input Parameters:
+ *   conn   - The TCP connection of interest
+ *   name   - The name of the algorithm, NULL for the default one
+ *
+ * Returned Value:
+ *   OK on success, -ENOENT if there is no algorithm with that name.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+int tcp_cc_select(FAR struct tcp_conn_s *conn, FAR const char *name);
 #endif
 
 #ifdef __cplusplus
@@ -24,6 +24,11 @@
  * Included Files
  ****************************************************************************/
 
+#include <nuttx/config.h>
+
+#include <sys/param.h>
+#include <string.h>
+#include <errno.h>
 #include <debug.h>
 
 #include "tcp/tcp.h"
@@ -74,10 +79,78 @@
     } \
  } while(0)
 
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static uint32_t tcp_newreno_ssthresh(FAR struct tcp_conn_s *conn);
+static void tcp_newreno_cong_avoid(FAR struct tcp_conn_s *conn,
+                                   uint32_t acked);
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static const struct tcp_cc_ops_s g_tcp_cc_newreno =
+{
+  "newreno",                 /* name */
+  NULL,                      /* init */
+  tcp_newreno_ssthresh,      /* ssthresh */
+  tcp_newreno_cong_avoid     /* cong_avoid */
+};
+
+/* The congestion control algorithms available, the default one first */
+
+static FAR const struct tcp_cc_ops_s * const g_tcp_cc_algs[] =
+{
+#ifdef CONFIG_NET_TCP_CC_DEFAULT_CUBIC
+  &g_tcp_cc_cubic,
+  &g_tcp_cc_newreno,
+#else
+  &g_tcp_cc_newreno,
+#  ifdef CONFIG_NET_TCP_CC_CUBIC
+  &g_tcp_cc_cubic,
+#  endif
+#endif
+};
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: tcp_newreno_ssthresh
+ *
+ * Description:
+ *   ssthresh = max (FlightSize / 2, 2*SMSS) referring to rfc5681
+ *
+ ****************************************************************************/
+
+static uint32_t tcp_newreno_ssthresh(FAR struct tcp_conn_s *conn)
+{
+  return MAX(conn->tx_unacked / 2, 2 * conn->mss);
+}
+
+/****************************************************************************
+ * Name: tcp_newreno_cong_avoid
+ *
+ * Description:
+ *   cong avoid (RFC 5681):
+ *   Grow cwnd linearly by approximately maxseg per RTT using
+ *   maxseg^2 / cwnd per ACK as the increment.
+ *   If cwnd > maxseg^2, fix the cwnd increment at 1 byte to
+ *   avoid capping cwnd.
+ *
+ ****************************************************************************/
+
+static void tcp_newreno_cong_avoid(FAR struct tcp_conn_s *conn,
+                                   uint32_t acked)
+{
+  uint32_t increase = MAX((conn->mss * conn->mss / conn->cwnd), 1);
+
+  CC_CWND_INC(conn->cwnd, increase);
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -103,6 +176,13 @@
 
 void tcp_cc_init(FAR struct tcp_conn_s *conn)
 {
+  DEBUGASSERT(conn->cc_ops != NULL);
+
+  if (conn->cc_ops->init != NULL)
+    {
+      conn->cc_ops->init(conn);
+    }
+
   CC_INIT_CWND(conn->cwnd, conn->mss);
 
   /* RFC 5681 recommends setting ssthresh arbitrarily high and
@@ -140,15 +220,14 @@ void tcp_cc_init(FAR struct tcp_conn_s *conn)
 
 void tcp_cc_update(FAR struct tcp_conn_s *conn, FAR struct tcp_hdr_s *tcp)
 {
-  /* After Fast retransmitted, set ssthresh to the maximum of
-   * the unacked and the 2*SMSS, and enter to Fast Recovery.
-   * ssthresh = max (FlightSize / 2, 2*SMSS) referring to rfc5681
+  /* After Fast retransmitted, reduce ssthresh as the algorithm decides,
+   * and enter to Fast Recovery.
    * cwnd=ssthresh + 3*SMSS  referring to rfc5681
    */
 
   if (conn->flags & TCP_INFT)
     {
-      conn->ssthresh = MAX(conn->tx_unacked / 2, 2 * conn->mss);
+      conn->ssthresh = conn->cc_ops->ssthresh(conn);
       conn->cwnd = conn->ssthresh + 3 * conn->mss;
 
       conn->flags &= ~TCP_INFT;
@@ -284,19 +363,107 @@ void tcp_cc_recv_ack(FAR struct tcp_conn_s *conn, FAR struct tcp_hdr_s *tcp)
             }
           else
             {
-              /* cong avoid (RFC 5681):
-               * Grow cwnd linearly by approximately maxseg per RTT using
-               * maxseg^2 / cwnd per ACK as the increment.
-               * If cwnd > maxseg^2, fix the cwnd increment at 1 byte to
-               * avoid capping cwnd.
-               */
-
-              increase = MAX((conn->mss * conn->mss / conn->cwnd), 1);
+              /* cong avoid: the algorithm decides the growth rate */
 
-              CC_CWND_INC(conn->cwnd, increase);
+              conn->cc_ops->cong_avoid(conn, acked);
               conn->cwnd = MIN(conn->cwnd, conn->max_cwnd);
               ninfo("update congestion avoidance cwnd to %u\n", conn->cwnd);
             }
         }
     }
 }
+
+/****************************************************************************
+ * Name: tcp_cc_timeout
+ *
+ * Description:
+ *   Update the congestion control variables when the retransmission timer
+ *   expires: the connection goes back to slow start.
+ *
+ * Input Parameters:
+ *   conn   - The TCP connection of interest
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+void tcp_cc_timeout(FAR struct tcp_conn_s *conn)
+{
+  /* If conn is TCP_INFR, it should enter to slow start */
+
+  if (conn->flags & TCP_INFR)
+    {
+      conn->flags &= ~TCP_INFR;
+    }
+
+  /* update the max_cwnd */
+
+  conn->max_cwnd = (conn->max_cwnd + 7 * conn->cwnd) >> 3;
+
+  /* reset cwnd and ssthresh, refers to RFC5861. */
+
+  conn->ssthresh = conn->cc_ops->ssthresh(conn);
+  conn->cwnd = conn->mss;
+}
+
+/****************************************************************************
+ * Name: tcp_cc_select
+ *
+ * Description:
+ *   Select the congestion control algorithm of a connection.
+ *
+ * Input Parameters:
+ *   conn   - The TCP connection of interest
+ *   name   - The name of the algorithm, NULL for the default one
+ *
+ * Returned Value:
+ *   OK on success, -ENOENT if there is no algorithm with that name.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+int tcp_cc_select(FAR struct tcp_conn_s *conn, FAR const char *name)
+{
+  FAR const struct tcp_cc_ops_s *ops = NULL;
+  int i;
+
+  if (name == NULL)
+    {
+      ops = g_tcp_cc_algs[0];
+    }
+  else
+    {
+      for (i = 0; i < nitems(g_tcp_cc_algs); i++)
+        {
+          if (strcmp(g_tcp_cc_algs[i]->name, name) == 0)
+            {
+              ops = g_tcp_cc_algs[i];
+              break;
+            }
+        }
+
+      if (ops == NULL)
+        {
+          return -ENOENT;
+        }
+    }
+
+  /* The window of a connection switching to another algorithm is kept */
+
+  if (ops != conn->cc_ops)
+    {
+      conn->cc_ops = ops;
+      if (ops->init != NULL)
+        {
+          ops->init(conn);
+        }
+    }
+
+  return OK;
+}
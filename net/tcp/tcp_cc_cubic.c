@@ -0,0 +1,255 @@
+/****************************************************************************
+ * net/tcp/tcp_cc_cubic.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/param.h>
+#include <inttypes.h>
+#include <stdint.h>
+#include <string.h>
+#include <debug.h>
+
+#include "tcp/tcp.h"
+
+#ifdef CONFIG_NET_TCP_CC_CUBIC
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The constants of RFC 9438: C = 0.4 segment/s^3 and beta = 0.7.  The
+ * window grows along W(t) = C * (t - K)^3 + Wmax, with t in seconds.
+ */
+
+#define CUBIC_BETA_NUM     7
+#define CUBIC_BETA_DEN     10
+
+/* C * t^3 in milli-segments for t in milliseconds: 0.4 * 10^3 / 10^9 */
+
+#define CUBIC_C_DIV        2500000ll
+
+/* K^3 in ms^3 for a reduction of one segment: 10^9 / 0.4 */
+
+#define CUBIC_K_MUL        2500000000ull
+
+/* Bound t - K so that its cube fits in 64 bits: about 17 minutes */
+
+#define CUBIC_T_MAX        1000000ll
+
+/* The additive increase of the Reno-friendly estimate, 3 * (1 - beta) /
+ * (1 + beta) = 9 / 17 segment per RTT.
+ */
+
+#define CUBIC_ALPHA_NUM    9
+#define CUBIC_ALPHA_DEN    17
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static void tcp_cubic_init(FAR struct tcp_conn_s *conn);
+static uint32_t tcp_cubic_ssthresh(FAR struct tcp_conn_s *conn);
+static void tcp_cubic_cong_avoid(FAR struct tcp_conn_s *conn,
+                                 uint32_t acked);
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+const struct tcp_cc_ops_s g_tcp_cc_cubic =
+{
+  "cubic",                   /* name */
+  tcp_cubic_init,            /* init */
+  tcp_cubic_ssthresh,        /* ssthresh */
+  tcp_cubic_cong_avoid       /* cong_avoid */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: tcp_cubic_cbrt
+ *
+ * Description:
+ *   Integer cube root, rounded down (Hacker's Delight, icbrt64).
+ *
+ ****************************************************************************/
+
+static uint32_t tcp_cubic_cbrt(uint64_t x)
+{
+  uint64_t y = 0;
+  uint64_t b;
+  int s;
+
+  for (s = 63; s >= 0; s -= 3)
+    {
+      y <<= 1;
+      b = 3 * y * (y + 1) + 1;
+      if ((x >> s) >= b)
+        {
+          x -= b << s;
+          y++;
+        }
+    }
+
+  return (uint32_t)y;
+}
+
+/****************************************************************************
+ * Name: tcp_cubic_rtt
+ *
+ * Description:
+ *   Return the smoothed RTT of the connection in milliseconds, or zero if
+ *   it is not measured.
+ *
+ ****************************************************************************/
+
+static uint32_t tcp_cubic_rtt(FAR struct tcp_conn_s *conn)
+{
+#ifdef CONFIG_NET_TCP_TIMESTAMPS
+  return conn->srtt >> 3;
+#else
+  return 0;
+#endif
+}
+
+/****************************************************************************
+ * Name: tcp_cubic_init
+ ****************************************************************************/
+
+static void tcp_cubic_init(FAR struct tcp_conn_s *conn)
+{
+  memset(&conn->cubic, 0, sizeof(conn->cubic));
+}
+
+/****************************************************************************
+ * Name: tcp_cubic_ssthresh
+ *
+ * Description:
+ *   Remember the window at the time of the loss as the plateau of the next
+ *   epoch and reduce the window by beta.  With fast convergence, a flow
+ *   losing before it reached its previous plateau releases bandwidth to the
+ *   newer flows by lowering the plateau further.
+ *
+ ****************************************************************************/
+
+static uint32_t tcp_cubic_ssthresh(FAR struct tcp_conn_s *conn)
+{
+  FAR struct tcp_cubic_s *cubic = &conn->cubic;
+  uint32_t cwnd = conn->cwnd;
+
+  if (cwnd < cubic->wmax)
+    {
+      cubic->wmax = (uint64_t)cwnd * (CUBIC_BETA_DEN + CUBIC_BETA_NUM) /
+                    (2 * CUBIC_BETA_DEN);
+    }
+  else
+    {
+      cubic->wmax = cwnd;
+    }
+
+  cubic->inepoch = false;
+
+  return MAX((uint64_t)cwnd * CUBIC_BETA_NUM / CUBIC_BETA_DEN,
+             2 * conn->mss);
+}
+
+/****************************************************************************
+ * Name: tcp_cubic_cong_avoid
+ *
+ * Description:
+ *   Grow the window towards the value of the cubic function one RTT ahead,
+ *   or towards the window of an equivalent Reno flow if that is larger.
+ *
+ ****************************************************************************/
+
+static void tcp_cubic_cong_avoid(FAR struct tcp_conn_s *conn,
+                                 uint32_t acked)
+{
+  FAR struct tcp_cubic_s *cubic = &conn->cubic;
+  uint32_t now = TCP_TSCLOCK();
+  uint32_t mss = conn->mss;
+  uint32_t cwnd = conn->cwnd;
+  int64_t target;
+  int64_t t;
+
+  if (!cubic->inepoch)
+    {
+      /* Start a new epoch from the current window */
+
+      cubic->inepoch = true;
+      cubic->epoch   = now;
+      cubic->west    = cwnd;
+
+      if (cwnd < cubic->wmax)
+        {
+          cubic->k      = tcp_cubic_cbrt((uint64_t)(cubic->wmax - cwnd) *
+                                         CUBIC_K_MUL / mss);
+          cubic->origin = cubic->wmax;
+        }
+      else
+        {
+          cubic->k      = 0;
+          cubic->origin = cwnd;
+        }
+    }
+
+  /* W(t + RTT), in bytes */
+
+  t = (int64_t)(uint32_t)(now - cubic->epoch) + tcp_cubic_rtt(conn) -
+      cubic->k;
+  t = MIN(MAX(t, -CUBIC_T_MAX), CUBIC_T_MAX);
+
+  target = cubic->origin + t * t * t / CUBIC_C_DIV * mss / 1000;
+
+  /* Never more than 1.5 times the window per RTT (RFC 9438, 4.4) */
+
+  target = MIN(MAX(target, (int64_t)mss), (int64_t)cwnd + cwnd / 2);
+
+  /* The Reno-friendly region (RFC 9438, 4.3) */
+
+  cubic->west += (uint64_t)acked * mss * CUBIC_ALPHA_NUM /
+                 ((uint64_t)cwnd * CUBIC_ALPHA_DEN);
+  if (cubic->west > target)
+    {
+      target = cubic->west;
+    }
+
+  /* Spread the increase over the ACKs of one window */
+
+  if (target > cwnd)
+    {
+      uint32_t increase = (uint64_t)(target - cwnd) * acked / cwnd;
+
+      conn->cwnd += MAX(increase, 1);
+    }
+
+  ninfo("cubic: cwnd=%" PRIu32 " wmax=%" PRIu32 " target=%" PRId64 "\n",
+        conn->cwnd, cubic->wmax, target);
+}
+
+#endif /* CONFIG_NET_TCP_CC_CUBIC */
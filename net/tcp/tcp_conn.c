@@ -58,6 +58,7 @@
 
 #include <nuttx/clock.h>
 #include <nuttx/kmalloc.h>
+#include <nuttx/nuttx.h>
 #include <nuttx/net/netconfig.h>
 #include <nuttx/net/net.h>
 #include <nuttx/net/netdev.h>
@@ -73,6 +74,24 @@
 #include "netdev/netdev.h"
 #include "utils/utils.h"
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_CONN_HASH
+#  if (CONFIG_NET_TCP_CONN_HASHSIZE & (CONFIG_NET_TCP_CONN_HASHSIZE - 1)) != 0
+#    error CONFIG_NET_TCP_CONN_HASHSIZE must be a power of two
+#  endif
+
+/* Walk one hash chain of the active connections */
+
+#  define TCP_ACTIVE_ENTRY(e) \
+     ((e) != NULL ? container_of(e, struct tcp_conn_s, hashnode) : NULL)
+#  define TCP_ACTIVE_NEXT(c)  TCP_ACTIVE_ENTRY((c)->hashnode.flink)
+#else
+#  define TCP_ACTIVE_NEXT(c)  ((FAR struct tcp_conn_s *)(c)->sconn.node.flink)
+#endif
+
 /****************************************************************************
  * Private Data
  ****************************************************************************/
@@ -91,10 +110,126 @@ static dq_queue_t g_free_tcp_connections;
 
 static dq_queue_t g_active_tcp_connections;
 
+#ifdef CONFIG_NET_TCP_CONN_HASH
+/* The active TCP connections indexed by remote address and port pair.  The
+ * local address is not part of the key because an active connection may
+ * still be bound to INADDR_ANY.
+ */
+
+static dq_queue_t g_tcp_conn_hash[CONFIG_NET_TCP_CONN_HASHSIZE];
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: tcp_hashkey
+ *
+ * Description:
+ *   Return the index of the hash bucket for the given remote address and
+ *   port pair.  The ports are in network byte order; raddr is the remote
+ *   IP address folded to 32 bits.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_CONN_HASH
+static inline unsigned int tcp_hashkey(uint32_t raddr, uint16_t lport,
+                                       uint16_t rport)
+{
+  uint32_t hash = raddr ^ ((uint32_t)lport << 16 | rport);
+
+  /* Mix the upper bits into the bits that select the bucket */
+
+  hash ^= hash >> 16;
+  hash *= 0x45d9f3b;
+  hash ^= hash >> 16;
+
+  return hash & (CONFIG_NET_TCP_CONN_HASHSIZE - 1);
+}
+
+#ifdef CONFIG_NET_IPv6
+static inline uint32_t tcp_ipv6_hashaddr(FAR const uint16_t *addr)
+{
+  return ((uint32_t)(addr[0] ^ addr[2] ^ addr[4] ^ addr[6]) << 16) |
+         (addr[1] ^ addr[3] ^ addr[5] ^ addr[7]);
+}
+#endif
+
+/****************************************************************************
+ * Name: tcp_hashbucket
+ *
+ * Description:
+ *   Return the hash chain that holds (or will hold) an active connection.
+ *
+ ****************************************************************************/
+
+static FAR dq_queue_t *tcp_hashbucket(FAR struct tcp_conn_s *conn)
+{
+  unsigned int key;
+
+#ifdef CONFIG_NET_IPv4
+#ifdef CONFIG_NET_IPv6
+  if (conn->domain == PF_INET)
+#endif
+    {
+      key = tcp_hashkey(conn->u.ipv4.raddr, conn->lport, conn->rport);
+    }
+#endif /* CONFIG_NET_IPv4 */
+
+#ifdef CONFIG_NET_IPv6
+#ifdef CONFIG_NET_IPv4
+  else
+#endif
+    {
+      key = tcp_hashkey(tcp_ipv6_hashaddr(conn->u.ipv6.raddr),
+                        conn->lport, conn->rport);
+    }
+#endif /* CONFIG_NET_IPv6 */
+
+  return &g_tcp_conn_hash[key];
+}
+#endif /* CONFIG_NET_TCP_CONN_HASH */
+
+/****************************************************************************
+ * Name: tcp_addactive
+ *
+ * Description:
+ *   Put a connection with a complete address binding into the list of
+ *   active connections.
+ *
+ * Assumptions:
+ *   This function is called with the network locked.
+ *
+ ****************************************************************************/
+
+static void tcp_addactive(FAR struct tcp_conn_s *conn)
+{
+  dq_addlast(&conn->sconn.node, &g_active_tcp_connections);
+#ifdef CONFIG_NET_TCP_CONN_HASH
+  dq_addlast(&conn->hashnode, tcp_hashbucket(conn));
+#endif
+}
+
+/****************************************************************************
+ * Name: tcp_remactive
+ *
+ * Description:
+ *   Remove a connection from the list of active connections.
+ *
+ * Assumptions:
+ *   This function is called with the network locked.
+ *
+ ****************************************************************************/
+
+static void tcp_remactive(FAR struct tcp_conn_s *conn)
+{
+  dq_rem(&conn->sconn.node, &g_active_tcp_connections);
+#ifdef CONFIG_NET_TCP_CONN_HASH
+  dq_rem(&conn->hashnode, tcp_hashbucket(conn));
+#endif
+}
+
 /****************************************************************************
  * Name: tcp_listener
  *
@@ -189,9 +324,14 @@ static inline FAR struct tcp_conn_s *
   in_addr_t srcipaddr;
   in_addr_t destipaddr;
 
-  conn       = (FAR struct tcp_conn_s *)g_active_tcp_connections.head;
   srcipaddr  = net_ip4addr_conv32(ip->srcipaddr);
   destipaddr = net_ip4addr_conv32(ip->destipaddr);
+#ifdef CONFIG_NET_TCP_CONN_HASH
+  conn       = TCP_ACTIVE_ENTRY(dq_peek(&g_tcp_conn_hash[
+                 tcp_hashkey(srcipaddr, tcp->destport, tcp->srcport)]));
+#else
+  conn       = (FAR struct tcp_conn_s *)g_active_tcp_connections.head;
+#endif
 
   while (conn)
     {
@@ -228,7 +368,7 @@ static inline FAR struct tcp_conn_s *
 
       /* Look at the next active connection */
 
-      conn = (FAR struct tcp_conn_s *)conn->sconn.node.flink;
+      conn = TCP_ACTIVE_NEXT(conn);
     }
 
   return conn;
@@ -256,9 +396,15 @@ static inline FAR struct tcp_conn_s *
   net_ipv6addr_t *srcipaddr;
   net_ipv6addr_t *destipaddr;
 
-  conn       = (FAR struct tcp_conn_s *)g_active_tcp_connections.head;
   srcipaddr  = (net_ipv6addr_t *)ip->srcipaddr;
   destipaddr = (net_ipv6addr_t *)ip->destipaddr;
+#ifdef CONFIG_NET_TCP_CONN_HASH
+  conn       = TCP_ACTIVE_ENTRY(dq_peek(&g_tcp_conn_hash[
+                 tcp_hashkey(tcp_ipv6_hashaddr(*srcipaddr),
+                             tcp->destport, tcp->srcport)]));
+#else
+  conn       = (FAR struct tcp_conn_s *)g_active_tcp_connections.head;
+#endif
 
   while (conn)
     {
@@ -295,7 +441,7 @@ static inline FAR struct tcp_conn_s *
 
       /* Look at the next active connection */
 
-      conn = (FAR struct tcp_conn_s *)conn->sconn.node.flink;
+      conn = TCP_ACTIVE_NEXT(conn);
     }
 
   return conn;
@@ -800,6 +946,9 @@ FAR struct tcp_conn_s *tcp_alloc(uint8_t domain)
 
       nxsem_init(&conn->snd_sem, 0, 0);
 #endif
+#ifdef CONFIG_NET_TCP_CC_NEWRENO
+      tcp_cc_select(conn, NULL);
+#endif
 
       /* Set the default value of mss to max, this field will changed when
        * receive SYN.
@@ -922,7 +1071,7 @@ void tcp_free(FAR struct tcp_conn_s *conn)
     {
       /* Remove the connection from the active list */
 
-      dq_rem(&conn->sconn.node, &g_active_tcp_connections);
+      tcp_remactive(conn);
     }
 
   tcp_free_rx_buffers(conn);
@@ -1179,6 +1328,9 @@ FAR struct tcp_conn_s *tcp_alloc_accept(FAR struct net_driver_s *dev,
 #endif
 #if CONFIG_NET_SEND_BUFSIZE > 0
       conn->snd_bufs         = listener->snd_bufs;
+#endif
+#ifdef CONFIG_NET_TCP_CC_NEWRENO
+      conn->cc_ops           = listener->cc_ops;
 #endif
       conn->mss              = listener->mss;
 
@@ -1231,7 +1383,7 @@ FAR struct tcp_conn_s *tcp_alloc_accept(FAR struct net_driver_s *dev,
        * Interrupts should already be disabled in this context.
        */
 
-      dq_addlast(&conn->sconn.node, &g_active_tcp_connections);
+      tcp_addactive(conn);
       tcp_update_retrantimer(conn, TCP_RTO);
     }
 
@@ -1542,7 +1694,7 @@ int tcp_connect(FAR struct tcp_conn_s *conn, FAR const struct sockaddr *addr)
 
   /* And, finally, put the connection structure into the active list. */
 
-  dq_addlast(&conn->sconn.node, &g_active_tcp_connections);
+  tcp_addactive(conn);
   ret = OK;
 
 errout_with_lock:
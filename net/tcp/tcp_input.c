@@ -48,6 +48,7 @@
 
 #if defined(CONFIG_NET) && defined(CONFIG_NET_TCP)
 
+#include <sys/param.h>
 #include <inttypes.h>
 #include <stdbool.h>
 #include <stdint.h>
@@ -55,6 +56,7 @@
 #include <assert.h>
 #include <debug.h>
 
+#include <nuttx/lib/math32.h>
 #include <nuttx/net/netconfig.h>
 #include <nuttx/net/netdev.h>
 #include <nuttx/net/netstats.h>
@@ -615,6 +617,15 @@ static void tcp_parse_option(FAR struct net_driver_s *dev,
         {
           conn->flags    |= TCP_SACK;
         }
+#endif
+#ifdef CONFIG_NET_TCP_TIMESTAMPS
+      else if (opt == TCP_OPT_TIMESTAMP &&
+               IPDATA(tcpiplen + 1 + i) == TCP_OPT_TIMESTAMP_LEN)
+        {
+          conn->ts_recent = tcp_getsequence(&IPDATA(tcpiplen + 2 + i));
+          conn->ts_stamp  = TCP_TSCLOCK();
+          conn->flags    |= TCP_TSTAMP;
+        }
 #endif
       else
         {
@@ -634,8 +645,151 @@ static void tcp_parse_option(FAR struct net_driver_s *dev,
 
       i += IPDATA(tcpiplen + 1 + i);
     }
+
+#ifdef CONFIG_NET_TCP_TIMESTAMPS
+  /* The Timestamps option takes room from the data of every segment */
+
+  if ((conn->flags & TCP_TSTAMP) != 0)
+    {
+      conn->mss -= TCP_TSOPT_SPACE;
+    }
+#endif
+}
+
+#ifdef CONFIG_NET_TCP_TIMESTAMPS
+/****************************************************************************
+ * Name: tcp_get_timestamp
+ *
+ * Description:
+ *   Find the Timestamps option in the header of the incoming segment.
+ *
+ * Input Parameters:
+ *   tcp   - Header of TCP structure
+ *   tsval - Location to return the timestamp of the peer
+ *   tsecr - Location to return the timestamp echoed by the peer
+ *
+ * Returned Value:
+ *   True if the segment carries the Timestamps option.
+ *
+ ****************************************************************************/
+
+static bool tcp_get_timestamp(FAR struct tcp_hdr_s *tcp,
+                              FAR uint32_t *tsval, FAR uint32_t *tsecr)
+{
+  FAR uint8_t *opt = tcp->optdata;
+  int optlen = ((tcp->tcpoffset >> 4) << 2) - TCP_HDRLEN;
+  int i;
+
+  /* Fast path for the layout recommended by RFC 7323, Appendix A, which
+   * is what all the segments of an established connection look like.
+   */
+
+  if (optlen >= TCP_TSOPT_SPACE &&
+      opt[0] == TCP_OPT_NOOP && opt[1] == TCP_OPT_NOOP &&
+      opt[2] == TCP_OPT_TIMESTAMP && opt[3] == TCP_OPT_TIMESTAMP_LEN)
+    {
+      *tsval = tcp_getsequence(&opt[4]);
+      *tsecr = tcp_getsequence(&opt[8]);
+      return true;
+    }
+
+  for (i = 0; i < optlen; )
+    {
+      if (opt[i] == TCP_OPT_END)
+        {
+          break;
+        }
+      else if (opt[i] == TCP_OPT_NOOP)
+        {
+          i++;
+          continue;
+        }
+      else if (i + 1 >= optlen || opt[i + 1] < 2)
+        {
+          /* The options are malformed */
+
+          break;
+        }
+      else if (opt[i] == TCP_OPT_TIMESTAMP &&
+               opt[i + 1] == TCP_OPT_TIMESTAMP_LEN &&
+               i + TCP_OPT_TIMESTAMP_LEN <= optlen)
+        {
+          *tsval = tcp_getsequence(&opt[i + 2]);
+          *tsecr = tcp_getsequence(&opt[i + 6]);
+          return true;
+        }
+
+      i += opt[i + 1];
+    }
+
+  return false;
 }
 
+/****************************************************************************
+ * Name: tcp_update_rttm
+ *
+ * Description:
+ *   Update the round-trip time estimators of the connection with a new
+ *   measurement and compute the retransmission time-out as specified by
+ *   RFC 6298.  The variables are kept in milliseconds, scaled like in the
+ *   original code of Van Jacobson; the result is rounded up to the
+ *   half-second granularity of the retransmission timer.
+ *
+ * Input Parameters:
+ *   conn - The TCP connection of interest
+ *   rtt  - The round-trip time measured (units: ms)
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+static void tcp_update_rttm(FAR struct tcp_conn_s *conn, uint32_t rtt)
+{
+  int32_t delta;
+  uint32_t rto;
+
+  /* Ignore the bogus echoes, no RTT can be longer than the maximum RTO */
+
+  if (rtt > TCP_RTO_MAX * MSEC_PER_HSEC)
+    {
+      return;
+    }
+
+  if (conn->srtt == 0)
+    {
+      /* First measurement: SRTT = R, RTTVAR = R / 2 */
+
+      conn->srtt   = rtt << 3;
+      conn->rttvar = rtt << 1;
+    }
+  else
+    {
+      /* RTTVAR = 3/4 RTTVAR + 1/4 |SRTT - R|, SRTT = 7/8 SRTT + 1/8 R */
+
+      delta = rtt - (conn->srtt >> 3);
+      conn->srtt += delta;
+      if (delta < 0)
+        {
+          delta = -delta;
+        }
+
+      delta -= conn->rttvar >> 2;
+      conn->rttvar += delta;
+    }
+
+  /* RTO = SRTT + max(G, 4 * RTTVAR), G being the timer granularity */
+
+  rto = (conn->srtt >> 3) + MAX(conn->rttvar, MSEC_PER_HSEC);
+  rto = div_round_up(rto, MSEC_PER_HSEC);
+
+  conn->rto = MIN(MAX(rto, TCP_RTO_MIN), TCP_RTO_MAX);
+}
+#endif
+
 /****************************************************************************
  * Name: tcp_clear_zero_probe
  *
@@ -695,11 +849,14 @@ static void tcp_input(FAR struct net_driver_s *dev, uint8_t domain,
   FAR struct tcp_conn_s *conn = NULL;
   FAR struct tcp_hdr_s *tcp;
   union ip_binding_u uaddr;
-  unsigned int tcpiplen;
   uint16_t tmp16;
   uint16_t flags;
   uint16_t result;
   int      len;
+#ifdef CONFIG_NET_TCP_TIMESTAMPS
+  uint32_t tsval;
+  uint32_t tsecr = 0;
+#endif
 
 #ifdef CONFIG_NET_STATISTICS
   /* Bump up the count of TCP packets received */
@@ -713,20 +870,10 @@ static void tcp_input(FAR struct net_driver_s *dev, uint8_t domain,
 
   tcp = IPBUF(iplen);
 
-  /* Get the size of the IP header and the TCP header.
-   *
-   * REVISIT:  TCP header is *not* a constant!  It can be larger if the
-   * TCP header includes options.  The constant TCP_HDRLEN should be
-   * replaced with the macro TCP_OPT_HDRLEN(n) which will calculate the
-   * correct header length in all cases.
-   */
-
-  tcpiplen = iplen + TCP_HDRLEN;
-
 #ifdef CONFIG_NET_TCP_CHECKSUMS
   /* Start of TCP input header processing code. */
 
-  if (tcp_chksum(dev) != 0xffff)
+  if (!NETDEV_CSUM_VALID(dev) && tcp_chksum(dev) != 0xffff)
     {
       /* Compute and check the TCP checksum. */
 
@@ -1022,6 +1169,51 @@ found:
     }
 #endif
 
+#ifdef CONFIG_NET_TCP_TIMESTAMPS
+  if ((conn->flags & TCP_TSTAMP) != 0 &&
+      tcp_get_timestamp(tcp, &tsval, &tsecr))
+    {
+      uint32_t now = TCP_TSCLOCK();
+
+      /* PAWS: a segment with a timestamp older than the last one received
+       * is an old duplicate, unless ts_recent went stale (RFC 7323,
+       * section 5.5).  It is acknowledged if it consumes sequence space,
+       * but not processed further.  RST segments are exempt from the
+       * check (RFC 7323, section 5.3 R1).
+       */
+
+      if ((tcp->flags & TCP_RST) == 0 &&
+          TCP_SEQ_LT(tsval, conn->ts_recent) &&
+          now - conn->ts_stamp < TCP_PAWS_IDLE)
+        {
+          ninfo("PAWS drop: tsval=%" PRIu32 " ts_recent=%" PRIu32 "\n",
+                tsval, conn->ts_recent);
+
+#ifdef CONFIG_NET_STATISTICS
+          g_netstats.tcp.drop++;
+#endif
+          if (dev->d_len > 0 || (tcp->flags & (TCP_SYN | TCP_FIN)) != 0)
+            {
+              tcp_send(dev, conn, TCP_ACK, tcpip_hdrsize(conn));
+              return;
+            }
+
+          goto drop;
+        }
+
+      /* Record the timestamp to echo, unless the segment starts beyond
+       * what we acknowledged (RFC 7323, section 4.3).
+       */
+
+      if (TCP_SEQ_LTE(tcp_getsequence(tcp->seqno),
+                      tcp_getsequence(conn->rcvseq)))
+        {
+          conn->ts_recent = tsval;
+          conn->ts_stamp  = now;
+        }
+    }
+#endif
+
   /* Check if the incoming segment acknowledges any outstanding data. If so,
    * we update the sequence number, reset the length of the outstanding
    * data, calculate RTT estimations, and reset the retransmission timer.
@@ -1031,6 +1223,9 @@ found:
     {
       uint32_t unackseq;
       uint32_t ackseq;
+#ifdef CONFIG_NET_TCP_TIMESTAMPS
+      uint32_t una;
+#endif
       int timeout;
 
       /* The next sequence number is equal to the current sequence
@@ -1059,6 +1254,12 @@ found:
 
       ackseq = tcp_getsequence(tcp->ackno);
 
+#ifdef CONFIG_NET_TCP_TIMESTAMPS
+      /* The left edge of the send window before this acknowledgment */
+
+      una = unackseq - conn->tx_unacked;
+#endif
+
       /* Check how many of the outstanding bytes have been acknowledged. For
        * most send operations, this should always be true.  However,
        * the send() API sends data ahead when it can without waiting for
@@ -1116,6 +1317,23 @@ found:
         }
 #endif
 
+#ifdef CONFIG_NET_TCP_TIMESTAMPS
+      /* Measure the RTT if the segment acknowledges new data (RFC 7323,
+       * section 4.2).  Unlike the estimation below, this is also valid
+       * after retransmissions as the echoed timestamp identifies the
+       * segment acknowledged.
+       */
+
+      if ((conn->flags & TCP_TSTAMP) != 0)
+        {
+          if (tsecr != 0 && TCP_SEQ_GT(ackseq, una))
+            {
+              tcp_update_rttm(conn, TCP_TSCLOCK() - tsecr);
+            }
+        }
+      else
+#endif
+
       /* Do RTT estimation, unless we have done retransmissions. */
 
       if (conn->nrtx == 0)
@@ -1189,7 +1407,7 @@ found:
                    * E.g. a keep-alive segment.
                    */
 
-                  tcp_send(dev, conn, TCP_ACK, tcpiplen);
+                  tcp_send(dev, conn, TCP_ACK, tcpip_hdrsize(conn));
                   return;
                 }
             }
@@ -1202,7 +1420,7 @@ found:
 #endif
               if ((conn->tcpstateflags & TCP_STATE_MASK) <= TCP_ESTABLISHED)
                 {
-                  tcp_send(dev, conn, TCP_ACK, tcpiplen);
+                  tcp_send(dev, conn, TCP_ACK, tcpip_hdrsize(conn));
                   return;
                 }
             }
@@ -1429,7 +1647,8 @@ found:
                 conn->sndseq_max    = tcp_getsequence(conn->sndseq) + 1;
 #endif
                 ninfo("TCP state: TCP_LAST_ACK\n");
-                tcp_send(dev, conn, TCP_FIN | TCP_ACK, tcpiplen);
+                tcp_send(dev, conn, TCP_FIN | TCP_ACK,
+                         tcpip_hdrsize(conn));
               }
             else
               {
@@ -1610,7 +1829,7 @@ found:
 
             net_incr32(conn->rcvseq, 1); /* ack FIN */
             tcp_callback(dev, conn, TCP_CLOSE);
-            tcp_send(dev, conn, TCP_ACK, tcpiplen);
+            tcp_send(dev, conn, TCP_ACK, tcpip_hdrsize(conn));
             return;
           }
         else if ((flags & TCP_ACKDATA) != 0 && conn->tx_unacked == 0)
@@ -1657,7 +1876,7 @@ found:
 
             net_incr32(conn->rcvseq, 1); /* ack FIN */
             tcp_callback(dev, conn, TCP_CLOSE);
-            tcp_send(dev, conn, TCP_ACK, tcpiplen);
+            tcp_send(dev, conn, TCP_ACK, tcpip_hdrsize(conn));
             return;
           }
 
@@ -1682,7 +1901,7 @@ found:
         goto drop;
 
       case TCP_TIME_WAIT:
-        tcp_send(dev, conn, TCP_ACK, tcpiplen);
+        tcp_send(dev, conn, TCP_ACK, tcpip_hdrsize(conn));
         return;
 
       case TCP_CLOSING:
@@ -52,18 +52,37 @@
 
 #include <nuttx/net/netconfig.h>
 #include <nuttx/net/net.h>
+#include <nuttx/nuttx.h>
 
 #include "devif/devif.h"
 #include "inet/inet.h"
 #include "tcp/tcp.h"
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_CONN_HASH
+#  define TCP_LISTEN_HASH(p) \
+     (NTOHS(p) & (CONFIG_NET_TCP_CONN_HASHSIZE - 1))
+#endif
+
 /****************************************************************************
  * Private Data
  ****************************************************************************/
 
+#ifdef CONFIG_NET_TCP_CONN_HASH
+/* The listening connections indexed by local port number, and the number
+ * of connections in the table.
+ */
+
+static dq_queue_t g_tcp_listen_hash[CONFIG_NET_TCP_CONN_HASHSIZE];
+static int g_tcp_nlisteners;
+#else
 /* The tcp_listenports list all currently listening ports. */
 
 static FAR struct tcp_conn_s *tcp_listenports[CONFIG_NET_MAX_LISTENPORTS];
+#endif
 
 /****************************************************************************
  * Private Functions
@@ -89,6 +108,20 @@ FAR struct tcp_conn_s *tcp_findlistener(FAR union ip_binding_u *uaddr,
                                         uint16_t portno)
 #endif
 {
+#ifdef CONFIG_NET_TCP_CONN_HASH
+  FAR dq_entry_t *entry;
+
+  /* Examine each connection structure that hashes to this port */
+
+  for (entry = dq_peek(&g_tcp_listen_hash[TCP_LISTEN_HASH(portno)]);
+       entry != NULL;
+       entry = dq_next(entry))
+    {
+      /* Does the connection have the same local port number? */
+
+      FAR struct tcp_conn_s *conn =
+        container_of(entry, struct tcp_conn_s, lsnnode);
+#else
   int ndx;
 
   /* Examine each connection structure in each slot of the listener list */
@@ -100,6 +133,7 @@ FAR struct tcp_conn_s *tcp_findlistener(FAR union ip_binding_u *uaddr,
        */
 
       FAR struct tcp_conn_s *conn = tcp_listenports[ndx];
+#endif
 #if defined(CONFIG_NET_IPv4) && defined(CONFIG_NET_IPv6)
       if (conn && conn->lport == portno && conn->domain == domain)
 #else
@@ -160,10 +194,28 @@ FAR struct tcp_conn_s *tcp_findlistener(FAR union ip_binding_u *uaddr,
 
 int tcp_unlisten(FAR struct tcp_conn_s *conn)
 {
+#ifdef CONFIG_NET_TCP_CONN_HASH
+  FAR dq_queue_t *bucket;
+  FAR dq_entry_t *entry;
+#else
   int ndx;
+#endif
   int ret = -EINVAL;
 
   net_lock();
+#ifdef CONFIG_NET_TCP_CONN_HASH
+  bucket = &g_tcp_listen_hash[TCP_LISTEN_HASH(conn->lport)];
+  for (entry = dq_peek(bucket); entry != NULL; entry = dq_next(entry))
+    {
+      if (entry == &conn->lsnnode)
+        {
+          dq_rem(entry, bucket);
+          g_tcp_nlisteners--;
+          ret = OK;
+          break;
+        }
+    }
+#else
   for (ndx = 0; ndx < CONFIG_NET_MAX_LISTENPORTS; ndx++)
     {
       if (tcp_listenports[ndx] == conn)
@@ -173,6 +225,7 @@ int tcp_unlisten(FAR struct tcp_conn_s *conn)
           break;
         }
     }
+#endif
 
   net_unlock();
   return ret;
@@ -191,7 +244,9 @@ int tcp_unlisten(FAR struct tcp_conn_s *conn)
 
 int tcp_listen(FAR struct tcp_conn_s *conn)
 {
+#ifndef CONFIG_NET_TCP_CONN_HASH
   int ndx;
+#endif
   int ret;
 
   /* This must be done with network locked because the listener table
@@ -220,6 +275,15 @@ int tcp_listen(FAR struct tcp_conn_s *conn)
 
       ret = -ENOBUFS; /* Assume failure */
 
+#ifdef CONFIG_NET_TCP_CONN_HASH
+      if (g_tcp_nlisteners < CONFIG_NET_MAX_LISTENPORTS)
+        {
+          dq_addlast(&conn->lsnnode,
+                     &g_tcp_listen_hash[TCP_LISTEN_HASH(conn->lport)]);
+          g_tcp_nlisteners++;
+          ret = OK;
+        }
+#else
       /* Search all slots until an available slot is found */
 
       for (ndx = 0; ndx < CONFIG_NET_MAX_LISTENPORTS; ndx++)
@@ -235,6 +299,7 @@ int tcp_listen(FAR struct tcp_conn_s *conn)
               break;
             }
         }
+#endif
     }
 
   net_unlock();
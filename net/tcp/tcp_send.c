@@ -47,6 +47,7 @@
 #include <nuttx/config.h>
 #if defined(CONFIG_NET) && defined(CONFIG_NET_TCP)
 
+#include <sys/param.h>
 #include <assert.h>
 #include <stdint.h>
 #include <string.h>
@@ -128,6 +129,10 @@ static void tcp_sendcommon(FAR struct net_driver_s *dev,
                            FAR struct tcp_conn_s *conn,
                            FAR struct tcp_hdr_s *tcp)
 {
+#ifdef CONFIG_NETDEV_OFFLOAD
+  uint16_t hdrlen;
+#endif
+
   /* Set TCP sequence numbers and port numbers */
 
   memcpy(tcp->ackno, conn->rcvseq, 4);
@@ -177,6 +182,16 @@ static void tcp_sendcommon(FAR struct net_driver_s *dev,
   tcp->urgp[0] = 0;
   tcp->urgp[1] = 0;
 
+#ifdef CONFIG_NETDEV_OFFLOAD
+  /* Segments larger than the MSS are only built for devices doing TCP
+   * segmentation offload.  Tell the device where to split them.
+   */
+
+  hdrlen = (FAR uint8_t *)tcp - (FAR uint8_t *)IPBUF(0) +
+           ((tcp->tcpoffset >> 4) << 2);
+  dev->d_iob->io_gsosize = dev->d_len - hdrlen > conn->mss ? conn->mss : 0;
+#endif
+
   /* Update device buffer length before setup the IP header */
 
   iob_update_pktlen(dev->d_iob, dev->d_len, false);
@@ -200,7 +215,10 @@ static void tcp_sendcommon(FAR struct net_driver_s *dev,
       tcp->tcpchksum = 0;
 
 #ifdef CONFIG_NET_TCP_CHECKSUMS
-      tcp->tcpchksum = ~tcp_ipv6_chksum(dev);
+      if (!net_chksum_partial(dev, &tcp->tcpchksum, IP_PROTO_TCP))
+        {
+          tcp->tcpchksum = ~tcp_ipv6_chksum(dev);
+        }
 #endif
 
 #ifdef CONFIG_NET_STATISTICS
@@ -224,7 +242,10 @@ static void tcp_sendcommon(FAR struct net_driver_s *dev,
       tcp->tcpchksum = 0;
 
 #ifdef CONFIG_NET_TCP_CHECKSUMS
-      tcp->tcpchksum = ~tcp_ipv4_chksum(dev);
+      if (!net_chksum_partial(dev, &tcp->tcpchksum, IP_PROTO_TCP))
+        {
+          tcp->tcpchksum = ~tcp_ipv4_chksum(dev);
+        }
 #endif
 
 #ifdef CONFIG_NET_STATISTICS
@@ -258,6 +279,29 @@ static void tcp_sendcommon(FAR struct net_driver_s *dev,
 #endif
 }
 
+#ifdef CONFIG_NET_TCP_TIMESTAMPS
+/****************************************************************************
+ * Name: tcp_put_timestamp
+ *
+ * Description:
+ *   Write the Timestamps option, preceded by two NOPs, at 'optdata'.  The
+ *   most recent timestamp received from the peer is echoed back.
+ *
+ ****************************************************************************/
+
+static void tcp_put_timestamp(FAR struct tcp_conn_s *conn,
+                              FAR uint8_t *optdata)
+{
+  optdata[0] = TCP_OPT_NOOP;
+  optdata[1] = TCP_OPT_NOOP;
+  optdata[2] = TCP_OPT_TIMESTAMP;
+  optdata[3] = TCP_OPT_TIMESTAMP_LEN;
+
+  tcp_setsequence(&optdata[4], TCP_TSCLOCK());
+  tcp_setsequence(&optdata[8], conn->ts_recent);
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -287,6 +331,7 @@ void tcp_send(FAR struct net_driver_s *dev, FAR struct tcp_conn_s *conn,
               uint16_t flags, uint16_t len)
 {
   FAR struct tcp_hdr_s *tcp;
+  int optlen = 0;
 
   if (dev->d_iob == NULL)
     {
@@ -297,39 +342,57 @@ void tcp_send(FAR struct net_driver_s *dev, FAR struct tcp_conn_s *conn,
   tcp->flags = flags;
   dev->d_len = len;
 
+#ifdef CONFIG_NET_TCP_TIMESTAMPS
+  /* The space of the Timestamps option is already included in 'len', see
+   * tcpip_hdrsize().
+   */
+
+  if ((conn->flags & TCP_TSTAMP) != 0)
+    {
+      tcp_put_timestamp(conn, tcp->optdata);
+      optlen = TCP_TSOPT_SPACE;
+    }
+#endif
+
 #ifdef CONFIG_NET_TCP_SELECTIVE_ACK
   if ((conn->flags & TCP_SACK) && (flags == TCP_ACK) && conn->nofosegs > 0)
     {
-      int optlen = conn->nofosegs * sizeof(struct tcp_sack_s);
+      FAR uint8_t *sackopt = &tcp->optdata[optlen];
+      int nsacks = conn->nofosegs;
+      int sacklen;
       int i;
 
-      tcp->optdata[0] = TCP_OPT_NOOP;
-      tcp->optdata[1] = TCP_OPT_NOOP;
-      tcp->optdata[2] = TCP_OPT_SACK;
-      tcp->optdata[3] = TCP_OPT_SACK_PERM_LEN + optlen;
+      /* Only as many blocks as fit beside the other options are sent */
+
+      nsacks = MIN(nsacks, (TCP_MAX_HDRLEN - TCP_HDRLEN - optlen - 4) /
+                           sizeof(struct tcp_sack_s));
+      sacklen = nsacks * sizeof(struct tcp_sack_s);
 
-      optlen += 4;
+      sackopt[0] = TCP_OPT_NOOP;
+      sackopt[1] = TCP_OPT_NOOP;
+      sackopt[2] = TCP_OPT_SACK;
+      sackopt[3] = TCP_OPT_SACK_PERM_LEN + sacklen;
 
-      for (i = 0; i < conn->nofosegs; i++)
+      sacklen += 4;
+
+      for (i = 0; i < nsacks; i++)
         {
           ninfo("TCP SACK [%d]"
                 "[%" PRIu32 " : %" PRIu32 " : %" PRIu32 "]\n", i,
                 conn->ofosegs[i].left, conn->ofosegs[i].right,
                 TCP_SEQ_SUB(conn->ofosegs[i].right, conn->ofosegs[i].left));
-          tcp_setsequence(&tcp->optdata[4 + i * 2 * sizeof(uint32_t)],
+          tcp_setsequence(&sackopt[4 + i * 2 * sizeof(uint32_t)],
                           conn->ofosegs[i].left);
-          tcp_setsequence(&tcp->optdata[4 + (i * 2 + 1) * sizeof(uint32_t)],
+          tcp_setsequence(&sackopt[4 + (i * 2 + 1) * sizeof(uint32_t)],
                           conn->ofosegs[i].right);
         }
 
-      dev->d_len += optlen;
-      tcp->tcpoffset = ((TCP_HDRLEN + optlen) / 4) << 4;
+      dev->d_len += sacklen;
+      optlen     += sacklen;
     }
-  else
 #endif /* CONFIG_NET_TCP_SELECTIVE_ACK */
-    {
-      tcp->tcpoffset = (TCP_HDRLEN / 4) << 4;
-    }
+
+  tcp->tcpoffset = ((TCP_HDRLEN + optlen) / 4) << 4;
 
   tcp_sendcommon(dev, conn, tcp);
 
@@ -503,7 +566,10 @@ void tcp_reset(FAR struct net_driver_s *dev, FAR struct tcp_conn_s *conn)
       tcp->tcpchksum = 0;
 
 #ifdef CONFIG_NET_TCP_CHECKSUMS
-      tcp->tcpchksum = ~tcp_ipv6_chksum(dev);
+      if (!net_chksum_partial(dev, &tcp->tcpchksum, IP_PROTO_TCP))
+        {
+          tcp->tcpchksum = ~tcp_ipv6_chksum(dev);
+        }
 #endif
     }
 #endif /* CONFIG_NET_IPv6 */
@@ -523,7 +589,10 @@ void tcp_reset(FAR struct net_driver_s *dev, FAR struct tcp_conn_s *conn)
       tcp->tcpchksum = 0;
 
 #ifdef CONFIG_NET_TCP_CHECKSUMS
-      tcp->tcpchksum = ~tcp_ipv4_chksum(dev);
+      if (!net_chksum_partial(dev, &tcp->tcpchksum, IP_PROTO_TCP))
+        {
+          tcp->tcpchksum = ~tcp_ipv4_chksum(dev);
+        }
 #endif
     }
 #endif /* CONFIG_NET_IPv4 */
@@ -611,6 +680,15 @@ void tcp_synack(FAR struct net_driver_s *dev, FAR struct tcp_conn_s *conn,
 
   dev->d_len = tcpip_hdrsize(conn);
 
+#ifdef CONFIG_NET_TCP_TIMESTAMPS
+  /* All the options, the Timestamps one included, are added below */
+
+  if ((conn->flags & TCP_TSTAMP) != 0)
+    {
+      dev->d_len -= TCP_TSOPT_SPACE;
+    }
+#endif
+
   /* Set the packet length for the TCP Maximum Segment Size */
 
 #ifdef CONFIG_NET_TCPPROTO_OPTIONS
@@ -657,6 +735,14 @@ void tcp_synack(FAR struct net_driver_s *dev, FAR struct tcp_conn_s *conn,
     }
 #endif
 
+#ifdef CONFIG_NET_TCP_TIMESTAMPS
+  if (tcp->flags == TCP_SYN || (conn->flags & TCP_TSTAMP) != 0)
+    {
+      tcp_put_timestamp(conn, &tcp->optdata[optlen]);
+      optlen += TCP_TSOPT_SPACE;
+    }
+#endif
+
   tcp->tcpoffset         = ((TCP_HDRLEN + optlen) / 4) << 4;
   dev->d_len            += optlen;
 
@@ -730,6 +816,15 @@ uint16_t tcpip_hdrsize(FAR struct tcp_conn_s *conn)
 {
   uint16_t hdrsize = sizeof(struct tcp_hdr_s);
 
+#ifdef CONFIG_NET_TCP_TIMESTAMPS
+  /* Every segment carries the Timestamps option once it is negotiated */
+
+  if ((conn->flags & TCP_TSTAMP) != 0)
+    {
+      hdrsize += TCP_TSOPT_SPACE;
+    }
+#endif
+
   UNUSED(conn);
   return net_ip_domain_select(conn->domain,
                               sizeof(struct ipv4_hdr_s) + hdrsize,
@@ -92,6 +92,43 @@
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: tcp_max_segsize
+ *
+ * Description:
+ *   Return the largest amount of new data that can be sent in one packet.
+ *   This is the MSS, or a multiple of it if the device segments the
+ *   packets itself.
+ *
+ ****************************************************************************/
+
+static uint32_t tcp_max_segsize(FAR struct net_driver_s *dev,
+                                FAR struct tcp_conn_s *conn)
+{
+#if defined(CONFIG_NETDEV_OFFLOAD) && defined(CONFIG_NET_TCP_CHECKSUMS)
+  uint8_t feature;
+  uint32_t size;
+
+#if defined(CONFIG_NET_IPv4) && defined(CONFIG_NET_IPv6)
+  feature = conn->domain == PF_INET ? NETDEV_F_TSO4 : NETDEV_F_TSO6;
+#elif defined(CONFIG_NET_IPv4)
+  feature = NETDEV_F_TSO4;
+#else
+  feature = NETDEV_F_TSO6;
+#endif
+
+  if ((dev->d_features & feature) != 0 &&
+      (dev->d_features & NETDEV_F_TXCSUM) != 0 &&
+      dev->d_tsomax > tcpip_hdrsize(conn) + conn->mss)
+    {
+      size = dev->d_tsomax - tcpip_hdrsize(conn);
+      return size - size % conn->mss;
+    }
+#endif
+
+  return conn->mss;
+}
+
 /****************************************************************************
  * Name: psock_insert_segment
  *
@@ -762,6 +799,14 @@ static uint16_t psock_send_eventhandler(FAR struct net_driver_s *dev,
             }
 #endif
 
+#ifdef CONFIG_NETDEV_OFFLOAD
+          /* Mark the packets larger than the MSS for segmentation by the
+           * device, so that devif_iob_send() accepts them.
+           */
+
+          NETDEV_GSOSIZE(dev) = sndlen > conn->mss ? conn->mss : 0;
+#endif
+
           ret = devif_iob_send(dev, TCP_WBIOB(wrb), sndlen,
                                0, tcpip_hdrsize(conn));
           if (ret <= 0)
@@ -1032,9 +1077,9 @@ static uint16_t psock_send_eventhandler(FAR struct net_driver_s *dev,
           int ret;
 
           sndlen = TCP_WBPKTLEN(wrb) - TCP_WBSENT(wrb);
-          if (sndlen > conn->mss)
+          if (sndlen > tcp_max_segsize(dev, conn))
             {
-              sndlen = conn->mss;
+              sndlen = tcp_max_segsize(dev, conn);
             }
 
           remaining_snd_wnd = TCP_SEQ_SUB(snd_wnd_edge, seq);
@@ -1090,7 +1135,7 @@ static uint16_t psock_send_eventhandler(FAR struct net_driver_s *dev,
            */
 
 #ifdef CONFIG_NET_JUMBO_FRAME
-          if (sndlen <= conn->mss)
+          if (sndlen <= tcp_max_segsize(dev, conn))
             {
               /* alloc iob */
 
@@ -1098,6 +1143,14 @@ static uint16_t psock_send_eventhandler(FAR struct net_driver_s *dev,
             }
 #endif
 
+#ifdef CONFIG_NETDEV_OFFLOAD
+          /* Mark the packets larger than the MSS for segmentation by the
+           * device, so that devif_iob_send() accepts them.
+           */
+
+          NETDEV_GSOSIZE(dev) = sndlen > conn->mss ? conn->mss : 0;
+#endif
+
           ret = devif_iob_send(dev, TCP_WBIOB(wrb), sndlen,
                                TCP_WBSENT(wrb), tcpip_hdrsize(conn));
           if (ret <= 0)
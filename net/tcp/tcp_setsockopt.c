@@ -26,8 +26,10 @@
 
 #include <nuttx/config.h>
 
+#include <sys/param.h>
 #include <sys/time.h>
 #include <stdint.h>
+#include <string.h>
 #include <errno.h>
 #include <assert.h>
 #include <debug.h>
@@ -260,6 +262,30 @@ int tcp_setsockopt(FAR struct socket *psock, int option,
           }
         break;
 
+#ifdef CONFIG_NET_TCP_CC_NEWRENO
+      case TCP_CONGESTION: /* The congestion control algorithm */
+        if (value == NULL || value_len == 0)
+          {
+            ret = -EINVAL;
+          }
+        else
+          {
+            char name[TCP_CA_NAME_MAX];
+            socklen_t len = MIN(value_len, sizeof(name) - 1);
+
+            /* The name need not be NUL-terminated within value_len */
+
+            memcpy(name, value, len);
+            name[len] = '\0';
+            ret = tcp_cc_select(conn, name);
+            if (ret < 0)
+              {
+                nerr("ERROR: Unknown congestion control: %s\n", name);
+              }
+          }
+        break;
+#endif
+
       default:
         nerr("ERROR: Unrecognized TCP option: %d\n", option);
         ret = -ENOPROTOOPT;
@@ -47,6 +47,7 @@
 #include <nuttx/config.h>
 #if defined(CONFIG_NET) && defined(CONFIG_NET_TCP)
 
+#include <sys/param.h>
 #include <stdint.h>
 #include <assert.h>
 #include <debug.h>
@@ -597,9 +598,23 @@ void tcp_timer(FAR struct net_driver_s *dev, FAR struct tcp_conn_s *conn)
                   goto done;
                 }
 
-              /* Exponential backoff. */
+              /* Exponential backoff.  The RTO measured with timestamps
+               * is reliable enough to start from.
+               */
+
+#ifdef CONFIG_NET_TCP_TIMESTAMPS
+              if ((conn->flags & TCP_TSTAMP) != 0)
+                {
+                  conn->timer = MIN((unsigned int)conn->rto <<
+                                    (conn->nrtx > 4 ? 4: conn->nrtx),
+                                    TCP_RTO_MAX);
+                }
+              else
+#endif
+                {
+                  conn->timer = TCP_RTO << (conn->nrtx > 4 ? 4: conn->nrtx);
+                }
 
-              conn->timer = TCP_RTO << (conn->nrtx > 4 ? 4: conn->nrtx);
               conn->nrtx++;
 
               /* Ok, so we need to retransmit. We do this differently
@@ -652,22 +667,9 @@ void tcp_timer(FAR struct net_driver_s *dev, FAR struct tcp_conn_s *conn)
                     tcp_rexmit(dev, conn, result);
 
 #ifdef CONFIG_NET_TCP_CC_NEWRENO
-                    /* If conn is TCP_INFR, it should enter to slow start */
-
-                    if (conn->flags & TCP_INFR)
-                      {
-                        conn->flags &= ~TCP_INFR;
-                      }
-
-                    /* update the max_cwnd */
-
-                    conn->max_cwnd = (conn->max_cwnd + 7 * conn->cwnd) >> 3;
-
-                    /* reset cwnd and ssthresh, refers to RFC5861. */
+                    /* Go back to slow start */
 
-                    conn->ssthresh =
-                                    MAX(conn->tx_unacked / 2, 2 * conn->mss);
-                    conn->cwnd = conn->mss;
+                    tcp_cc_timeout(conn);
 #endif
                     goto done;
 
@@ -749,6 +749,28 @@ uint16_t udp_callback(FAR struct net_driver_s *dev,
 ssize_t psock_udp_recvfrom(FAR struct socket *psock, FAR struct msghdr *msg,
                            int flags);
 
+/****************************************************************************
+ * Name: psock_udp_recvmmsg
+ *
+ * Description:
+ *   Take the datagrams already buffered by a UDP SOCK_DGRAM socket, up to
+ *   vlen of them, with the network locked only once.
+ *
+ * Input Parameters:
+ *   psock    Pointer to the socket structure for the SOCK_DRAM socket
+ *   msgvec   Receive info and buffers for the datagrams
+ *   vlen     The number of buffers
+ *   flags    Receive flags
+ *
+ * Returned Value:
+ *   The number of datagrams received, zero if none was buffered.
+ *
+ ****************************************************************************/
+
+int psock_udp_recvmmsg(FAR struct socket *psock,
+                       FAR struct mmsghdr *msgvec, unsigned int vlen,
+                       int flags);
+
 /****************************************************************************
  * Name: psock_udp_sendto
  *
@@ -143,6 +143,26 @@ static inline size_t udp_recvfrom_newdata(FAR struct net_driver_s *dev,
 {
   size_t recvlen;
 
+#ifdef CONFIG_NET_UDP_ZEROCOPY
+  /* Hand the I/O buffers of the packet over to the caller */
+
+  if ((pstate->ir_flags & MSG_ZEROCOPY) != 0)
+    {
+      FAR struct iob_s *iob = dev->d_iob;
+
+      recvlen = dev->d_len;
+      iob = iob_trimhead(iob, dev->d_appdata - iob->io_data - iob->io_offset);
+      iob_update_pktlen(iob, recvlen, false);
+      netdev_iob_clear(dev);
+
+      *(FAR struct iob_s **)pstate->ir_msg->msg_iov->iov_base = iob;
+      pstate->ir_recvlen = recvlen;
+
+      dev->d_len = 0;
+      return recvlen;
+    }
+#endif
+
   /* Get the length of the data to return */
 
   if (dev->d_len > pstate->ir_msg->msg_iov->iov_len)
@@ -169,6 +189,86 @@ static inline size_t udp_recvfrom_newdata(FAR struct net_driver_s *dev,
   return recvlen;
 }
 
+/****************************************************************************
+ * Name: udp_readahead_detach
+ *
+ * Description:
+ *   Remove the datagram at the head of the read-ahead buffer and return its
+ *   payload as an I/O buffer chain of its own, for MSG_ZEROCOPY.
+ *
+ * Input Parameters:
+ *   conn     The UDP connection holding the datagram
+ *   offset   Offset of the payload from the head of the read-ahead buffer
+ *   datalen  Length of the payload
+ *   iob      Location to return the I/O buffer chain
+ *
+ * Returned Value:
+ *   The length of the payload, or a negated errno value if the datagram had
+ *   to be copied and no I/O buffer was available.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_UDP_ZEROCOPY
+static int udp_readahead_detach(FAR struct udp_conn_s *conn,
+                                unsigned int offset, uint16_t datalen,
+                                FAR struct iob_s **iob)
+{
+  FAR struct iob_s *head = conn->readahead;
+  FAR struct iob_s *tail = head;
+  unsigned int end = offset + datalen;
+  unsigned int len = head->io_len;
+  int ret;
+
+  /* Find the I/O buffer holding the end of the datagram */
+
+  while (len < end && tail->io_flink != NULL)
+    {
+      tail = tail->io_flink;
+      len += tail->io_len;
+    }
+
+  if (len == end)
+    {
+      /* The datagram ends with an I/O buffer, as it always does unless the
+       * read-ahead buffer is packed: unlink its I/O buffers.
+       */
+
+      conn->readahead = tail->io_flink;
+      if (conn->readahead != NULL)
+        {
+          conn->readahead->io_pktlen = head->io_pktlen - end;
+        }
+
+      tail->io_flink  = NULL;
+      head->io_pktlen = end;
+      *iob = iob_trimhead(head, offset);
+      return datalen;
+    }
+
+  /* The datagram shares an I/O buffer with the next one, hand out a copy */
+
+  *iob = iob_tryalloc(true);
+  if (*iob == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  ret = iob_clone_partial(head, datalen, offset, *iob, 0, true, false);
+  if (ret < 0)
+    {
+      iob_free_chain(*iob);
+      *iob = NULL;
+      return ret;
+    }
+
+  conn->readahead = iob_trimhead(head, end);
+  return datalen;
+}
+#endif
+
 static inline void udp_readahead(struct udp_recvfrom_s *pstate)
 {
   FAR struct udp_conn_s *conn = pstate->ir_conn;
@@ -234,19 +334,39 @@ static inline void udp_readahead(struct udp_recvfrom_s *pstate)
       offset += sizeof(struct timespec);
 #endif
 
-      /* Copy to user */
+#ifdef CONFIG_NET_UDP_ZEROCOPY
+      /* Hand the I/O buffers over to the caller */
+
+      if ((pstate->ir_flags & MSG_ZEROCOPY) != 0)
+        {
+          recvlen = udp_readahead_detach(conn, offset, datalen,
+                      (FAR struct iob_s **)pstate->ir_msg->msg_iov->iov_base);
+          if (recvlen < 0)
+            {
+              pstate->ir_result = recvlen;
+              return;
+            }
+
+          iob = NULL;
+        }
+      else
+#endif
+        {
+          /* Copy to user */
+
+          recvlen = iob_copyout(pstate->ir_msg->msg_iov->iov_base, iob,
+                                MIN(pstate->ir_msg->msg_iov->iov_len,
+                                    datalen),
+                                offset);
 
-      recvlen = iob_copyout(pstate->ir_msg->msg_iov->iov_base, iob,
-                            MIN(pstate->ir_msg->msg_iov->iov_len, datalen),
-                            offset);
+          ninfo("Received %d bytes (of %d, total %d)\n",
+                recvlen, datalen, iob->io_pktlen);
+        }
 
       /* Update the accumulated size of the data read */
 
       pstate->ir_recvlen = recvlen;
 
-      ninfo("Received %d bytes (of %d, total %d)\n",
-            recvlen, datalen, iob->io_pktlen);
-
       if (pstate->ir_msg->msg_name)
         {
           pstate->ir_msg->msg_namelen =
@@ -259,9 +379,11 @@ static inline void udp_readahead(struct udp_recvfrom_s *pstate)
 
       udp_recvpktinfo(pstate, srcaddr, ifindex);
 
-      /* Remove the packet from the head of the I/O buffer chain. */
+      /* Remove the packet from the head of the I/O buffer chain, unless
+       * it was detached already.
+       */
 
-      if (!(pstate->ir_flags & MSG_PEEK))
+      if (iob != NULL && !(pstate->ir_flags & MSG_PEEK))
         {
           if (offset + datalen >= iob->io_pktlen)
             {
@@ -683,6 +805,19 @@ ssize_t psock_udp_recvfrom(FAR struct socket *psock, FAR struct msghdr *msg,
   struct udp_recvfrom_s state;
   int ret;
 
+#ifdef CONFIG_NET_UDP_ZEROCOPY
+  /* A zero-copy receive returns an I/O buffer chain in the first iovec,
+   * which cannot be left in the read-ahead buffer.
+   */
+
+  if ((flags & MSG_ZEROCOPY) != 0 &&
+      ((flags & MSG_PEEK) != 0 ||
+       msg->msg_iov->iov_len < sizeof(FAR struct iob_s *)))
+    {
+      return -EINVAL;
+    }
+#endif
+
   /* Perform the UDP recvfrom() operation */
 
   /* Initialize the state structure.  This is done with the network locked
@@ -704,6 +839,16 @@ ssize_t psock_udp_recvfrom(FAR struct socket *psock, FAR struct msghdr *msg,
 
   ret = state.ir_recvlen;
 
+#ifdef CONFIG_NET_UDP_ZEROCOPY
+  /* Fail if the buffered datagram could not be handed out */
+
+  if (state.ir_result < 0)
+    {
+      ret = state.ir_result;
+    }
+  else
+#endif
+
   /* Handle non-blocking UDP sockets */
 
   if (_SS_ISNONBLOCK(conn->sconn.s_flags) || (flags & MSG_DONTWAIT) != 0)
@@ -778,4 +923,73 @@ ssize_t psock_udp_recvfrom(FAR struct socket *psock, FAR struct msghdr *msg,
   return ret;
 }
 
+/****************************************************************************
+ * Name: psock_udp_recvmmsg
+ *
+ * Description:
+ *   Take the datagrams already buffered in the read-ahead chain of a UDP
+ *   SOCK_DGRAM socket, up to vlen of them, with the network locked only
+ *   once.  This never waits for new datagrams.
+ *
+ * Input Parameters:
+ *   psock    Pointer to the socket structure for the SOCK_DRAM socket
+ *   msgvec   Receive info and buffers for the datagrams
+ *   vlen     The number of buffers
+ *   flags    Receive flags
+ *
+ * Returned Value:
+ *   The number of datagrams received, zero if none was buffered.
+ *
+ ****************************************************************************/
+
+int psock_udp_recvmmsg(FAR struct socket *psock,
+                       FAR struct mmsghdr *msgvec, unsigned int vlen,
+                       int flags)
+{
+  FAR struct udp_conn_s *conn = psock->s_conn;
+  FAR struct msghdr *msg;
+  struct udp_recvfrom_s state;
+  unsigned long msg_controllen;
+  FAR void *msg_control;
+  unsigned int n;
+
+  /* Only the fields used by udp_readahead() are needed */
+
+  memset(&state, 0, sizeof(struct udp_recvfrom_s));
+  state.ir_conn  = conn;
+  state.ir_flags = flags;
+
+  net_lock();
+
+  for (n = 0; n < vlen && conn->readahead != NULL; n++)
+    {
+      msg            = &msgvec[n].msg_hdr;
+      msg_control    = msg->msg_control;
+      msg_controllen = msg->msg_controllen;
+      state.ir_msg   = msg;
+
+      udp_readahead(&state);
+      if (state.ir_recvlen < 0)
+        {
+          break;
+        }
+
+      /* Recover the pointer and calculate the cmsg's true data length, as
+       * psock_recvmsg() does.
+       */
+
+      msg->msg_control    = msg_control;
+      msg->msg_controllen = msg_controllen - msg->msg_controllen;
+      msgvec[n].msg_len   = state.ir_recvlen;
+    }
+
+  if (n > 0)
+    {
+      udp_notify_recvcpu(conn);
+    }
+
+  net_unlock();
+  return n;
+}
+
 #endif /* CONFIG_NET && CONFIG_NET_UDP */
@@ -27,12 +27,169 @@
 #include <nuttx/config.h>
 #ifdef CONFIG_NET
 
+#include <stdbool.h>
+#include <stdint.h>
+#include <sys/endian.h>
+
 #include "utils/utils.h"
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifdef CONFIG_HAVE_LONG_LONG
+typedef uint64_t chksum_acc_t;
+typedef uint32_t chksum_word_t;
+#else
+typedef uint32_t chksum_acc_t;
+typedef uint16_t chksum_word_t;
+#endif
+
+#if defined(CONFIG_NET_CHKSUM_VECTOR) && defined(__GNUC__)
+typedef uint32_t chksum_vec_t __attribute__((vector_size(16)));
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: chksum_native
+ *
+ * Description:
+ *   Calculate the one's complement sum of the region described by data and
+ *   len, taken as 16-bit words in host byte order.  A trailing odd byte is
+ *   padded with zero.  The region may have any alignment.
+ *
+ *   The sum is accumulated a full word at a time in a wide accumulator and
+ *   the carries are only folded back once at the end.  With a 64-bit
+ *   accumulator and 32-bit loads no overflow is possible for len < 64KiB.
+ *
+ * Input Parameters:
+ *   data - Beginning of the data to include in the checksum.
+ *   len  - Length of the data to include in the checksum.
+ *
+ * Returned Value:
+ *   The 16-bit folded sum in host byte order.
+ *
+ ****************************************************************************/
+
+#ifndef CONFIG_NET_ARCH_CHKSUM
+static uint16_t chksum_native(FAR const uint8_t *data, uint16_t len)
+{
+  chksum_acc_t acc = 0;
+  bool swapped = false;
+
+  /* Sum an odd leading byte as if a zero byte preceded it.  The remaining
+   * words are then naturally aligned, but in the opposite byte lane, so the
+   * final result must be swapped.
+   */
+
+  if (((uintptr_t)data & 1) != 0 && len > 0)
+    {
+#ifdef CONFIG_ENDIAN_BIG
+      acc = *data;
+#else
+      acc = (chksum_acc_t)*data << 8;
+#endif
+      data++;
+      len--;
+      swapped = true;
+    }
+
+  /* Advance to a word boundary */
+
+  while (((uintptr_t)data & (sizeof(chksum_word_t) - 1)) != 0 && len >= 2)
+    {
+      acc  += *(FAR const uint16_t *)data;
+      data += 2;
+      len  -= 2;
+    }
+
+#if defined(CONFIG_NET_CHKSUM_VECTOR) && defined(__GNUC__)
+  /* Sum 64 bytes per iteration with 128-bit vectors.  Each 32-bit lane
+   * gathers two 16-bit words per vector, so a lane cannot overflow for any
+   * len < 64KiB.
+   */
+
+  if (len >= 64)
+    {
+      const chksum_vec_t mask =
+      {
+        0xffff, 0xffff, 0xffff, 0xffff
+      };
+
+      chksum_vec_t vacc =
+      {
+        0, 0, 0, 0
+      };
+
+      while (len >= 64)
+        {
+          chksum_vec_t v0;
+          chksum_vec_t v1;
+          chksum_vec_t v2;
+          chksum_vec_t v3;
+
+          __builtin_memcpy(&v0, data, 16);
+          __builtin_memcpy(&v1, data + 16, 16);
+          __builtin_memcpy(&v2, data + 32, 16);
+          __builtin_memcpy(&v3, data + 48, 16);
+
+          vacc += (v0 & mask) + (v0 >> 16) + (v1 & mask) + (v1 >> 16);
+          vacc += (v2 & mask) + (v2 >> 16) + (v3 & mask) + (v3 >> 16);
+
+          data += 64;
+          len  -= 64;
+        }
+
+      acc += (chksum_acc_t)vacc[0] + vacc[1] + vacc[2] + vacc[3];
+    }
+#endif
+
+  /* Sum 8 words per iteration */
+
+  while (len >= 8 * sizeof(chksum_word_t))
+    {
+      FAR const chksum_word_t *word = (FAR const chksum_word_t *)data;
+
+      acc += (chksum_acc_t)word[0] + word[1] + word[2] + word[3];
+      acc += (chksum_acc_t)word[4] + word[5] + word[6] + word[7];
+
+      data += 8 * sizeof(chksum_word_t);
+      len  -= 8 * sizeof(chksum_word_t);
+    }
+
+  /* Sum the remaining words and the trailing byte */
+
+  while (len >= 2)
+    {
+      acc  += *(FAR const uint16_t *)data;
+      data += 2;
+      len  -= 2;
+    }
+
+  if (len > 0)
+    {
+#ifdef CONFIG_ENDIAN_BIG
+      acc += (chksum_acc_t)*data << 8;
+#else
+      acc += *data;
+#endif
+    }
+
+  /* Fold the carries back into the low 16 bits */
+
+#ifdef CONFIG_HAVE_LONG_LONG
+  acc = (acc >> 32) + (acc & 0xffffffff);
+  acc = (acc >> 32) + (acc & 0xffffffff);
+#endif
+  acc = (acc >> 16) + (acc & 0xffff);
+  acc = (acc >> 16) + (acc & 0xffff);
+
+  return swapped ? __swap_uint16((uint16_t)acc) : (uint16_t)acc;
+}
+
 /****************************************************************************
  * Name: checksum
  *
@@ -53,55 +210,39 @@
  *
  ****************************************************************************/
 
-#ifndef CONFIG_NET_ARCH_CHKSUM
 uint16_t checksum(uint16_t sum, FAR const uint8_t *data,
                     uint16_t len, bool *odd)
 {
-  FAR const uint8_t *dataptr;
-  FAR const uint8_t *last_byte;
   uint16_t t;
 
-  dataptr = data;
-  last_byte = data + len - 1;
+  /* The sum is kept in network word order.  Byte swapping a one's
+   * complement sum is the same as summing the byte swapped words, so the
+   * host order sum only needs one swap on little endian machines.
+   */
 
-  if (*odd == true)
-    {
-      t = dataptr[0];
-      sum += t;
-      if (sum < t)
-        {
-          sum++; /* carry */
-        }
+  t = chksum_native(data, len);
+#ifndef CONFIG_ENDIAN_BIG
+  t = __swap_uint16(t);
+#endif
 
-      dataptr += 1;
-    }
+  /* If the previous call ended with half of a word, the data here starts
+   * in the low order byte lane.
+   */
 
-  while (dataptr < last_byte)
+  if (*odd)
     {
-      /* At least two more bytes */
-
-      t = ((uint16_t)dataptr[0] << 8) + dataptr[1];
-      sum += t;
-      if (sum < t)
-        {
-          sum++; /* carry */
-        }
-
-      dataptr += 2;
+      t = __swap_uint16(t);
     }
 
-  *odd = false;
-
-  if (dataptr == last_byte)
+  if ((len & 1) != 0)
     {
-      t = (dataptr[0] << 8) + 0;
-      sum += t;
-      if (sum < t)
-        {
-          sum++; /* carry */
-        }
+      *odd = !*odd;
+    }
 
-      *odd = true;
+  sum += t;
+  if (sum < t)
+    {
+      sum++; /* carry */
     }
 
   /* Return sum in host byte order. */
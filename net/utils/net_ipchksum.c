@@ -31,6 +31,7 @@
 #include <nuttx/net/netdev.h>
 #include <nuttx/net/ip.h>
 
+#include "devif/devif.h"
 #include "utils/utils.h"
 
 #ifdef CONFIG_NET
@@ -308,4 +309,66 @@ uint16_t ipv4_chksum(FAR struct ipv4_hdr_s *ipv4)
 }
 #endif /* CONFIG_NET_ARCH_CHKSUM */
 
+/****************************************************************************
+ * Name: net_chksum_partial
+ *
+ * Description:
+ *   Leave the TCP or UDP checksum of the outgoing packet in d_iob to the
+ *   network device if it supports checksum offload.  The checksum field is
+ *   seeded with the pseudo-header checksum and the packet is marked so that
+ *   the driver has the device complete it.  For a packet split by the
+ *   device, the pseudo-header covers the whole packet and the device
+ *   adjusts it for each segment.
+ *
+ * Input Parameters:
+ *   dev    - The network device that sends the packet
+ *   field  - The checksum field in the protocol header
+ *   proto  - IP_PROTO_TCP or IP_PROTO_UDP
+ *
+ * Returned Value:
+ *   True if the checksum is left to the device.  False if the caller must
+ *   calculate it: the device does not support checksum offload or the
+ *   packet is going to be fragmented.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NETDEV_OFFLOAD
+bool net_chksum_partial(FAR struct net_driver_s *dev,
+                        FAR uint16_t *field, uint8_t proto)
+{
+  FAR struct iob_s *iob = dev->d_iob;
+  uint16_t sum;
+
+  iob->io_flags &= ~IOB_F_CSUM_PARTIAL;
+
+  if ((dev->d_features & NETDEV_F_TXCSUM) == 0 ||
+      (iob->io_gsosize == 0 && iob->io_pktlen > devif_get_mtu(dev)))
+    {
+      return false;
+    }
+
+#ifdef CONFIG_NET_IPv6
+#ifdef CONFIG_NET_IPv4
+  if (IFF_IS_IPv6(dev->d_flags))
+#endif
+    {
+      sum = ipv6_upperlayer_header_chksum(dev, proto, IPv6_HDRLEN);
+    }
+#endif /* CONFIG_NET_IPv6 */
+
+#ifdef CONFIG_NET_IPv4
+#ifdef CONFIG_NET_IPv6
+  else
+#endif
+    {
+      sum = ipv4_upperlayer_header_chksum(dev, proto);
+    }
+#endif /* CONFIG_NET_IPv4 */
+
+  *field        = HTONS(sum);
+  iob->io_flags |= IOB_F_CSUM_PARTIAL;
+  return true;
+}
+#endif /* CONFIG_NETDEV_OFFLOAD */
+
 #endif /* CONFIG_NET */
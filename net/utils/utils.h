@@ -357,6 +357,31 @@ void net_chksum_adjust(FAR uint16_t *chksum,
                        FAR const uint16_t *optr, ssize_t olen,
                        FAR const uint16_t *nptr, ssize_t nlen);
 
+/****************************************************************************
+ * Name: net_chksum_partial
+ *
+ * Description:
+ *   Leave the TCP or UDP checksum of the outgoing packet in d_iob to the
+ *   network device if it supports checksum offload.
+ *
+ * Input Parameters:
+ *   dev    - The network device that sends the packet
+ *   field  - The checksum field in the protocol header
+ *   proto  - IP_PROTO_TCP or IP_PROTO_UDP
+ *
+ * Returned Value:
+ *   True if the checksum is left to the device, false if the caller must
+ *   calculate it.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NETDEV_OFFLOAD
+bool net_chksum_partial(FAR struct net_driver_s *dev,
+                        FAR uint16_t *field, uint8_t proto);
+#else
+#  define net_chksum_partial(dev, field, proto) false
+#endif
+
 /****************************************************************************
  * Name: tcp_chksum, tcp_ipv4_chksum, and tcp_ipv6_chksum
  *
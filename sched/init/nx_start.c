@@ -424,6 +424,7 @@ static void idle_task_initialize(void)
       tasklist = TLIST_HEAD(tcb);
 #endif
       dq_addfirst((FAR dq_entry_t *)tcb, tasklist);
+      nxsched_index_readytorun(tcb, tasklist);
 
       /* Mark the idle task as the running task */
 
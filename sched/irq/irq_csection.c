@@ -108,8 +108,12 @@ volatile uint8_t g_cpu_nestcount[CONFIG_SMP_NCPUS];
  *   This function detects this deadlock condition while spinning with
  *   interrupts disabled.
  *
+ *   With CONFIG_SCHED_CRITMONITOR_CONTENTION, the time spent spinning is
+ *   accounted to the caller of enter_critical_section().
+ *
  * Input Parameters:
- *   cpu - The index of CPU that is trying to enter the critical section.
+ *   cpu    - The index of CPU that is trying to enter the critical section.
+ *   caller - The return address of enter_critical_section().
  *
  * Returned Value:
  *   True:  The g_cpu_irqlock spinlock has been taken.
@@ -119,8 +123,12 @@ volatile uint8_t g_cpu_nestcount[CONFIG_SMP_NCPUS];
  ****************************************************************************/
 
 #ifdef CONFIG_SMP
-static inline_function bool irq_waitlock(int cpu)
+static inline_function bool irq_waitlock(int cpu, FAR void *caller)
 {
+#if defined(CONFIG_SCHED_CRITMONITOR_CONTENTION) && \
+    CONFIG_SCHED_CRITMONITOR_CONTENTION > 0
+  clock_t start = 0;
+#endif
 #ifdef CONFIG_SCHED_INSTRUMENTATION_SPINLOCKS
   FAR struct tcb_s *tcb = current_task(cpu);
 
@@ -135,6 +143,14 @@ static inline_function bool irq_waitlock(int cpu)
 
   while (!spin_trylock_wo_note(&g_cpu_irqlock))
     {
+#if defined(CONFIG_SCHED_CRITMONITOR_CONTENTION) && \
+    CONFIG_SCHED_CRITMONITOR_CONTENTION > 0
+      if (start == 0)
+        {
+          start = perf_gettime();
+        }
+#endif
+
       /* Is a pause request pending? */
 
       if (up_cpu_pausereq(cpu))
@@ -155,6 +171,17 @@ static inline_function bool irq_waitlock(int cpu)
 
   /* We have g_cpu_irqlock! */
 
+#if defined(CONFIG_SCHED_CRITMONITOR_CONTENTION) && \
+    CONFIG_SCHED_CRITMONITOR_CONTENTION > 0
+  if (start != 0)
+    {
+      nxsched_critmon_contention(&g_cpu_irqlock, caller,
+                                 perf_gettime() - start);
+    }
+#else
+  UNUSED(caller);
+#endif
+
 #ifdef CONFIG_SCHED_INSTRUMENTATION_SPINLOCKS
   /* Notify that we have the spinlock */
 
@@ -275,7 +302,7 @@ try_again:
                */
 
 try_again_in_irq:
-              if (!irq_waitlock(cpu))
+              if (!irq_waitlock(cpu, return_address(0)))
                 {
                   /* We are in a deadlock condition due to a pending
                    * pause request interrupt.  Break the deadlock by
@@ -354,7 +381,7 @@ try_again_in_irq:
 
           DEBUGASSERT((g_cpu_irqset & (1 << cpu)) == 0);
 
-          if (!irq_waitlock(cpu))
+          if (!irq_waitlock(cpu, return_address(0)))
             {
               /* We are in a deadlock condition due to a pending pause
                * request interrupt.  Re-enable interrupts on this CPU
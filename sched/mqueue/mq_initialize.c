@@ -28,6 +28,7 @@
 
 #include <stdint.h>
 #include <nuttx/kmalloc.h>
+#include <nuttx/spinlock.h>
 #include <nuttx/trace.h>
 
 #include "mqueue/mqueue.h"
@@ -67,6 +68,10 @@ struct list_node g_msgfree;
 
 struct list_node g_msgfreeirq;
 
+/* g_msgfreelock protects the lists of free messages */
+
+spinlock_t g_msgfreelock = SP_UNLOCKED;
+
 #endif
 
 /****************************************************************************
@@ -38,6 +38,7 @@
 #include <sched.h>
 
 #include <nuttx/mqueue.h>
+#include <nuttx/spinlock.h>
 
 #if defined(CONFIG_MQ_MAXMSGSIZE) && CONFIG_MQ_MAXMSGSIZE > 0
 
@@ -99,6 +100,12 @@ EXTERN struct list_node g_msgfree;
 
 EXTERN struct list_node g_msgfreeirq;
 
+/* g_msgfreelock protects the lists of free messages, which are accessed
+ * without the critical section.
+ */
+
+EXTERN spinlock_t g_msgfreelock;
+
 /****************************************************************************
  * Public Function Prototypes
  ****************************************************************************/
@@ -331,6 +331,34 @@ bool nxsched_add_readytorun(FAR struct tcb_s *rtrtcb);
 bool nxsched_remove_readytorun(FAR struct tcb_s *rtrtcb, bool merge);
 void nxsched_remove_self(FAR struct tcb_s *rtrtcb);
 bool nxsched_add_prioritized(FAR struct tcb_s *tcb, DSEG dq_queue_t *list);
+#ifdef CONFIG_SCHED_READYTORUN_INDEX
+void nxsched_index_readytorun(FAR struct tcb_s *tcb, FAR dq_queue_t *list);
+void nxsched_unindex_readytorun(FAR struct tcb_s *tcb,
+                                FAR dq_queue_t *list);
+void nxsched_reindex_readytorun(void);
+#else
+#  define nxsched_index_readytorun(t, l)
+#  define nxsched_unindex_readytorun(t, l)
+#  define nxsched_reindex_readytorun()
+#endif
+
+/* Change in place the priority of the running task.  Only in the non-SMP
+ * case is the running task a member of the g_readytorun list.
+ */
+
+#if defined(CONFIG_SCHED_READYTORUN_INDEX) && !defined(CONFIG_SMP)
+#  define nxsched_set_running_priority(t, p) \
+     do \
+       { \
+         nxsched_unindex_readytorun(t, list_readytorun()); \
+         (t)->sched_priority = (uint8_t)(p); \
+         nxsched_index_readytorun(t, list_readytorun()); \
+       } \
+     while (0)
+#else
+#  define nxsched_set_running_priority(t, p) \
+     ((t)->sched_priority = (uint8_t)(p))
+#endif
 void nxsched_merge_prioritized(FAR dq_queue_t *list1, FAR dq_queue_t *list2,
                                uint8_t task_state);
 bool nxsched_merge_pending(void);
@@ -407,6 +435,23 @@ int  nxsched_select_cpu(cpu_set_t affinity);
 int  nxsched_pause_cpu(FAR struct tcb_s *tcb);
 void nxsched_process_delivered(int cpu);
 
+#  ifdef CONFIG_SCHED_CPUSELECT_AFFINITY
+int  nxsched_select_task_cpu(FAR struct tcb_s *tcb);
+#    define nxsched_set_cpu(t, c) \
+       do \
+         { \
+           if ((t)->cpu != (c)) \
+             { \
+               (t)->nmigrations++; \
+               (t)->cpu = (c); \
+             } \
+         } \
+       while (0)
+#  else
+#    define nxsched_select_task_cpu(t) nxsched_select_cpu((t)->affinity)
+#    define nxsched_set_cpu(t, c)     ((t)->cpu = (c))
+#  endif
+
 #  define nxsched_islocked_global() (g_cpu_lockset != 0)
 #  define nxsched_islocked_tcb(tcb) nxsched_islocked_global()
 
@@ -442,6 +487,20 @@ void nxsched_critmon_csection(FAR struct tcb_s *tcb, bool state,
                               FAR void *caller);
 #endif
 
+/* Lock contention accounting.  critmon_spin_lock_irqsave() is used by the
+ * locks that replace the critical section on hot paths.
+ */
+
+#if defined(CONFIG_SCHED_CRITMONITOR_CONTENTION) && \
+    CONFIG_SCHED_CRITMONITOR_CONTENTION > 0
+void nxsched_critmon_contention(FAR volatile void *lock, FAR void *caller,
+                                clock_t elapsed);
+irqstate_t nxsched_critmon_spin_lock_irqsave(FAR volatile spinlock_t *lock);
+#  define critmon_spin_lock_irqsave(l) nxsched_critmon_spin_lock_irqsave(l)
+#else
+#  define critmon_spin_lock_irqsave(l) spin_lock_irqsave(l)
+#endif
+
 /* TCB operations */
 
 bool nxsched_verify_tcb(FAR struct tcb_s *tcb);
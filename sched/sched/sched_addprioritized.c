@@ -28,16 +28,159 @@
 
 #include <stdint.h>
 #include <stdbool.h>
+#include <string.h>
+#include <strings.h>
 #include <assert.h>
 
 #include <nuttx/queue.h>
 
 #include "sched/sched.h"
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_READYTORUN_INDEX
+#  define RTR_NPRIORITIES  256
+#  define RTR_NWORDS       (RTR_NPRIORITIES / 32)
+#endif
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_READYTORUN_INDEX
+/* The g_readytorun list is kept in descending priority order, so that the
+ * TCBs of each priority form a FIFO group inside the list.  The index keeps
+ * the last TCB of every group and a bitmap of the priorities present, so
+ * that the insertion point of a TCB is found without walking the list.
+ */
+
+static uint32_t g_rtrmap[RTR_NWORDS];
+static FAR struct tcb_s *g_rtrtail[RTR_NPRIORITIES];
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_READYTORUN_INDEX
+
+/****************************************************************************
+ * Name: nxsched_rtr_prev
+ *
+ * Description:
+ *   Return the TCB after which a TCB of the given priority is inserted in
+ *   the g_readytorun list:  the last TCB of the same or of the nearest
+ *   higher priority, or NULL if the TCB goes to the head of the list.
+ *
+ ****************************************************************************/
+
+static FAR struct tcb_s *nxsched_rtr_prev(uint8_t priority)
+{
+  uint32_t map;
+  int word = priority >> 5;
+
+  /* Look for the priority itself and the higher ones of its word first */
+
+  map = g_rtrmap[word] & ~((UINT32_C(1) << (priority & 31)) - 1);
+
+  while (map == 0)
+    {
+      if (++word >= RTR_NWORDS)
+        {
+          return NULL;
+        }
+
+      map = g_rtrmap[word];
+    }
+
+  return g_rtrtail[(word << 5) + ffs(map) - 1];
+}
+
+#endif /* CONFIG_SCHED_READYTORUN_INDEX */
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
 
+#ifdef CONFIG_SCHED_READYTORUN_INDEX
+
+/****************************************************************************
+ * Name: nxsched_index_readytorun
+ *
+ * Description:
+ *   Record a TCB that has just been linked into a prioritized list other
+ *   than by nxsched_add_prioritized().  Nothing is done unless the list is
+ *   the g_readytorun list.
+ *
+ ****************************************************************************/
+
+void nxsched_index_readytorun(FAR struct tcb_s *tcb, FAR dq_queue_t *list)
+{
+  uint8_t priority = tcb->sched_priority;
+
+  if (list == list_readytorun() &&
+      (tcb->flink == NULL || tcb->flink->sched_priority != priority))
+    {
+      g_rtrtail[priority] = tcb;
+      g_rtrmap[priority >> 5] |= UINT32_C(1) << (priority & 31);
+    }
+}
+
+/****************************************************************************
+ * Name: nxsched_unindex_readytorun
+ *
+ * Description:
+ *   Forget a TCB that is about to be unlinked from a prioritized list, or
+ *   whose priority is about to change in place.  Nothing is done unless the
+ *   list is the g_readytorun list.
+ *
+ ****************************************************************************/
+
+void nxsched_unindex_readytorun(FAR struct tcb_s *tcb,
+                                FAR dq_queue_t *list)
+{
+  uint8_t priority = tcb->sched_priority;
+
+  if (list == list_readytorun() && g_rtrtail[priority] == tcb)
+    {
+      if (tcb->blink != NULL && tcb->blink->sched_priority == priority)
+        {
+          g_rtrtail[priority] = tcb->blink;
+        }
+      else
+        {
+          g_rtrtail[priority] = NULL;
+          g_rtrmap[priority >> 5] &= ~(UINT32_C(1) << (priority & 31));
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: nxsched_reindex_readytorun
+ *
+ * Description:
+ *   Rebuild the index after the g_readytorun list was changed as a whole.
+ *
+ ****************************************************************************/
+
+void nxsched_reindex_readytorun(void)
+{
+  FAR struct tcb_s *tcb;
+
+  memset(g_rtrmap, 0, sizeof(g_rtrmap));
+
+  for (tcb = (FAR struct tcb_s *)list_readytorun()->head;
+       tcb != NULL;
+       tcb = tcb->flink)
+    {
+      nxsched_index_readytorun(tcb, list_readytorun());
+    }
+}
+
+#endif /* CONFIG_SCHED_READYTORUN_INDEX */
+
 /****************************************************************************
  * Name: nxsched_add_prioritized
  *
@@ -75,6 +218,30 @@ bool nxsched_add_prioritized(FAR struct tcb_s *tcb, DSEG dq_queue_t *list)
 
   DEBUGASSERT(sched_priority >= SCHED_PRIORITY_MIN);
 
+#ifdef CONFIG_SCHED_READYTORUN_INDEX
+  if (list == list_readytorun())
+    {
+      /* The TCB goes after the last TCB of the same or of the nearest
+       * higher priority.
+       */
+
+      prev = nxsched_rtr_prev(sched_priority);
+      if (prev == NULL)
+        {
+          dq_addfirst((FAR dq_entry_t *)tcb, list);
+          ret = true;
+        }
+      else
+        {
+          dq_addafter((FAR dq_entry_t *)prev, (FAR dq_entry_t *)tcb, list);
+        }
+
+      g_rtrtail[sched_priority] = tcb;
+      g_rtrmap[sched_priority >> 5] |= UINT32_C(1) << (sched_priority & 31);
+      return ret;
+    }
+#endif
+
   /* Search the list to find the location to insert the new Tcb.
    * Each is list is maintained in descending sched_priority order.
    */
@@ -160,7 +160,7 @@ bool nxsched_add_readytorun(FAR struct tcb_s *btcb)
   int cpu;
   int me;
 
-  cpu = nxsched_select_cpu(btcb->affinity);
+  cpu = nxsched_select_task_cpu(btcb);
 
   /* Get the task currently running on the CPU (may be the IDLE task) */
 
@@ -231,7 +231,7 @@ bool nxsched_add_readytorun(FAR struct tcb_s *btcb)
           if (g_delivertasks[cpu] == NULL)
             {
               g_delivertasks[cpu] = btcb;
-              btcb->cpu = cpu;
+              nxsched_set_cpu(btcb, cpu);
               btcb->task_state = TSTATE_TASK_ASSIGNED;
               up_cpu_pause_async(cpu);
             }
@@ -241,7 +241,7 @@ bool nxsched_add_readytorun(FAR struct tcb_s *btcb)
               if (rtcb->sched_priority < btcb->sched_priority)
                 {
                   g_delivertasks[cpu] = btcb;
-                  btcb->cpu = cpu;
+                  nxsched_set_cpu(btcb, cpu);
                   btcb->task_state = TSTATE_TASK_ASSIGNED;
                   nxsched_add_prioritized(rtcb, &g_readytorun);
                   rtcb->task_state = TSTATE_TASK_READYTORUN;
@@ -271,7 +271,7 @@ bool nxsched_add_readytorun(FAR struct tcb_s *btcb)
       dq_addfirst_nonempty((FAR dq_entry_t *)btcb, tasklist);
 
       DEBUGASSERT(task_state == TSTATE_TASK_RUNNING);
-      btcb->cpu        = cpu;
+      nxsched_set_cpu(btcb, cpu);
       btcb->task_state = TSTATE_TASK_RUNNING;
 
       doswitch = true;
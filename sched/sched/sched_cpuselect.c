@@ -27,6 +27,8 @@
 #include <nuttx/config.h>
 
 #include <sys/types.h>
+#include <stdbool.h>
+#include <stdint.h>
 #include <assert.h>
 
 #include <nuttx/sched.h>
@@ -41,6 +43,54 @@
 
 #define IMPOSSIBLE_CPU 0xff
 
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_CPUSELECT_AFFINITY
+
+/****************************************************************************
+ * Name:  nxsched_cpu_idleticks
+ *
+ * Description:
+ *   Return the number of ticks the CPU recently spent in its IDLE task.
+ *   The ticks of all threads are scaled back together, so the values of
+ *   different CPUs can be compared:  the higher, the less loaded the CPU.
+ *
+ ****************************************************************************/
+
+#ifndef CONFIG_SCHED_CPULOAD_NONE
+#  define nxsched_cpu_idleticks(cpu) (g_idletcb[cpu].ticks)
+#else
+#  define nxsched_cpu_idleticks(cpu) ((clock_t)0)
+#endif
+
+/****************************************************************************
+ * Name:  nxsched_cpu_overloaded
+ *
+ * Description:
+ *   Return true if the CPU 'cpu' has been busier than the CPU 'other' by
+ *   more than CONFIG_SCHED_CPUSELECT_IMBALANCE percent of the time.
+ *
+ ****************************************************************************/
+
+#if defined(CONFIG_SCHED_CPUSELECT_IMBALANCE) && \
+    CONFIG_SCHED_CPUSELECT_IMBALANCE > 0
+static bool nxsched_cpu_overloaded(int cpu, int other)
+{
+  clock_t idle = nxsched_cpu_idleticks(cpu);
+  clock_t otheridle = nxsched_cpu_idleticks(other);
+
+  return otheridle > idle &&
+         (uint64_t)(otheridle - idle) * 100 * CONFIG_SMP_NCPUS >
+         (uint64_t)g_cpuload_total * CONFIG_SCHED_CPUSELECT_IMBALANCE;
+}
+#else
+#  define nxsched_cpu_overloaded(c, o) false
+#endif
+
+#endif /* CONFIG_SCHED_CPUSELECT_AFFINITY */
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -50,7 +100,8 @@
  *
  * Description:
  *   Return the index to the CPU with the lowest priority running task,
- *   possibly its IDLE task.
+ *   possibly its IDLE task.  With CONFIG_SCHED_CPUSELECT_AFFINITY, the
+ *   least loaded of the equally good CPUs is returned.
  *
  * Input Parameters:
  *   affinity - The set of CPUs on which the thread is permitted to run.
@@ -92,9 +143,25 @@ int nxsched_select_cpu(cpu_set_t affinity)
                */
 
               DEBUGASSERT(rtcb->sched_priority == 0);
+#ifdef CONFIG_SCHED_CPUSELECT_AFFINITY
+              if (minprio > 0 || nxsched_cpu_idleticks(i) >
+                                 nxsched_cpu_idleticks(cpu))
+                {
+                  minprio = 0;
+                  cpu = i;
+                }
+#else
               return i;
+#endif
             }
+#ifdef CONFIG_SCHED_CPUSELECT_AFFINITY
+          else if (cpu == IMPOSSIBLE_CPU ||
+                   rtcb->sched_priority < minprio ||
+                   (rtcb->sched_priority == minprio &&
+                    nxsched_cpu_idleticks(i) >= nxsched_cpu_idleticks(cpu)))
+#else
           else if (rtcb->sched_priority <= minprio)
+#endif
             {
               DEBUGASSERT(rtcb->sched_priority > 0);
               minprio = rtcb->sched_priority;
@@ -107,4 +174,62 @@ int nxsched_select_cpu(cpu_set_t affinity)
   return cpu;
 }
 
+#ifdef CONFIG_SCHED_CPUSELECT_AFFINITY
+
+/****************************************************************************
+ * Name:  nxsched_select_task_cpu
+ *
+ * Description:
+ *   Return the index of the CPU on which a thread that has become
+ *   ready-to-run should be placed.  The CPU the thread last ran on is
+ *   preferred, as its cache may still hold the thread's data, if it is
+ *   idle or if the thread would preempt the task running there anyway.
+ *   An idle CPU is preferred over preempting a task, and an overloaded
+ *   CPU is left for the least loaded one.
+ *
+ * Input Parameters:
+ *   tcb - The TCB of the thread to place.
+ *
+ * Returned Value:
+ *   Index of the selected CPU.
+ *
+ * Assumptions:
+ *   Called from within a critical section.
+ *
+ ****************************************************************************/
+
+int nxsched_select_task_cpu(FAR struct tcb_s *tcb)
+{
+  FAR struct tcb_s *rtcb;
+  int prev = tcb->cpu;
+  int cpu;
+
+  if (prev < CONFIG_SMP_NCPUS && CPU_ISSET(prev, &tcb->affinity) &&
+      is_idle_task(current_task(prev)))
+    {
+      return prev;
+    }
+
+  cpu = nxsched_select_cpu(tcb->affinity);
+  if (cpu == prev || prev >= CONFIG_SMP_NCPUS ||
+      !CPU_ISSET(prev, &tcb->affinity) || is_idle_task(current_task(cpu)))
+    {
+      return cpu;
+    }
+
+  /* The previous CPU is busy, but the thread would run there immediately
+   * as it would on the selected CPU.
+   */
+
+  rtcb = current_task(prev);
+  if (rtcb->sched_priority < tcb->sched_priority &&
+      !nxsched_cpu_overloaded(prev, cpu))
+    {
+      return prev;
+    }
+
+  return cpu;
+}
+
+#endif /* CONFIG_SCHED_CPUSELECT_AFFINITY */
 #endif /* CONFIG_SMP */
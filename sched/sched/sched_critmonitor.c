@@ -100,6 +100,21 @@ clock_t g_premp_max[CONFIG_SMP_NCPUS];
 clock_t g_crit_max[CONFIG_SMP_NCPUS];
 #endif
 
+#if defined(CONFIG_SCHED_CRITMONITOR_CONTENTION) && \
+    CONFIG_SCHED_CRITMONITOR_CONTENTION > 0
+struct critmon_contention_s
+g_crit_contention[CONFIG_SCHED_CRITMONITOR_CONTENTION];
+#endif
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+#if defined(CONFIG_SCHED_CRITMONITOR_CONTENTION) && \
+    CONFIG_SCHED_CRITMONITOR_CONTENTION > 0
+static spinlock_t g_crit_contention_lock = SP_UNLOCKED;
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -261,6 +276,85 @@ void nxsched_critmon_csection(FAR struct tcb_s *tcb, bool state,
 }
 #endif /* CONFIG_SCHED_CRITMONITOR_MAXTIME_CSECTION >= 0 */
 
+/****************************************************************************
+ * Name: nxsched_critmon_contention
+ *
+ * Description:
+ *   Account the time spent waiting for a contended lock to the call site
+ *   that acquired it.  Sites are found by hashing the caller address; the
+ *   waits of the sites that do not fit in the table are dropped.
+ *
+ * Assumptions:
+ *   - Called with the local interrupts disabled.
+ *   - Might be called from an interrupt handler
+ *
+ ****************************************************************************/
+
+#if defined(CONFIG_SCHED_CRITMONITOR_CONTENTION) && \
+    CONFIG_SCHED_CRITMONITOR_CONTENTION > 0
+void nxsched_critmon_contention(FAR volatile void *lock, FAR void *caller,
+                                clock_t elapsed)
+{
+  FAR struct critmon_contention_s *site;
+  unsigned int index;
+  unsigned int i;
+
+  index = ((uintptr_t)caller >> 2) % CONFIG_SCHED_CRITMONITOR_CONTENTION;
+
+  spin_lock_wo_note(&g_crit_contention_lock);
+
+  for (i = 0; i < CONFIG_SCHED_CRITMONITOR_CONTENTION; i++)
+    {
+      site = &g_crit_contention[index];
+      if (site->caller == caller || site->caller == NULL)
+        {
+          site->caller = caller;
+          site->lock   = lock;
+          site->count++;
+          site->total += elapsed;
+          if (elapsed > site->max)
+            {
+              site->max = elapsed;
+            }
+
+          break;
+        }
+
+      if (++index >= CONFIG_SCHED_CRITMONITOR_CONTENTION)
+        {
+          index = 0;
+        }
+    }
+
+  spin_unlock_wo_note(&g_crit_contention_lock);
+}
+
+/****************************************************************************
+ * Name: nxsched_critmon_spin_lock_irqsave
+ *
+ * Description:
+ *   spin_lock_irqsave() for the locks that replace the critical section on
+ *   hot paths, accounting the time spent spinning to the caller.
+ *
+ ****************************************************************************/
+
+irqstate_t nxsched_critmon_spin_lock_irqsave(FAR volatile spinlock_t *lock)
+{
+  irqstate_t flags = up_irq_save();
+  clock_t start;
+
+  if (!spin_trylock(lock))
+    {
+      start = perf_gettime();
+      spin_lock(lock);
+      nxsched_critmon_contention(lock, return_address(0),
+                                 perf_gettime() - start);
+    }
+
+  return flags;
+}
+#endif /* CONFIG_SCHED_CRITMONITOR_CONTENTION > 0 */
+
 /****************************************************************************
  * Name: nxsched_resume_critmon
  *
@@ -147,6 +147,10 @@ bool nxsched_merge_pending(void)
               ptcb->task_state  = TSTATE_TASK_READYTORUN;
             }
 
+          /* The ptcb follows every TCB of the same priority */
+
+          nxsched_index_readytorun(ptcb, list_readytorun());
+
           /* Set up for the next time through */
 
           rtcb = ptcb;
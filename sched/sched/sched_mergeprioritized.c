@@ -110,7 +110,7 @@ void nxsched_merge_prioritized(FAR dq_queue_t *list1, FAR dq_queue_t *list2,
       /* Special case.. list2 is empty.  Move list1 to list2. */
 
       dq_move(&clone, list2);
-      return;
+      goto out;
     }
 
   /* Now loop until all entries from list1 have been merged into list2. tcb1
@@ -159,4 +159,13 @@ void nxsched_merge_prioritized(FAR dq_queue_t *list1, FAR dq_queue_t *list2,
         }
     }
   while (tcb1 != NULL);
+
+out:
+
+  /* The ready-to-run index follows the TCBs moved in or out of the list */
+
+  if (list1 == list_readytorun() || list2 == list_readytorun())
+    {
+      nxsched_reindex_readytorun();
+    }
 }
@@ -123,7 +123,7 @@ void nxsched_process_delivered(int cpu)
       /* Special case:  Insert at the head of the list */
 
       dq_addfirst_nonempty((FAR dq_entry_t *)btcb, tasklist);
-      btcb->cpu = cpu;
+      nxsched_set_cpu(btcb, cpu);
       btcb->task_state = TSTATE_TASK_RUNNING;
 
       DEBUGASSERT(btcb->flink != NULL);
@@ -140,7 +140,7 @@ void nxsched_process_delivered(int cpu)
       /* Insert in the middle of the list */
 
       dq_insert_mid(prev, btcb, next);
-      btcb->cpu = cpu;
+      nxsched_set_cpu(btcb, cpu);
       btcb->task_state = TSTATE_TASK_ASSIGNED;
     }
 
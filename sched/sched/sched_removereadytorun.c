@@ -93,6 +93,7 @@ bool nxsched_remove_readytorun(FAR struct tcb_s *rtcb, bool merge)
    * is always the g_readytorun list.
    */
 
+  nxsched_unindex_readytorun(rtcb, tasklist);
   dq_rem((FAR dq_entry_t *)rtcb, tasklist);
 
   /* Since the TCB is not in any list, it is now invalid */
@@ -255,10 +256,11 @@ void nxsched_remove_running(FAR struct tcb_s *tcb)
        * list and add to the head of the g_assignedtasks[cpu] list.
        */
 
+      nxsched_unindex_readytorun(rtrtcb, &g_readytorun);
       dq_rem((FAR dq_entry_t *)rtrtcb, &g_readytorun);
       dq_addfirst_nonempty((FAR dq_entry_t *)rtrtcb, tasklist);
 
-      rtrtcb->cpu = cpu;
+      nxsched_set_cpu(rtrtcb, cpu);
       nxttcb = rtrtcb;
     }
 
@@ -347,6 +349,7 @@ bool nxsched_remove_readytorun(FAR struct tcb_s *tcb, bool merge)
        * g_assignedtasks[cpu] list.
        */
 
+      nxsched_unindex_readytorun(tcb, tasklist);
       dq_rem((FAR dq_entry_t *)tcb, tasklist);
 
       /* Since the TCB is no longer in any list, it is now invalid */
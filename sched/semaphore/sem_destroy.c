@@ -72,10 +72,7 @@ int nxsem_destroy(FAR sem_t *sem)
    * leave the count unchanged but still return OK.
    */
 
-  if (sem->semcount >= 0)
-    {
-      sem->semcount = 1;
-    }
+  nxsem_set_count(sem, 1);
 
   /* Release holders of the semaphore */
 
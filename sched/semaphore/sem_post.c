@@ -80,6 +80,15 @@ int nxsem_post(FAR sem_t *sem)
 
   DEBUGASSERT(sem != NULL);
 
+  /* Without priority inheritance or protection, the count is given back
+   * without the critical section unless there is a thread to wake up.
+   */
+
+  if (NXSEM_FASTPATH(sem) && nxsem_inc_count(sem, 0, &sem_count))
+    {
+      return OK;
+    }
+
   /* The following operations must be performed with interrupts
    * disabled because sem_post() may be called from an interrupt
    * handler.
@@ -87,11 +96,12 @@ int nxsem_post(FAR sem_t *sem)
 
   flags = enter_critical_section();
 
-  sem_count = sem->semcount;
-
-  /* Check the maximum allowable value */
+  /* Check the maximum allowable value.  The count is still incremented
+   * atomically because waiters may take it without the critical section
+   * once it is positive.
+   */
 
-  if (sem_count >= SEM_VALUE_MAX)
+  if (!nxsem_inc_count(sem, INT16_MIN, &sem_count))
     {
       leave_critical_section(flags);
       return -EOVERFLOW;
@@ -116,7 +126,6 @@ int nxsem_post(FAR sem_t *sem)
 
   nxsem_release_holder(sem);
   sem_count++;
-  sem->semcount = sem_count;
 
 #if defined(CONFIG_PRIORITY_INHERITANCE) || defined(CONFIG_PRIORITY_PROTECT)
   /* Don't let any unblocked tasks run until we complete any priority
@@ -78,6 +78,15 @@ int nxsem_trywait(FAR sem_t *sem)
   DEBUGASSERT(!OSINIT_IDLELOOP() || !sched_idletask() ||
               up_interrupt_context());
 
+  /* Without priority inheritance or protection, there is no holder to
+   * track and the count is taken without the critical section.
+   */
+
+  if (NXSEM_FASTPATH(sem))
+    {
+      return nxsem_trydec_count(sem) ? OK : -EAGAIN;
+    }
+
   /* The following operations must be performed with interrupts disabled
    * because sem_post() may be called from an interrupt handler.
    */
@@ -97,7 +106,7 @@ int nxsem_trywait(FAR sem_t *sem)
           return ret;
         }
 
-      sem->semcount--;
+      atomic_fetch_sub(NXSEM_COUNT(sem), 1);
       nxsem_add_holder(sem);
       rtcb->waitobj = NULL;
       ret = OK;
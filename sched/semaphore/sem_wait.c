@@ -80,6 +80,15 @@ int nxsem_wait(FAR sem_t *sem)
   DEBUGASSERT(sem != NULL && up_interrupt_context() == false);
   DEBUGASSERT(!OSINIT_IDLELOOP() || !sched_idletask());
 
+  /* Without priority inheritance or protection, an available count is
+   * taken without the critical section.
+   */
+
+  if (NXSEM_FASTPATH(sem) && nxsem_trydec_count(sem))
+    {
+      return OK;
+    }
+
   /* The following operations must be performed with interrupts
    * disabled because nxsem_post() may be called from an interrupt
    * handler.
@@ -93,16 +102,22 @@ int nxsem_wait(FAR sem_t *sem)
 
   if (sem->semcount > 0)
     {
-      /* It is, let the task take the semaphore. */
-
       ret = nxsem_protect_wait(sem);
       if (ret < 0)
         {
           leave_critical_section(flags);
           return ret;
         }
+    }
+
+  /* The count may still be taken by the fast path of another CPU, so the
+   * lock is only acquired if it was available when it is decremented.
+   */
+
+  if (atomic_fetch_sub(NXSEM_COUNT(sem), 1) > 0)
+    {
+      /* It is, let the task take the semaphore. */
 
-      sem->semcount--;
       nxsem_add_holder(sem);
       rtcb->waitobj = NULL;
       ret = OK;
@@ -124,11 +139,9 @@ int nxsem_wait(FAR sem_t *sem)
 
       DEBUGASSERT(rtcb->waitobj == NULL);
 
-      /* Handle the POSIX semaphore (but don't set the owner yet) */
-
-      sem->semcount--;
-
-      /* Save the waited on semaphore in the TCB */
+      /* The POSIX semaphore count was already decremented above (but
+       * don't set the owner yet).  Save the waited on semaphore in the TCB
+       */
 
       rtcb->waitobj = sem;
 
@@ -35,6 +35,23 @@
 #include <stdint.h>
 #include <stdbool.h>
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The count of the semaphores without priority inheritance or protection
+ * is taken and given back with atomic operations outside the critical
+ * section, as long as no thread has to be blocked or woken up.  All the
+ * other changes of such a count must be atomic as well, see the count
+ * helpers in include/nuttx/semaphore.h.
+ */
+
+#if defined(CONFIG_PRIORITY_INHERITANCE) || defined(CONFIG_PRIORITY_PROTECT)
+#  define NXSEM_FASTPATH(s) (((s)->flags & SEM_PRIO_MASK) == SEM_PRIO_NONE)
+#else
+#  define NXSEM_FASTPATH(s) true
+#endif
+
 /****************************************************************************
  * Public Function Prototypes
  ****************************************************************************/
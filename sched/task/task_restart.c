@@ -143,10 +143,12 @@ static int nxtask_restart(pid_t pid)
   else
     {
       tasklist = TLIST_HEAD(&tcb->cmn, tcb->cmn.cpu);
+      nxsched_unindex_readytorun(&tcb->cmn, tasklist);
       dq_rem((FAR dq_entry_t *)tcb, tasklist);
     }
 #else
   tasklist = TLIST_HEAD(&tcb->cmn);
+  nxsched_unindex_readytorun(&tcb->cmn, tasklist);
   dq_rem((FAR dq_entry_t *)tcb, tasklist);
 #endif
 
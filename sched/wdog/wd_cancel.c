@@ -37,6 +37,57 @@
 #include "sched/sched.h"
 #include "wdog/wdog.h"
 
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: wd_remove_active
+ *
+ * Description:
+ *   Remove the watchdog from the active watchdogs if it is still active.
+ *
+ * Input Parameters:
+ *   wdog     - ID of the watchdog to cancel.
+ *   expiring - Set if watchdog callbacks are running at the same time.
+ *
+ * Returned Value:
+ *   True if the watchdog was the next one to expire, so that the interval
+ *   timer must be reassessed.
+ *
+ ****************************************************************************/
+
+static bool wd_remove_active(FAR struct wdog_s *wdog, FAR bool *expiring)
+{
+  irqstate_t flags;
+  bool head = false;
+
+  flags = critmon_spin_lock_irqsave(&g_wdlock);
+
+  /* Make sure that the watchdog is still active. */
+
+  if (WDOG_ISACTIVE(wdog))
+    {
+      head = wd_is_head(wdog);
+
+      /* Now, remove the watchdog from the timer queue */
+
+#ifdef CONFIG_WDOG_TIMER_WHEEL
+      wd_wheel_remove(wdog);
+#else
+      list_delete(&wdog->node);
+#endif
+
+      /* Mark the watchdog inactive */
+
+      wdog->func = NULL;
+    }
+
+  *expiring = g_wdtimernested > 0;
+  spin_unlock_irqrestore(&g_wdlock, flags);
+  return head;
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -60,15 +111,34 @@
 int wd_cancel(FAR struct wdog_s *wdog)
 {
   irqstate_t flags;
-  int ret;
+  bool expiring;
+  bool head;
 
-  flags = enter_critical_section();
+  if (wdog == NULL)
+    {
+      return -EINVAL;
+    }
+
+  head = wd_remove_active(wdog, &expiring);
+
+  /* The critical section is only needed to reassess the interval timer,
+   * or to wait for the watchdog callbacks that are running, which the
+   * callers may expect to have completed on return.
+   */
+
+  if (head || expiring)
+    {
+      flags = enter_critical_section();
 
-  ret = wd_cancel_irq(wdog);
+      if (head)
+        {
+          nxsched_reassess_timer();
+        }
 
-  leave_critical_section(flags);
+      leave_critical_section(flags);
+    }
 
-  return ret;
+  return OK;
 }
 
 /****************************************************************************
@@ -90,6 +160,8 @@ int wd_cancel(FAR struct wdog_s *wdog)
 
 int wd_cancel_irq(FAR struct wdog_s *wdog)
 {
+  bool expiring;
+
   if (wdog == NULL)
     {
       return -EINVAL;
@@ -99,29 +171,14 @@ int wd_cancel_irq(FAR struct wdog_s *wdog)
    * cancellation is complete
    */
 
-  /* Make sure that the watchdog is still active. */
-
-  if (WDOG_ISACTIVE(wdog))
+  if (wd_remove_active(wdog, &expiring))
     {
-      bool head = list_is_head(&g_wdactivelist, &wdog->node);
-
-      /* Now, remove the watchdog from the timer queue */
-
-      list_delete(&wdog->node);
-
-      /* Mark the watchdog inactive */
-
-      wdog->func = NULL;
-
-      if (head)
-        {
-          /* If the watchdog is at the head of the timer queue, then
-           * we will need to re-adjust the interval timer that will
-           * generate the next interval event.
-           */
+      /* If the watchdog is at the head of the timer queue, then
+       * we will need to re-adjust the interval timer that will
+       * generate the next interval event.
+       */
 
-          nxsched_reassess_timer();
-        }
+      nxsched_reassess_timer();
     }
 
   return OK;
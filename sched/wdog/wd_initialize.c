@@ -27,6 +27,7 @@
 #include <nuttx/config.h>
 
 #include <nuttx/list.h>
+#include <nuttx/spinlock.h>
 
 #include "wdog/wdog.h"
 
@@ -39,7 +40,19 @@
  * this linked list are removed and the function is called.
  */
 
+#ifndef CONFIG_WDOG_TIMER_WHEEL
 struct list_node g_wdactivelist = LIST_INITIAL_VALUE(g_wdactivelist);
+#endif
+
+/* g_wdlock protects the active watchdogs so that they can be started and
+ * cancelled without the critical section.
+ */
+
+spinlock_t g_wdlock = SP_UNLOCKED;
+
+/* The number of watchdog expirations in progress, protected by g_wdlock */
+
+unsigned int g_wdtimernested;
 
 /****************************************************************************
  * Public Functions
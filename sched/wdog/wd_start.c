@@ -72,17 +72,63 @@
 #endif
 
 /****************************************************************************
- * Private Data
+ * Private Functions
  ****************************************************************************/
 
-#ifdef CONFIG_SCHED_TICKLESS
-static unsigned int g_wdtimernested;
+/****************************************************************************
+ * Name: wd_remove_expired
+ *
+ * Description:
+ *   Remove and return the next watchdog that has expired by 'ticks', or
+ *   NULL if there is none.
+ *
+ ****************************************************************************/
+
+static inline_function FAR struct wdog_s *wd_remove_expired(clock_t ticks)
+{
+#ifdef CONFIG_WDOG_TIMER_WHEEL
+  return wd_wheel_expire(ticks);
+#else
+  FAR struct wdog_s *wdog;
+
+  if (list_is_empty(&g_wdactivelist))
+    {
+      return NULL;
+    }
+
+  wdog = list_first_entry(&g_wdactivelist, struct wdog_s, node);
+
+  /* Check if expected time is expired */
+
+  if (!clock_compare(wdog->expired, ticks))
+    {
+      return NULL;
+    }
+
+  /* Remove the watchdog from the head of the list */
+
+  list_delete(&wdog->node);
+  return wdog;
 #endif
+}
 
 /****************************************************************************
- * Private Functions
+ * Name: wd_remove
+ *
+ * Description:
+ *   Remove an active watchdog from the active watchdogs.
+ *
  ****************************************************************************/
 
+static inline_function void wd_remove(FAR struct wdog_s *wdog)
+{
+#ifdef CONFIG_WDOG_TIMER_WHEEL
+  wd_wheel_remove(wdog);
+#else
+  list_delete(&wdog->node);
+#endif
+}
+
 /****************************************************************************
  * Name: wd_expiration
  *
@@ -90,6 +136,9 @@ static unsigned int g_wdtimernested;
  *   Check if the timer for the watchdog at the head of list is ready to
  *   run. If so, remove the watchdog from the list and execute it.
  *
+ *   The callbacks run in the critical section as before, but g_wdlock is
+ *   released around them so that they may start or cancel watchdogs.
+ *
  * Input Parameters:
  *   ticks - current time in ticks
  *
@@ -101,55 +150,45 @@ static unsigned int g_wdtimernested;
 static inline_function void wd_expiration(clock_t ticks)
 {
   FAR struct wdog_s *wdog;
+  irqstate_t lflags;
   irqstate_t flags;
   wdentry_t func;
+  wdparm_t arg;
 
-  flags = enter_critical_section();
+  flags  = enter_critical_section();
+  lflags = spin_lock_irqsave(&g_wdlock);
 
-#ifdef CONFIG_SCHED_TICKLESS
   /* Increment the nested watchdog timer count to handle cases where wd_start
    * is called in the watchdog callback functions.
    */
 
   g_wdtimernested++;
-#endif
 
   /* Process the watchdog at the head of the list as well as any
    * other watchdogs that became ready to run at this time
    */
 
-  while (!list_is_empty(&g_wdactivelist))
+  while ((wdog = wd_remove_expired(ticks)) != NULL)
     {
-      wdog = list_first_entry(&g_wdactivelist, struct wdog_s, node);
-
-      /* Check if expected time is expired */
-
-      if (!clock_compare(wdog->expired, ticks))
-        {
-          break;
-        }
-
-      /* Remove the watchdog from the head of the list */
-
-      list_delete(&wdog->node);
-
       /* Indicate that the watchdog is no longer active. */
 
       func = wdog->func;
+      arg  = wdog->arg;
       wdog->func = NULL;
 
       /* Execute the watchdog function */
 
       up_setpicbase(wdog->picbase);
-      CALL_FUNC(func, wdog->arg);
+      spin_unlock_irqrestore(&g_wdlock, lflags);
+      CALL_FUNC(func, arg);
+      lflags = spin_lock_irqsave(&g_wdlock);
     }
 
-#ifdef CONFIG_SCHED_TICKLESS
   /* Decrement the nested watchdog timer count */
 
   g_wdtimernested--;
-#endif
 
+  spin_unlock_irqrestore(&g_wdlock, lflags);
   leave_critical_section(flags);
 }
 
@@ -158,7 +197,8 @@ static inline_function void wd_expiration(clock_t ticks)
  *
  * Description:
  *   Insert the timer into the global list to ensure that
- *   the list is sorted in increasing order of expiration absolute time.
+ *   the list is sorted in increasing order of expiration absolute time,
+ *   or into the timer wheel if CONFIG_WDOG_TIMER_WHEEL is enabled.
  *
  * Input Parameters:
  *   wdog     - Watchdog ID
@@ -178,6 +218,10 @@ static inline_function
 void wd_insert(FAR struct wdog_s *wdog, clock_t expired,
                wdentry_t wdentry, wdparm_t arg)
 {
+#ifdef CONFIG_WDOG_TIMER_WHEEL
+  wdog->expired = expired;
+  wd_wheel_insert(wdog);
+#else
   FAR struct wdog_s *curr;
 
   /* Traverse the watchdog list */
@@ -200,11 +244,12 @@ void wd_insert(FAR struct wdog_s *wdog, clock_t expired,
    */
 
   list_add_before(&curr->node, &wdog->node);
+  wdog->expired = expired;
+#endif
 
   wdog->func = wdentry;
   up_getpicbase(&wdog->picbase);
   wdog->arg = arg;
-  wdog->expired = expired;
 }
 
 /****************************************************************************
@@ -279,31 +324,36 @@ int wd_start_abstick(FAR struct wdog_s *wdog, clock_t ticks,
 
   /* NOTE:  There is a race condition here... the caller may receive
    * the watchdog between the time that wd_start_abstick is called and
-   * the critical section is established.
+   * g_wdlock is taken.
    */
 
-  flags = enter_critical_section();
+  flags = critmon_spin_lock_irqsave(&g_wdlock);
 #ifdef CONFIG_SCHED_TICKLESS
   /* We need to reassess timer if the watchdog list head has changed. */
 
   if (WDOG_ISACTIVE(wdog))
     {
-      reassess |= list_is_head(&g_wdactivelist, &wdog->node);
-      list_delete(&wdog->node);
+      reassess |= wd_is_head(wdog);
+      wd_remove(wdog);
       wdog->func = NULL;
     }
 
   wd_insert(wdog, ticks, wdentry, arg);
 
-  if (!g_wdtimernested &&
-      (reassess || list_is_head(&g_wdactivelist, &wdog->node)))
+  reassess = !g_wdtimernested && (reassess || wd_is_head(wdog));
+  spin_unlock_irqrestore(&g_wdlock, flags);
+
+  if (reassess)
     {
       /* Resume the interval timer that will generate the next
        * interval event. If the timer at the head of the list changed,
-       * then this will pick that new delay.
+       * then this will pick that new delay.  The timer is only
+       * reassessed in the critical section.
        */
 
+      flags = enter_critical_section();
       nxsched_reassess_timer();
+      leave_critical_section(flags);
     }
 #else
   UNUSED(reassess);
@@ -312,13 +362,14 @@ int wd_start_abstick(FAR struct wdog_s *wdog, clock_t ticks,
 
   if (WDOG_ISACTIVE(wdog))
     {
-      list_delete(&wdog->node);
+      wd_remove(wdog);
       wdog->func = NULL;
     }
 
   wd_insert(wdog, ticks, wdentry, arg);
+  spin_unlock_irqrestore(&g_wdlock, flags);
 #endif
-  leave_critical_section(flags);
+
   return OK;
 }
 
@@ -401,7 +452,11 @@ int wd_start(FAR struct wdog_s *wdog, sclock_t delay,
 #ifdef CONFIG_SCHED_TICKLESS
 clock_t wd_timer(clock_t ticks, bool noswitches)
 {
+#ifdef CONFIG_WDOG_TIMER_WHEEL
+  clock_t next;
+#else
   FAR struct wdog_s *wdog;
+#endif
   irqstate_t flags;
   sclock_t ret;
 
@@ -412,13 +467,22 @@ clock_t wd_timer(clock_t ticks, bool noswitches)
       wd_expiration(ticks);
     }
 
-  flags = enter_critical_section();
+  flags = spin_lock_irqsave(&g_wdlock);
 
   /* Return the delay for the next watchdog to expire */
 
+#ifdef CONFIG_WDOG_TIMER_WHEEL
+  if (!wd_wheel_next(&next))
+    {
+      spin_unlock_irqrestore(&g_wdlock, flags);
+      return 0;
+    }
+
+  ret = next - ticks;
+#else
   if (list_is_empty(&g_wdactivelist))
     {
-      leave_critical_section(flags);
+      spin_unlock_irqrestore(&g_wdlock, flags);
       return 0;
     }
 
@@ -428,8 +492,9 @@ clock_t wd_timer(clock_t ticks, bool noswitches)
 
   wdog = list_first_entry(&g_wdactivelist, struct wdog_s, node);
   ret = wdog->expired - ticks;
+#endif
 
-  leave_critical_section(flags);
+  spin_unlock_irqrestore(&g_wdlock, flags);
 
   /* Return the delay for the next watchdog to expire */
 
@@ -0,0 +1,329 @@
+/****************************************************************************
+ * sched/wdog/wd_wheel.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <strings.h>
+
+#include <nuttx/wdog.h>
+
+#include "wdog/wdog.h"
+
+#ifdef CONFIG_WDOG_TIMER_WHEEL
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The wheel has WD_WHEEL_LEVELS levels of WD_WHEEL_SIZE slots.  A slot of
+ * level n spans 2^(n * WD_WHEEL_BITS) ticks, so the wheel covers 2^24
+ * ticks directly.  Watchdogs further away are parked in the last slot of
+ * the top level and re-inserted when that slot is reached.
+ */
+
+#define WD_WHEEL_BITS        6
+#define WD_WHEEL_SIZE        (1 << WD_WHEEL_BITS)
+#define WD_WHEEL_MASK        (WD_WHEEL_SIZE - 1)
+#define WD_WHEEL_LEVELS      4
+
+#define WD_WHEEL_SHIFT(l)    ((l) * WD_WHEEL_BITS)
+#define WD_WHEEL_GRAN(l)     ((clock_t)1 << WD_WHEEL_SHIFT(l))
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* The slot lists are only valid while the corresponding bit of the
+ * occupancy map is set, so that no initialization is needed at boot.
+ */
+
+static struct list_node g_wdwheel[WD_WHEEL_LEVELS][WD_WHEEL_SIZE];
+static uint64_t g_wdwheel_map[WD_WHEEL_LEVELS];
+
+/* The time up to which the wheel has been processed.  Every watchdog in
+ * level 0 expires within WD_WHEEL_SIZE ticks of it, every watchdog in
+ * level n > 0 is in one of the next WD_WHEEL_SIZE - 1 slots of that level.
+ */
+
+static clock_t g_wdwheel_base;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: wd_wheel_dist
+ *
+ * Description:
+ *   Return the distance from the slot 'cur' to the first occupied slot at
+ *   or after it, wrapping around the level.  The map must not be empty.
+ *
+ ****************************************************************************/
+
+static inline_function unsigned int wd_wheel_dist(uint64_t map,
+                                                  unsigned int cur)
+{
+  if (cur != 0)
+    {
+      map = (map >> cur) | (map << (WD_WHEEL_SIZE - cur));
+    }
+
+  return ffsll(map) - 1;
+}
+
+/****************************************************************************
+ * Name: wd_wheel_event
+ *
+ * Description:
+ *   Find the next time the wheel needs attention: either a level 0 slot
+ *   whose watchdogs expire, or a slot of a higher level that must be
+ *   cascaded down.  On a tie the highest level is returned so that all the
+ *   watchdogs expiring at that time are in level 0 before any runs.
+ *
+ ****************************************************************************/
+
+static bool wd_wheel_event(FAR clock_t *event, FAR int *evlevel,
+                           FAR unsigned int *evslot)
+{
+  bool found = false;
+  unsigned int dist;
+  unsigned int cur;
+  clock_t time;
+  int level;
+
+  for (level = 0; level < WD_WHEEL_LEVELS; level++)
+    {
+      if (g_wdwheel_map[level] == 0)
+        {
+          continue;
+        }
+
+      cur  = (g_wdwheel_base >> WD_WHEEL_SHIFT(level)) & WD_WHEEL_MASK;
+      dist = wd_wheel_dist(g_wdwheel_map[level], cur);
+      if (level == 0)
+        {
+          time = g_wdwheel_base + dist;
+        }
+      else if (dist == 0)
+        {
+          time = g_wdwheel_base;
+        }
+      else
+        {
+          time = (g_wdwheel_base & ~(WD_WHEEL_GRAN(level) - 1)) +
+                 ((clock_t)dist << WD_WHEEL_SHIFT(level));
+        }
+
+      if (!found || (sclock_t)(time - *event) <= 0)
+        {
+          *event   = time;
+          *evlevel = level;
+          *evslot  = (cur + dist) & WD_WHEEL_MASK;
+          found    = true;
+        }
+    }
+
+  return found;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: wd_wheel_insert
+ *
+ * Description:
+ *   Add an inactive watchdog to the slot matching its expiration time
+ *   relative to the wheel base.  Overdue watchdogs go to the current slot
+ *   of level 0.  wdog->expired must be set.
+ *
+ * Assumptions:
+ *   Called with g_wdlock held.
+ *
+ ****************************************************************************/
+
+void wd_wheel_insert(FAR struct wdog_s *wdog)
+{
+  FAR struct list_node *head;
+  clock_t delta = wdog->expired - g_wdwheel_base;
+  clock_t ahead;
+  unsigned int slot;
+  int level;
+
+  if ((sclock_t)delta < 0)
+    {
+      delta = 0;
+    }
+
+  /* Find the lowest level whose window contains the expiration time */
+
+  for (level = 0; ; level++)
+    {
+      ahead = ((g_wdwheel_base & (WD_WHEEL_GRAN(level) - 1)) + delta) >>
+              WD_WHEEL_SHIFT(level);
+      if (ahead < WD_WHEEL_SIZE)
+        {
+          break;
+        }
+
+      if (level == WD_WHEEL_LEVELS - 1)
+        {
+          ahead = WD_WHEEL_SIZE - 1;
+          break;
+        }
+    }
+
+  slot = ((g_wdwheel_base >> WD_WHEEL_SHIFT(level)) + ahead) &
+         WD_WHEEL_MASK;
+  head = &g_wdwheel[level][slot];
+
+  if ((g_wdwheel_map[level] & ((uint64_t)1 << slot)) == 0)
+    {
+      list_initialize(head);
+      g_wdwheel_map[level] |= (uint64_t)1 << slot;
+    }
+
+  list_add_tail(head, &wdog->node);
+}
+
+/****************************************************************************
+ * Name: wd_wheel_remove
+ *
+ * Description:
+ *   Remove an active watchdog from the timer wheel.
+ *
+ * Assumptions:
+ *   Called with g_wdlock held.
+ *
+ ****************************************************************************/
+
+void wd_wheel_remove(FAR struct wdog_s *wdog)
+{
+  FAR struct list_node *prev = wdog->node.prev;
+  FAR struct list_node *next = wdog->node.next;
+
+  list_delete(&wdog->node);
+
+  /* If the neighbours are the same node, it is the slot head and the slot
+   * is now empty.
+   */
+
+  if (prev == next)
+    {
+      size_t index = prev - &g_wdwheel[0][0];
+
+      g_wdwheel_map[index / WD_WHEEL_SIZE] &=
+        ~((uint64_t)1 << (index % WD_WHEEL_SIZE));
+    }
+}
+
+/****************************************************************************
+ * Name: wd_wheel_expire
+ *
+ * Description:
+ *   Advance the timer wheel to 'ticks' and remove the next watchdog that
+ *   has expired by then.  Watchdogs are returned in expiration order.
+ *
+ * Returned Value:
+ *   The expired watchdog, or NULL if no more watchdog has expired.
+ *
+ * Assumptions:
+ *   Called with g_wdlock held.
+ *
+ ****************************************************************************/
+
+FAR struct wdog_s *wd_wheel_expire(clock_t ticks)
+{
+  FAR struct list_node *head;
+  FAR struct wdog_s *wdog;
+  unsigned int slot;
+  clock_t event;
+  int level;
+
+  while (wd_wheel_event(&event, &level, &slot) &&
+         clock_compare(event, ticks))
+    {
+      g_wdwheel_base = event;
+      head = &g_wdwheel[level][slot];
+
+      if (level == 0)
+        {
+          wdog = list_first_entry(head, struct wdog_s, node);
+          wd_wheel_remove(wdog);
+          return wdog;
+        }
+
+      /* Cascade the slot down.  None of its watchdogs can land in the same
+       * slot again, so the slot is released first.
+       */
+
+      g_wdwheel_map[level] &= ~((uint64_t)1 << slot);
+      while (!list_is_empty(head))
+        {
+          wdog = list_first_entry(head, struct wdog_s, node);
+          list_delete(&wdog->node);
+          wd_wheel_insert(wdog);
+        }
+    }
+
+  /* Nothing needs attention up to 'ticks', skip the wheel forward */
+
+  if (clock_compare(g_wdwheel_base, ticks))
+    {
+      g_wdwheel_base = ticks;
+    }
+
+  return NULL;
+}
+
+/****************************************************************************
+ * Name: wd_wheel_next
+ *
+ * Description:
+ *   Return the next time the timer wheel must be processed.  This is the
+ *   earliest expiration time, or the time a higher level slot must be
+ *   cascaded if that comes first.
+ *
+ * Returned Value:
+ *   False if the timer wheel is empty.
+ *
+ * Assumptions:
+ *   Called with g_wdlock held.
+ *
+ ****************************************************************************/
+
+bool wd_wheel_next(FAR clock_t *next)
+{
+  unsigned int slot;
+  int level;
+
+  return wd_wheel_event(next, &level, &slot);
+}
+
+#endif /* CONFIG_WDOG_TIMER_WHEEL */
@@ -37,6 +37,7 @@
 #include <nuttx/queue.h>
 #include <nuttx/wdog.h>
 #include <nuttx/list.h>
+#include <nuttx/spinlock.h>
 
 /****************************************************************************
  * Pre-processor Definitions
@@ -58,12 +59,27 @@ extern "C"
 #define EXTERN extern
 #endif
 
+#ifndef CONFIG_WDOG_TIMER_WHEEL
 /* The g_wdactivelist data structure is a singly linked list ordered by
  * watchdog expiration time. When watchdog timers expire,the functions on
  * this linked list are removed and the function is called.
  */
 
 extern struct list_node g_wdactivelist;
+#endif
+
+/* g_wdlock protects the active watchdogs.  The watchdog callbacks still run
+ * in the critical section, so g_wdlock is always taken after it, and never
+ * held while a callback runs.
+ */
+
+extern spinlock_t g_wdlock;
+
+/* The number of watchdog expirations in progress.  Watchdogs started from
+ * a callback do not reassess the timer, wd_timer() does it on return.
+ */
+
+extern unsigned int g_wdtimernested;
 
 /****************************************************************************
  * Public Function Prototypes
@@ -123,6 +139,85 @@ void wd_timer(clock_t ticks);
 struct tcb_s;
 void wd_recover(FAR struct tcb_s *tcb);
 
+#ifdef CONFIG_WDOG_TIMER_WHEEL
+
+/****************************************************************************
+ * Name: wd_wheel_insert
+ *
+ * Description:
+ *   Add an inactive watchdog to the timer wheel.  wdog->expired must be
+ *   set.
+ *
+ * Assumptions:
+ *   Called with g_wdlock held.
+ *
+ ****************************************************************************/
+
+void wd_wheel_insert(FAR struct wdog_s *wdog);
+
+/****************************************************************************
+ * Name: wd_wheel_remove
+ *
+ * Description:
+ *   Remove an active watchdog from the timer wheel.
+ *
+ * Assumptions:
+ *   Called with g_wdlock held.
+ *
+ ****************************************************************************/
+
+void wd_wheel_remove(FAR struct wdog_s *wdog);
+
+/****************************************************************************
+ * Name: wd_wheel_expire
+ *
+ * Description:
+ *   Advance the timer wheel to 'ticks' and remove the next watchdog that
+ *   has expired by then, or return NULL if there is none.
+ *
+ * Assumptions:
+ *   Called with g_wdlock held.
+ *
+ ****************************************************************************/
+
+FAR struct wdog_s *wd_wheel_expire(clock_t ticks);
+
+/****************************************************************************
+ * Name: wd_wheel_next
+ *
+ * Description:
+ *   Return the next time the timer wheel must be processed, or false if
+ *   the timer wheel is empty.
+ *
+ * Assumptions:
+ *   Called with g_wdlock held.
+ *
+ ****************************************************************************/
+
+bool wd_wheel_next(FAR clock_t *next);
+
+#endif /* CONFIG_WDOG_TIMER_WHEEL */
+
+/****************************************************************************
+ * Name: wd_is_head
+ *
+ * Description:
+ *   Return true if the active watchdog is the next one to expire, so that
+ *   the interval timer must be reassessed when it is added or removed.
+ *
+ ****************************************************************************/
+
+static inline_function bool wd_is_head(FAR struct wdog_s *wdog)
+{
+#ifdef CONFIG_WDOG_TIMER_WHEEL
+  clock_t next;
+
+  return wd_wheel_next(&next) && clock_compare(wdog->expired, next);
+#else
+  return list_is_head(&g_wdactivelist, &wdog->node);
+#endif
+}
+
 #undef EXTERN
 #ifdef __cplusplus
 }
@@ -71,7 +71,11 @@ static int work_qcancel(FAR struct kwork_wqueue_s *wqueue, bool sync,
         }
       else
         {
+#ifdef CONFIG_SCHED_WORKQUEUE_PERCPU
+          dq_rem((FAR dq_entry_t *)work, &wqueue->cpuq[work->u.s.cpu].q);
+#else
           dq_rem((FAR dq_entry_t *)work, &wqueue->q);
+#endif
         }
 
       work->worker = NULL;
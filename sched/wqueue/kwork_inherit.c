@@ -224,7 +224,7 @@ void lpwork_boostpriority(uint8_t reqprio)
 
   /* Adjust the priority of every worker thread */
 
-  for (wndx = 0; wndx < CONFIG_SCHED_LPNTHREADS; wndx++)
+  for (wndx = 0; wndx < g_lpwork.nthreads; wndx++)
     {
       lpwork_boostworker(g_lpwork.worker[wndx].pid, reqprio);
     }
@@ -268,7 +268,7 @@ void lpwork_restorepriority(uint8_t reqprio)
 
   /* Adjust the priority of every worker thread */
 
-  for (wndx = 0; wndx < CONFIG_SCHED_LPNTHREADS; wndx++)
+  for (wndx = 0; wndx < g_lpwork.nthreads; wndx++)
     {
       lpwork_restoreworker(g_lpwork.worker[wndx].pid, reqprio);
     }
@@ -34,6 +34,7 @@
 #include <nuttx/arch.h>
 #include <nuttx/clock.h>
 #include <nuttx/queue.h>
+#include <nuttx/sched.h>
 #include <nuttx/wqueue.h>
 
 #include "wqueue/wqueue.h"
@@ -44,7 +45,10 @@
  * Pre-processor Definitions
  ****************************************************************************/
 
-#define queue_work(wqueue, work) \
+#ifdef CONFIG_SCHED_WORKQUEUE_PERCPU
+#  define queue_work(wqueue, work) work_queue_cpu(wqueue, work, this_cpu())
+#else
+#  define queue_work(wqueue, work) \
   do \
     { \
       int sem_count; \
@@ -56,11 +60,49 @@
         } \
     } \
   while (0)
+#endif
 
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
 
+#ifdef CONFIG_SCHED_WORKQUEUE_PERCPU
+/****************************************************************************
+ * Name: work_queue_cpu
+ *
+ * Description:
+ *   Queue the work on the queue of a CPU and wake up one of its workers.
+ *   If they are all busy, wake up an idle worker of another CPU instead,
+ *   which will steal the work.
+ *
+ * Assumptions:
+ *   Called in a critical section.
+ *
+ ****************************************************************************/
+
+static void work_queue_cpu(FAR struct kwork_wqueue_s *wqueue,
+                           FAR struct work_s *work, int cpu)
+{
+  FAR sem_t *sem;
+  int sem_count;
+  int i;
+
+  work->u.s.cpu = cpu;
+  dq_addlast((FAR dq_entry_t *)work, &wqueue->cpuq[cpu].q);
+
+  for (i = 0; i < CONFIG_SMP_NCPUS; i++)
+    {
+      sem = &wqueue->cpuq[(cpu + i) % CONFIG_SMP_NCPUS].sem;
+      nxsem_get_value(sem, &sem_count);
+      if (sem_count < 0) /* There are threads waiting for sem. */
+        {
+          nxsem_post(sem);
+          break;
+        }
+    }
+}
+#endif
+
 /****************************************************************************
  * Name: work_timer_expiry
  ****************************************************************************/
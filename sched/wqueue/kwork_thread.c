@@ -83,10 +83,16 @@
 
 struct hp_wqueue_s g_hpwork =
 {
+#ifdef CONFIG_SCHED_WORKQUEUE_PERCPU
+  {
+    {{NULL, NULL}, SEM_INITIALIZER(0)}
+  },
+#else
   {NULL, NULL},
   SEM_INITIALIZER(0),
+#endif
   SEM_INITIALIZER(0),
-  CONFIG_SCHED_HPNTHREADS,
+  WORK_NWORKERS(CONFIG_SCHED_HPNTHREADS),
 };
 
 #endif /* CONFIG_SCHED_HPWORK */
@@ -96,10 +102,16 @@ struct hp_wqueue_s g_hpwork =
 
 struct lp_wqueue_s g_lpwork =
 {
+#ifdef CONFIG_SCHED_WORKQUEUE_PERCPU
+  {
+    {{NULL, NULL}, SEM_INITIALIZER(0)}
+  },
+#else
   {NULL, NULL},
   SEM_INITIALIZER(0),
+#endif
   SEM_INITIALIZER(0),
-  CONFIG_SCHED_LPNTHREADS,
+  WORK_NWORKERS(CONFIG_SCHED_LPNTHREADS),
 };
 
 #endif /* CONFIG_SCHED_LPWORK */
@@ -108,6 +120,43 @@ struct lp_wqueue_s g_lpwork =
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: work_dequeue
+ *
+ * Description:
+ *   Remove the next work to run from the queue.  Per-CPU workers look at
+ *   the queue of their CPU first and then steal the oldest work of the
+ *   other CPUs, nearest first.
+ *
+ * Assumptions:
+ *   Called in a critical section.
+ *
+ ****************************************************************************/
+
+static FAR struct work_s *work_dequeue(FAR struct kwork_wqueue_s *wqueue,
+                                       FAR struct kworker_s *kworker)
+{
+#ifdef CONFIG_SCHED_WORKQUEUE_PERCPU
+  FAR struct work_s *work;
+  int i;
+
+  for (i = 0; i < CONFIG_SMP_NCPUS; i++)
+    {
+      int cpu = (kworker->cpu + i) % CONFIG_SMP_NCPUS;
+
+      work = (FAR struct work_s *)dq_remfirst(&wqueue->cpuq[cpu].q);
+      if (work != NULL)
+        {
+          return work;
+        }
+    }
+
+  return NULL;
+#else
+  return (FAR struct work_s *)dq_remfirst(&wqueue->q);
+#endif
+}
+
 /****************************************************************************
  * Name: work_thread
  *
@@ -160,7 +209,7 @@ static int work_thread(int argc, FAR char *argv[])
 
       /* Remove the ready-to-execute work from the list */
 
-      while ((work = (FAR struct work_s *)dq_remfirst(&wqueue->q)) != NULL)
+      while ((work = work_dequeue(wqueue, kworker)) != NULL)
         {
           if (work->worker == NULL)
             {
@@ -211,7 +260,7 @@ static int work_thread(int argc, FAR char *argv[])
        * posted.
        */
 
-      nxsem_wait_uninterruptible(&wqueue->sem);
+      nxsem_wait_uninterruptible(work_wqueue_sem(wqueue, kworker));
     }
 
   leave_critical_section(flags);
@@ -247,6 +296,10 @@ static int work_thread_create(FAR const char *name, int priority,
   char arg1[32];
   int wndx;
   int pid;
+#ifdef CONFIG_SCHED_WORKQUEUE_PERCPU
+  cpu_set_t cpuset;
+  int cpu;
+#endif
 
   /* Don't permit any of the threads to run until we have fully initialized
    * all of them.
@@ -254,9 +307,19 @@ static int work_thread_create(FAR const char *name, int priority,
 
   sched_lock();
 
+#ifdef CONFIG_SCHED_WORKQUEUE_PERCPU
+  for (cpu = 0; cpu < CONFIG_SMP_NCPUS; cpu++)
+    {
+      nxsem_init(&wqueue->cpuq[cpu].sem, 0, 0);
+    }
+#endif
+
   for (wndx = 0; wndx < wqueue->nthreads; wndx++)
     {
       nxsem_init(&wqueue->worker[wndx].wait, 0, 0);
+#ifdef CONFIG_SCHED_WORKQUEUE_PERCPU
+      wqueue->worker[wndx].cpu = wndx % CONFIG_SMP_NCPUS;
+#endif
 
       snprintf(arg0, sizeof(arg0), "%p", wqueue);
       snprintf(arg1, sizeof(arg1), "%p", &wqueue->worker[wndx]);
@@ -276,6 +339,14 @@ static int work_thread_create(FAR const char *name, int priority,
         }
 
       wqueue->worker[wndx].pid = pid;
+
+#ifdef CONFIG_SCHED_WORKQUEUE_PERCPU
+      /* Bind the worker to its CPU */
+
+      CPU_ZERO(&cpuset);
+      CPU_SET(wqueue->worker[wndx].cpu, &cpuset);
+      nxsched_set_affinity(pid, sizeof(cpu_set_t), &cpuset);
+#endif
     }
 
   sched_unlock();
@@ -293,7 +364,8 @@ static int work_thread_create(FAR const char *name, int priority,
  *   Create a new work queue. The work queue is identified by its work
  *   queue ID, which is used to queue works to the work queue and to
  *   perform other operations on the work queue.
- *   This function will create a work thread pool with nthreads threads.
+ *   This function will create a work thread pool with nthreads threads,
+ *   or nthreads threads per CPU with CONFIG_SCHED_WORKQUEUE_PERCPU.
  *   The work queue ID is returned on success.
  *
  * Input Parameters:
@@ -321,6 +393,7 @@ FAR struct kwork_wqueue_s *work_queue_create(FAR const char *name,
 
   /* Allocate a new work queue */
 
+  nthreads = WORK_NWORKERS(nthreads);
   wqueue = kmm_zalloc(sizeof(struct kwork_wqueue_s) +
                       nthreads * sizeof(struct kworker_s));
   if (wqueue == NULL)
@@ -328,10 +401,14 @@ FAR struct kwork_wqueue_s *work_queue_create(FAR const char *name,
       return NULL;
     }
 
-  /* Initialize the work queue structure */
+  /* Initialize the work queue structure.  The semaphores of the per-CPU
+   * queues are initialized with the threads.
+   */
 
+#ifndef CONFIG_SCHED_WORKQUEUE_PERCPU
   dq_init(&wqueue->q);
   nxsem_init(&wqueue->sem, 0, 0);
+#endif
   nxsem_init(&wqueue->exsem, 0, 0);
   wqueue->nthreads = nthreads;
 
@@ -380,7 +457,7 @@ int work_queue_free(FAR struct kwork_wqueue_s *wqueue)
 
   for (wndx = 0; wndx < wqueue->nthreads; wndx++)
     {
-      nxsem_post(&wqueue->sem);
+      nxsem_post(work_wqueue_sem(wqueue, &wqueue->worker[wndx]));
     }
 
   for (wndx = 0; wndx < wqueue->nthreads; wndx++)
@@ -388,7 +465,14 @@ int work_queue_free(FAR struct kwork_wqueue_s *wqueue)
       nxsem_wait_uninterruptible(&wqueue->exsem);
     }
 
+#ifdef CONFIG_SCHED_WORKQUEUE_PERCPU
+  for (wndx = 0; wndx < CONFIG_SMP_NCPUS; wndx++)
+    {
+      nxsem_destroy(&wqueue->cpuq[wndx].sem);
+    }
+#else
   nxsem_destroy(&wqueue->sem);
+#endif
   nxsem_destroy(&wqueue->exsem);
   kmm_free(wqueue);
 
@@ -47,6 +47,14 @@
 #define HPWORKNAME "hpwork"
 #define LPWORKNAME "lpwork"
 
+/* With per-CPU work queues, each CPU has its own set of worker threads */
+
+#ifdef CONFIG_SCHED_WORKQUEUE_PERCPU
+#  define WORK_NWORKERS(n) ((n) * CONFIG_SMP_NCPUS)
+#else
+#  define WORK_NWORKERS(n) (n)
+#endif
+
 /****************************************************************************
  * Public Type Definitions
  ****************************************************************************/
@@ -58,14 +66,34 @@ struct kworker_s
   pid_t             pid;       /* The task ID of the worker thread */
   FAR struct work_s *work;     /* The work structure */
   sem_t             wait;      /* Sync waiting for worker done */
+#ifdef CONFIG_SCHED_WORKQUEUE_PERCPU
+  uint8_t           cpu;       /* The CPU the worker thread is bound to */
+#endif
 };
 
+#ifdef CONFIG_SCHED_WORKQUEUE_PERCPU
+/* The work queued on one CPU.  Work is queued on the CPU that submits it
+ * and normally run by the workers bound to that CPU; idle workers of the
+ * other CPUs steal it when these are busy.
+ */
+
+struct kwork_cpuq_s
+{
+  struct dq_queue_s q;         /* The queue of pending work */
+  sem_t             sem;       /* The counting semaphore of the workers */
+};
+#endif
+
 /* This structure defines the state of one kernel-mode work queue */
 
 struct kwork_wqueue_s
 {
+#ifdef CONFIG_SCHED_WORKQUEUE_PERCPU
+  struct kwork_cpuq_s cpuq[CONFIG_SMP_NCPUS]; /* The queue of each CPU */
+#else
   struct dq_queue_s q;         /* The queue of pending work */
   sem_t             sem;       /* The counting semaphore of the wqueue */
+#endif
   sem_t             exsem;     /* Sync waiting for thread exit */
   uint8_t           nthreads;  /* Number of worker threads */
   bool              exit;      /* A flag to request the thread to exit */
@@ -79,15 +107,19 @@ struct kwork_wqueue_s
 #ifdef CONFIG_SCHED_HPWORK
 struct hp_wqueue_s
 {
+#ifdef CONFIG_SCHED_WORKQUEUE_PERCPU
+  struct kwork_cpuq_s cpuq[CONFIG_SMP_NCPUS]; /* The queue of each CPU */
+#else
   struct dq_queue_s q;         /* The queue of pending work */
   sem_t             sem;       /* The counting semaphore of the wqueue */
+#endif
   sem_t             exsem;     /* Sync waiting for thread exit */
   uint8_t           nthreads;  /* Number of worker threads */
   bool              exit;      /* A flag to request the thread to exit */
 
   /* Describes each thread in the high priority queue's thread pool */
 
-  struct kworker_s  worker[CONFIG_SCHED_HPNTHREADS];
+  struct kworker_s  worker[WORK_NWORKERS(CONFIG_SCHED_HPNTHREADS)];
 };
 #endif
 
@@ -98,15 +130,19 @@ struct hp_wqueue_s
 #ifdef CONFIG_SCHED_LPWORK
 struct lp_wqueue_s
 {
+#ifdef CONFIG_SCHED_WORKQUEUE_PERCPU
+  struct kwork_cpuq_s cpuq[CONFIG_SMP_NCPUS]; /* The queue of each CPU */
+#else
   struct dq_queue_s q;         /* The queue of pending work */
   sem_t             sem;       /* The counting semaphore of the wqueue */
+#endif
   sem_t             exsem;     /* Sync waiting for thread exit */
   uint8_t           nthreads;  /* Number of worker threads */
   bool              exit;      /* A flag to request the thread to exit */
 
   /* Describes each thread in the low priority queue's thread pool */
 
-  struct kworker_s  worker[CONFIG_SCHED_LPNTHREADS];
+  struct kworker_s  worker[WORK_NWORKERS(CONFIG_SCHED_LPNTHREADS)];
 };
 #endif
 
@@ -151,6 +187,21 @@ static inline_function FAR struct kwork_wqueue_s *work_qid2wq(int qid)
     }
 }
 
+/****************************************************************************
+ * Name: work_wqueue_sem
+ *
+ * Description:
+ *   Return the semaphore the worker waits on for work.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_WORKQUEUE_PERCPU
+#  define work_wqueue_sem(wqueue, kworker) \
+     (&(wqueue)->cpuq[(kworker)->cpu].sem)
+#else
+#  define work_wqueue_sem(wqueue, kworker) (&(wqueue)->sem)
+#endif
+
 /****************************************************************************
  * Name: work_start_highpri
  *